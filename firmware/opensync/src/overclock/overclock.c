@@ -4,17 +4,75 @@
 
 #include "overclock.h"
 
+#define OVERCLOCK_PROFILES_MAX 3
 
-// TODO: Add compile-time ocnventions for clock speed? (e.g., 4 ns .. 2.5 ns resolution)
-// Set the system clock speed
-void overclock_system_set()
+static const struct overclock_profile OVERCLOCK_PROFILES[OVERCLOCK_PROFILES_MAX] = {
+    {.mhz = 200, .vreg_voltage = VREG_VOLTAGE_1_05, .cycle_nanos_num = 5,  .cycle_nanos_den = 1},
+    {.mhz = 250, .vreg_voltage = VREG_VOLTAGE_1_05, .cycle_nanos_num = 4,  .cycle_nanos_den = 1},
+    {.mhz = 300, .vreg_voltage = VREG_VOLTAGE_1_20, .cycle_nanos_num = 10, .cycle_nanos_den = 3}
+};
+
+// Profile the system clock runs at, set once at boot
+static const struct overclock_profile* overclock_profile = NULL;
+
+
+// Find the clock profile of a frequency in MHz, NULL if there is none
+static const struct overclock_profile* overclock_profile_find(
+    uint32_t mhz
+) {
+    for (uint32_t i = 0; i < OVERCLOCK_PROFILES_MAX; i++)
+    {
+        if (OVERCLOCK_PROFILES[i].mhz == mhz)
+        {
+            return &OVERCLOCK_PROFILES[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+// Make sure there is a clock profile for a frequency in MHz
+bool overclock_profile_validate(
+    uint32_t mhz
+) {
+    return overclock_profile_find(mhz) != NULL;
+}
+
+
+// Get the profile the system clock runs at, the build time profile until the
+// clock is set
+const struct overclock_profile* overclock_profile_get()
 {
+    if (overclock_profile == NULL)
+    {
+        return overclock_profile_find(SYSTEM_CLOCK_MHZ);
+    }
+
+    return overclock_profile;
+}
+
+
+// Set the system clock speed of a clock profile. Frequencies without a
+// profile fall back to the build time profile.
+void overclock_system_set(
+    uint32_t mhz
+) {
+    const struct overclock_profile* profile = overclock_profile_find(mhz);
+
+    if (profile == NULL)
+    {
+        profile = overclock_profile_find(SYSTEM_CLOCK_MHZ);
+    }
+
     // Increase voltage to support overclock
-    vreg_set_voltage(VREG_VOLTAGE_1_05);
+    vreg_set_voltage(profile -> vreg_voltage);
 
     // Delay 100 millizeconds to make sure voltage regulator is stable
     sleep_ms(100);
 
-    // Set PLL frequency to 250 MHz
-    set_sys_clock_hz(250 * MHZ, true);
-}
\ No newline at end of file
+    // Set PLL frequency to the profile frequency
+    set_sys_clock_hz(profile -> mhz * MHZ, true);
+
+    overclock_profile = profile;
+}
@@ -1,3 +1,42 @@
 #pragma once
 
-void overclock_system_set();
\ No newline at end of file
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// System clock profiles. The profile is picked at boot from the persisted
+// setting (SYSTem:CONFig:CLOCk), SYSTEM_CLOCK_MHZ (see
+// OPENSYNC_SYSTEM_CLOCK_MHZ in CMakeLists.txt) is the profile used when none
+// is stored. Every conversion between nanoseconds and state machine cycles is
+// derived from the cycle period of the profile, given as a fraction so
+// 300 MHz (10/3 ns) stays exact.
+//
+//  MHz | core voltage      | cycle period (ns)
+//  200 | VREG_VOLTAGE_1_05 | 5
+//  250 | VREG_VOLTAGE_1_05 | 4
+//  300 | VREG_VOLTAGE_1_20 | 10 / 3
+#ifndef SYSTEM_CLOCK_MHZ
+#define SYSTEM_CLOCK_MHZ 250
+#endif
+
+#if (SYSTEM_CLOCK_MHZ != 200) && (SYSTEM_CLOCK_MHZ != 250) && (SYSTEM_CLOCK_MHZ != 300)
+#error "Unsupported SYSTEM_CLOCK_MHZ, use 200, 250 or 300"
+#endif
+
+struct overclock_profile
+{
+    uint32_t mhz;
+    uint32_t vreg_voltage;
+    uint32_t cycle_nanos_num; // cycle period in ns is num / den
+    uint32_t cycle_nanos_den;
+};
+
+bool overclock_profile_validate(
+    uint32_t mhz
+);
+
+const struct overclock_profile* overclock_profile_get();
+
+void overclock_system_set(
+    uint32_t mhz
+);
@@ -12,11 +12,76 @@
 #include "sequencer_pio_clock_triggered_falling.pio.h"
 #include "sequencer_pio_clock_gated_high.pio.h"
 #include "sequencer_pio_clock_gated_low.pio.h"
+#include "sequencer_pio_clock_triggered_mask_rising.pio.h"
+#include "sequencer_pio_clock_triggered_mask_falling.pio.h"
+#include "sequencer_pio_clock_triggered_or_rising.pio.h"
+#include "sequencer_pio_clock_triggered_or_falling.pio.h"
+#include "sequencer_pio_clock_triggered_and_rising.pio.h"
+#include "sequencer_pio_clock_triggered_and_falling.pio.h"
+#include "sequencer_pio_clock_triggered_arm_rising.pio.h"
+#include "sequencer_pio_clock_triggered_arm_falling.pio.h"
 
 
 // Sequence stuff
 uint32_t CLOCK_INSTRUCTIONS_DEFAULT[CLOCK_INSTRUCTIONS_MAX] = {0};
 uint32_t CLOCK_TRIGGERS_DEFAULT[CLOCK_TRIGGERS_MAX] = {0};
+uint32_t CLOCK_TRIGGER_MASK_DEFAULT[CLOCK_TRIGGER_MASK_WORDS] = {1}; // Accept every trigger
+
+
+// Clock programs loaded into PIO memory. Clocks running the same program share
+// a single copy, even if their clock types differ, so there are at most as
+// many loaded programs as clocks.
+struct clock_program
+{
+    const pio_program_t* program; // NULL if the entry is free
+    uint offset;
+    uint32_t users;
+};
+
+static struct clock_program clock_programs[CLOCKS_MAX] = {0};
+
+// Mask programs raise IRQ flag 4 + sm for every filtered trigger edge
+static const uint CLOCK_TRIGGER_EDGE_IRQ_BASE = 4;
+
+
+// Helper function to get the internal edge triggered clock mode of a trigger
+// input set. Combined trigger logic needs two trigger inputs.
+bool clock_sequencer_map_logic(
+    struct clock_config* config,
+    uint32_t* internal_mode
+) {
+    const bool rising = (config -> trigger_edge == CLOCK_TRIG_EDGE_POSITIVE);
+
+    if ((config -> trigger_logic != CLOCK_TRIG_LOGIC_SINGLE) &&
+        (config -> trigger_inputs < CLOCK_TRIGGER_INPUTS_MAX))
+    {
+        return false;
+    }
+
+    switch (config -> trigger_logic)
+    {
+        case CLOCK_TRIG_LOGIC_SINGLE:
+            *internal_mode = rising ? CLOCK_TRIGGERED_RISING : CLOCK_TRIGGERED_FALLING;
+            break;
+
+        case CLOCK_TRIG_LOGIC_OR:
+            *internal_mode = rising ? CLOCK_TRIGGERED_OR_RISING : CLOCK_TRIGGERED_OR_FALLING;
+            break;
+
+        case CLOCK_TRIG_LOGIC_AND:
+            *internal_mode = rising ? CLOCK_TRIGGERED_AND_RISING : CLOCK_TRIGGERED_AND_FALLING;
+            break;
+
+        case CLOCK_TRIG_LOGIC_ARM:
+            *internal_mode = rising ? CLOCK_TRIGGERED_ARM_RISING : CLOCK_TRIGGERED_ARM_FALLING;
+            break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
 
 
 // Helpfer function to get the correct internal clock mode
@@ -72,14 +137,21 @@ bool clock_sequencer_map_mode(
             return false;
         }
         else if (trigger_mode == CLOCK_TRIG_SOURCE_EDGE)
+        {
+            return clock_sequencer_map_logic(
+                config,
+                internal_mode
+            );
+        }
+        else if (trigger_mode == CLOCK_TRIG_SOURCE_MASK)
         {
             if (trigger_edge == CLOCK_TRIG_EDGE_POSITIVE)
             {
-                *internal_mode = (uint32_t) CLOCK_TRIGGERED_RISING;
+                *internal_mode = (uint32_t) CLOCK_TRIGGERED_MASK_RISING;
             }
             else
             {
-                *internal_mode = (uint32_t) CLOCK_TRIGGERED_FALLING;
+                *internal_mode = (uint32_t) CLOCK_TRIGGERED_MASK_FALLING;
             }
         }
         else
@@ -96,97 +168,207 @@ bool clock_sequencer_map_mode(
 }
 
 
-uint sequencer_program_clock_add(
-    PIO pio_clock,
+const pio_program_t* sequencer_program_clock_get(
     uint32_t clock_type
 ) {
     switch (clock_type)
     {
         case CLOCK_FREERUN:
-            return pio_add_program(
-                pio_clock,
-                &sequencer_pio_clock_freerun_program
-            );
+            return &sequencer_pio_clock_freerun_program;
         case CLOCK_TRIGGERED:
         case CLOCK_TRIGGERED_RISING:
-            return pio_add_program(
-                pio_clock,
-                &sequencer_pio_clock_triggered_rising_program
-            );
+            return &sequencer_pio_clock_triggered_rising_program;
         case CLOCK_TRIGGERED_FALLING:
-            return pio_add_program(
-                pio_clock,
-                &sequencer_pio_clock_triggered_falling_program
-            );
+            return &sequencer_pio_clock_triggered_falling_program;
         case CLOCK_TRIGGERED_HIGH:
-            return pio_add_program(
-                pio_clock,
-                &sequencer_pio_clock_gated_high_program
-            );
+            return &sequencer_pio_clock_gated_high_program;
         case CLOCK_TRIGGERED_LOW:
-            return pio_add_program(
-                pio_clock,
-                &sequencer_pio_clock_gated_low_program
-            );
+            return &sequencer_pio_clock_gated_low_program;
+        case CLOCK_TRIGGERED_MASK_RISING:
+            return &sequencer_pio_clock_triggered_mask_rising_program;
+        case CLOCK_TRIGGERED_MASK_FALLING:
+            return &sequencer_pio_clock_triggered_mask_falling_program;
+        case CLOCK_TRIGGERED_OR_RISING:
+            return &sequencer_pio_clock_triggered_or_rising_program;
+        case CLOCK_TRIGGERED_OR_FALLING:
+            return &sequencer_pio_clock_triggered_or_falling_program;
+        case CLOCK_TRIGGERED_AND_RISING:
+            return &sequencer_pio_clock_triggered_and_rising_program;
+        case CLOCK_TRIGGERED_AND_FALLING:
+            return &sequencer_pio_clock_triggered_and_falling_program;
+        case CLOCK_TRIGGERED_ARM_RISING:
+            return &sequencer_pio_clock_triggered_arm_rising_program;
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            return &sequencer_pio_clock_triggered_arm_falling_program;
         default:
             // We should never get to this point.
             break;
     }
-    return 0;
+    return NULL;
 }
 
 
-void sequencer_program_clock_remove(
-    PIO pio_clock, 
-    uint offset,
+// Find the loaded copy of a clock program, NULL if it isn't loaded
+static struct clock_program* sequencer_program_clock_find(
+    const pio_program_t* program
+) {
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        if ((clock_programs[i].users > 0) &&
+            (clock_programs[i].program == program))
+        {
+            return &clock_programs[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+uint sequencer_program_clock_add(
+    PIO pio_clock,
     uint32_t clock_type
 ) {
-    switch (clock_type)
+    const pio_program_t* program = sequencer_program_clock_get(clock_type);
+    struct clock_program* loaded = sequencer_program_clock_find(program);
+
+    // Reuse the program if another clock already loaded it
+    for (uint32_t i = 0; (loaded == NULL) && (i < CLOCKS_MAX); i++)
     {
-        case CLOCK_FREERUN:
-            pio_remove_program(
+        if (clock_programs[i].users == 0)
+        {
+            loaded = &clock_programs[i];
+            loaded -> program = program;
+            loaded -> offset = pio_add_program(
                 pio_clock,
-                &sequencer_pio_clock_freerun_program,
-                offset
+                program
             );
-            break;
+        }
+    }
 
-        case CLOCK_TRIGGERED:
-        case CLOCK_TRIGGERED_RISING:
-            pio_remove_program(
-                pio_clock,
-                &sequencer_pio_clock_triggered_rising_program,
-                offset
-            );
-            break;
+    loaded -> users++;
 
-        case CLOCK_TRIGGERED_FALLING:
-            pio_remove_program(
-                pio_clock,
-                &sequencer_pio_clock_triggered_falling_program,
-                offset
-            );
-            break;
+    return loaded -> offset;
+}
 
-        case CLOCK_TRIGGERED_HIGH:
-            pio_remove_program(
-                pio_clock,
-                &sequencer_pio_clock_gated_high_program,
-                offset
-            );
-            break;
 
-        case CLOCK_TRIGGERED_LOW:
-            pio_remove_program(
-                pio_clock,
-                &sequencer_pio_clock_gated_low_program,
-                offset
-            );
-            break;
+// Check if a clock program can be loaded. A program that is already loaded is
+// shared, so it always fits.
+bool sequencer_program_clock_fits(
+    PIO pio_clock,
+    uint32_t clock_type
+) {
+    const pio_program_t* program = sequencer_program_clock_get(clock_type);
+
+    if (sequencer_program_clock_find(program) != NULL)
+    {
+        return true;
+    }
+
+    return pio_can_add_program(
+        pio_clock,
+        program
+    );
+}
+
+
+// Get the GPIO mask of the trigger inputs the program of a clock reads, 0 for
+// clock modes without trigger inputs or without a program
+uint32_t sequencer_clock_trigger_pins_get(
+    struct clock_config* config
+) {
+    uint32_t clock_type = 0;
+
+    if (!clock_sequencer_map_mode(config, &clock_type))
+    {
+        return 0;
+    }
+
+    switch (clock_type)
+    {
+        case CLOCK_FREERUN:
+            return 0;
+
+        case CLOCK_TRIGGERED_OR_RISING:
+        case CLOCK_TRIGGERED_OR_FALLING:
+        case CLOCK_TRIGGERED_AND_RISING:
+        case CLOCK_TRIGGERED_AND_FALLING:
+        case CLOCK_TRIGGERED_ARM_RISING:
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            return (1u << config -> trigger_pin) | (1u << config -> trigger_pin_aux);
 
         default:
-            // We should never get to this point.
-            break;
+            return 1u << config -> trigger_pin;
+    }
+}
+
+
+// Check that the programs of all active clocks fit into the PIO instruction
+// memory together, counting every shared program once. Clocks without a
+// program are left to the clock mode check.
+bool sequencer_clock_programs_validate(
+    struct clock_config* config_array
+) {
+    const pio_program_t* programs[CLOCKS_MAX] = {NULL};
+    uint32_t program_count = 0;
+    uint32_t length = 0;
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        uint32_t clock_type = 0;
+
+        if ((config_array[i].active == false) ||
+            !clock_sequencer_map_mode(&config_array[i], &clock_type))
+        {
+            continue;
+        }
+
+        const pio_program_t* program = sequencer_program_clock_get(clock_type);
+        bool loaded = false;
+
+        for (uint32_t j = 0; j < program_count; j++)
+        {
+            loaded |= (programs[j] == program);
+        }
+
+        if (!loaded)
+        {
+            programs[program_count++] = program;
+            length += program -> length;
+        }
+    }
+
+    return length <= PIO_INSTRUCTION_COUNT;
+}
+
+
+void sequencer_program_clock_remove(
+    PIO pio_clock, 
+    uint offset,
+    uint32_t clock_type
+) {
+    struct clock_program* loaded = sequencer_program_clock_find(
+        sequencer_program_clock_get(clock_type)
+    );
+
+    if ((loaded == NULL) || (loaded -> offset != offset))
+    {
+        // We should never get to this point.
+        return;
+    }
+
+    loaded -> users--;
+
+    // Only remove the program once the last clock using it is freed
+    if (loaded -> users == 0)
+    {
+        pio_remove_program(
+            pio_clock,
+            loaded -> program,
+            offset
+        );
+
+        loaded -> program = NULL;
     }
 }
 
@@ -207,12 +389,26 @@ void sequencer_clocks_init(
         config_array[i].trigger_level = TRIGGER_GATE_DEFAULT;
         config_array[i].clock_pin = INTERNAL_CLOCK_PINS[i];
         config_array[i].trigger_pin = EXTERNAL_TRIGGER_PINS[0]; // All clocks should default to same trigger pin
+        config_array[i].trigger_pin_aux = EXTERNAL_TRIGGER_PINS[1];
+        config_array[i].trigger_inputs = 1;
+        config_array[i].trigger_logic = TRIGGER_LOGIC_DEFAULT;
+        config_array[i].trigger_filter = 0;
+        config_array[i].trigger_record = 0;
         config_array[i].trigger_reps = 0;
+        config_array[i].trigger_latency = CLOCK_LATENCY_NONE;
         config_array[i].clock_divider = CLOCK_DIV_DEFAULT;
+        config_array[i].clock_divider_frac = 0;
         config_array[i].unit_offset = CLOCK_UNITS_OFFSET_DEFAULT;
         config_array[i].unit_offset_trigger = PULSE_UNITS_OFFSET_DEFAULT;
+        config_array[i].clock_pin_output = true;
         config_array[i].active = false;
         config_array[i].configured = false;
+
+        sequencer_clock_insert_instructions_triggered_mask(
+            &config_array[i],
+            CLOCK_TRIGGER_MASK_DEFAULT,
+            1 // single bit mask
+        );
     }
 }
 
@@ -269,6 +465,140 @@ void sequencer_clock_insert_instructions_triggered_delay(
 }
 
 
+// Get the amount of DMA fed mask words for a mask of a given bit length.
+// The DMA ring buffer requires a power of two amount of words, and every
+// word must hold the same amount of bits since the bit count is stored in
+// the state machine pull threshold.
+bool sequencer_clock_trigger_mask_words_get(
+    uint32_t length,
+    uint32_t* words
+) {
+    const uint32_t BITS_PER_WORD = 32;
+
+    for (uint32_t mask_words = 1; mask_words <= CLOCK_TRIGGER_MASK_WORDS; mask_words *= 2)
+    {
+        if ((length % mask_words == 0) &&
+            (length / mask_words <= BITS_PER_WORD))
+        {
+            *words = mask_words;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Split an accept mask (bit i = trigger i) into equally sized mask words.
+// NOTE: The length is assumed to be validated beforehand.
+void sequencer_clock_insert_instructions_triggered_mask(
+    struct clock_config* config,
+    uint32_t mask[CLOCK_TRIGGER_MASK_WORDS],
+    uint32_t length
+) {
+    uint32_t mask_words = 1;
+
+    if (!sequencer_clock_trigger_mask_words_get(length, &mask_words))
+    {
+        return;
+    }
+
+    const uint32_t mask_bits = length / mask_words;
+
+    for (uint32_t i = 0; i < CLOCK_TRIGGER_MASK_WORDS; i++)
+    {
+        config -> trigger_mask[i] = 0;
+    }
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        const uint32_t bit = (mask[i / 32] >> (i % 32)) & 1u;
+
+        config -> trigger_mask[i / mask_bits] |= bit << (i % mask_bits);
+    }
+
+    config -> trigger_mask_words = mask_words;
+    config -> trigger_mask_bits = mask_bits;
+}
+
+
+// Get the amount of accepted triggers in one pass of the accept mask
+uint32_t sequencer_clock_trigger_mask_accepts_get(
+    const struct clock_config* config
+) {
+    uint32_t accepts = 0;
+
+    for (uint32_t i = 0; i < config -> trigger_mask_words; i++)
+    {
+        accepts += __builtin_popcount(config -> trigger_mask[i]);
+    }
+
+    return accepts;
+}
+
+
+// Check that the trigger count of a clock in mask mode is a whole number of
+// mask passes. The DMA feeds whole mask words, so the count of accepted
+// triggers is turned into a pass count when arming.
+bool sequencer_clock_trigger_count_validate(
+    struct clock_config* config
+) {
+    uint32_t clock_type = 0;
+
+    if (!clock_sequencer_map_mode(config, &clock_type) ||
+        ((clock_type != CLOCK_TRIGGERED_MASK_RISING) &&
+         (clock_type != CLOCK_TRIGGERED_MASK_FALLING)))
+    {
+        return true;
+    }
+
+    const uint32_t accepts = sequencer_clock_trigger_mask_accepts_get(config);
+
+    if (accepts == 0)
+    {
+        return config -> trigger_reps == 0;
+    }
+
+    return (config -> trigger_reps % accepts) == 0;
+}
+
+
+void sequencer_clock_insert_instructions_triggered_filter(
+    struct clock_config* config,
+    uint32_t filter
+) {
+    config -> trigger_filter = filter;
+}
+
+
+// Get the filter loop count of a clock channel. Each filter loop samples
+// the trigger once and takes 2 cycles, and at least one sample is taken.
+uint32_t sequencer_clock_trigger_filter_loops(
+    struct clock_config* config
+) {
+    const uint32_t CYCLES_PER_LOOP = 2;
+
+    uint32_t filter_loops = (config -> trigger_filter + CYCLES_PER_LOOP - 1) / CYCLES_PER_LOOP;
+
+    if (filter_loops == 0)
+    {
+        filter_loops = 1;
+    }
+
+    // jmp y-- loops y + 1 times
+    return filter_loops - 1;
+}
+
+
+// Get the fixed latency in state machine cycles the glitch filter adds to
+// a trigger (filter length load + 2 cycles per filter loop).
+uint32_t sequencer_clock_trigger_filter_latency(
+    struct clock_config* config
+) {
+    return 1 + 2 * (sequencer_clock_trigger_filter_loops(config) + 1);
+}
+
+
 void sequencer_clock_config_reset(
     struct clock_config* config
 ) {
@@ -282,9 +612,21 @@ void sequencer_clock_config_reset(
         CLOCK_TRIGGERS_DEFAULT
     );
 
+    sequencer_clock_insert_instructions_triggered_mask(
+        config,
+        CLOCK_TRIGGER_MASK_DEFAULT,
+        1 // single bit mask
+    );
+
     config -> trigger_pin = EXTERNAL_TRIGGER_PINS[0];
+    config -> trigger_pin_aux = EXTERNAL_TRIGGER_PINS[1];
+    config -> trigger_inputs = 1;
+    config -> trigger_logic = TRIGGER_LOGIC_DEFAULT;
+    config -> trigger_filter = 0;
     config -> trigger_reps = 0;
+    config -> trigger_latency = CLOCK_LATENCY_NONE;
     config -> clock_divider = CLOCK_DIV_DEFAULT;
+    config -> clock_divider_frac = 0;
     config -> unit_offset = CLOCK_UNITS_OFFSET_DEFAULT;
     config -> unit_offset_trigger = PULSE_UNITS_OFFSET_DEFAULT;
     config -> clock_mode = CLOCK_MODE_DEFAULT;
@@ -299,8 +641,6 @@ void sequencer_clock_dma_configure(
     struct clock_config* config,
     uint32_t clock_type
 ) {
-    const uint RING_BUFF_SIZE_POWER = 3; //log(2)(CLOCK_TRIGGERS_MAX * 4)
-
     config -> dma_chan = dma_claim_unused_channel(true);
     
     dma_channel_config dma_config = dma_channel_get_default_config(config -> dma_chan);
@@ -350,23 +690,56 @@ void sequencer_clock_dma_configure(
         case CLOCK_TRIGGERED:
         case CLOCK_TRIGGERED_RISING:
         case CLOCK_TRIGGERED_FALLING:
+        case CLOCK_TRIGGERED_OR_RISING:
+        case CLOCK_TRIGGERED_OR_FALLING:
+        case CLOCK_TRIGGERED_AND_RISING:
+        case CLOCK_TRIGGERED_AND_FALLING:
+        case CLOCK_TRIGGERED_ARM_RISING:
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            // The same trigger record is sent for every accepted trigger
+            channel_config_set_read_increment(
+                &dma_config, 
+                false
+            );
+
+            // Start dma with the selected channel, generated config
+            dma_channel_configure(
+                config -> dma_chan,
+                &dma_config,
+                &config -> pio->txf[config -> sm], // Source pointer
+                &config -> trigger_record, // Instruction read address
+                config -> trigger_reps, // Number of reps to perform
+                true // Start transfers immediately
+            );
+
+            break;
+
+        case CLOCK_TRIGGERED_MASK_RISING:
+        case CLOCK_TRIGGERED_MASK_FALLING:
+        {
+            // The trigger count is in accepted triggers, the commit made sure
+            // it is a whole number of mask passes
+            const uint32_t accepts = sequencer_clock_trigger_mask_accepts_get(config);
+            const uint32_t passes = (accepts > 0) ? config -> trigger_reps / accepts : 0;
+
+            // Ring size is log(2)(mask words * 4), and mask words is always a power of two
             channel_config_set_ring(
                 &dma_config,
                 false,
-                RING_BUFF_SIZE_POWER
+                2 + __builtin_ctz(config -> trigger_mask_words)
             );
 
-            // Start dma with the selected channel, generated config
             dma_channel_configure(
                 config -> dma_chan,
                 &dma_config,
                 &config -> pio->txf[config -> sm], // Source pointer
-                config -> trigger_config, // Instruction read address
-                CLOCK_TRIGGERS_MAX * config -> trigger_reps, // Number of instructions * reps to perform
+                config -> trigger_mask, // Mask read address
+                config -> trigger_mask_words * passes, // Number of mask words * passes to perform
                 true // Start transfers immediately
             );
 
             break;
+        }
 
         default:
             // We should never get to this point.
@@ -379,7 +752,8 @@ void sequencer_freerun_sm_helper_init(
     PIO pio, uint sm, 
     uint offset, 
     uint pin_out,
-    uint clock_divider
+    uint clock_divider,
+    uint clock_divider_frac
 ) {
     // Initialize gpio pin
     pio_gpio_init(pio, pin_out);
@@ -402,10 +776,11 @@ void sequencer_freerun_sm_helper_init(
         1 // only one pin is used
     );
 
-    // Setup clock clock divider
-    sm_config_set_clkdiv(
+    // Setup clock clock divider (16.8 fixed point)
+    sm_config_set_clkdiv_int_frac8(
         &config,
-        (float) clock_divider
+        clock_divider,
+        clock_divider_frac
     );
 
     pio_sm_init(
@@ -422,6 +797,7 @@ void sequencer_triggered_sm_helper_init(
     uint pin_out,
     uint pin_trig, 
     uint clock_divider,
+    uint clock_divider_frac,
     uint32_t clock_type
 ) {
     // Initialize GPIO pin
@@ -478,13 +854,22 @@ void sequencer_triggered_sm_helper_init(
         1 // only one pin is used
     );
 
-    // Set trigger pins of config to input pins
+    // Set trigger pins of config to input pins. Edge programs wait on the
+    // input pin and sample the jmp pin in the glitch filter.
+    sm_config_set_jmp_pin(
+        &config,
+        pin_trig
+    );
+
     if (clock_type == CLOCK_TRIGGERED_HIGH ||
         clock_type == CLOCK_TRIGGERED_LOW)
     {
-        sm_config_set_jmp_pin(
-            &config,
-            pin_trig
+        // Setup autopull for 32 bit words
+        sm_config_set_out_shift(
+            &config, 
+            true, 
+            true, 
+            32
         );
     }
     else
@@ -493,20 +878,220 @@ void sequencer_triggered_sm_helper_init(
             &config,
             pin_trig
         );
+
+        // Trigger records are pulled manually since the filter length
+        // has to stay in the OSR
+        sm_config_set_out_shift(
+            &config, 
+            true, 
+            false, 
+            32
+        );
     }
 
-    // Setup autopull for 32 bit words
+    // Setup clock clock divider (16.8 fixed point)
+    sm_config_set_clkdiv_int_frac8(
+        &config,
+        clock_divider,
+        clock_divider_frac
+    );
+
+    pio_sm_init(
+        pio, sm,
+        offset,
+        &config
+    );
+}
+
+
+void sequencer_triggered_mask_sm_helper_init(
+    PIO pio, uint sm, 
+    uint offset, 
+    uint pin_out,
+    uint pin_trig, 
+    uint clock_divider,
+    uint clock_divider_frac,
+    uint mask_bits,
+    uint32_t clock_type
+) {
+    // Initialize GPIO pin
+    pio_gpio_init(pio, pin_out);
+    pio_gpio_init(pio, pin_trig);
+
+    // Set pin directions
+    pio_sm_set_consecutive_pindirs(
+        pio, sm,
+		pin_out,
+		1, // only one pin is used
+        true // output direction
+    );
+
+	pio_sm_set_consecutive_pindirs(
+        pio, sm,
+		pin_trig,
+		1, // only one pin is used
+        false // input direction
+    );
+
+    pio_sm_config config = sequencer_pio_clock_triggered_mask_rising_program_get_default_config(offset);
+
+    if (clock_type == CLOCK_TRIGGERED_MASK_FALLING)
+    {
+        config = sequencer_pio_clock_triggered_mask_falling_program_get_default_config(offset);
+    }
+
+    // Set output pins of config to output pins
+	sm_config_set_set_pins(
+        &config,
+        pin_out, 
+        1 // only one pin is used
+    );
+
+    sm_config_set_in_pins(
+        &config,
+        pin_trig
+    );
+
+    sm_config_set_jmp_pin(
+        &config,
+        pin_trig
+    );
+
+    // Shift mask bits out LSB first. Autopull is disabled and the pull
+    // threshold equals the amount of bits in each mask word so !OSRE
+    // marks the end of the mask word.
     sm_config_set_out_shift(
         &config, 
         true, 
+        false, 
+        mask_bits
+    );
+
+    // Setup clock clock divider (16.8 fixed point)
+    sm_config_set_clkdiv_int_frac8(
+        &config,
+        clock_divider,
+        clock_divider_frac
+    );
+
+    pio_sm_init(
+        pio, sm,
+        offset,
+        &config
+    );
+}
+
+
+void sequencer_triggered_logic_sm_helper_init(
+    PIO pio, uint sm, 
+    uint offset, 
+    uint pin_out,
+    uint pin_trig, 
+    uint pin_trig_aux, 
+    uint clock_divider,
+    uint clock_divider_frac,
+    uint32_t clock_type
+) {
+    // Initialize GPIO pin
+    pio_gpio_init(pio, pin_out);
+    pio_gpio_init(pio, pin_trig);
+    pio_gpio_init(pio, pin_trig_aux);
+
+    // Set pin directions
+    pio_sm_set_consecutive_pindirs(
+        pio, sm,
+		pin_out,
+		1, // only one pin is used
+        true // output direction
+    );
+
+	pio_sm_set_consecutive_pindirs(
+        pio, sm,
+		pin_trig,
+		1, // only one pin is used
+        false // input direction
+    );
+
+	pio_sm_set_consecutive_pindirs(
+        pio, sm,
+		pin_trig_aux,
+		1, // only one pin is used
+        false // input direction
+    );
+
+    // Defualt init (don't really care what, just as long as it isn't null)
+    pio_sm_config config = sequencer_pio_clock_triggered_or_rising_program_get_default_config(offset);
+
+    switch (clock_type)
+    {
+        case CLOCK_TRIGGERED_OR_RISING:
+            config = sequencer_pio_clock_triggered_or_rising_program_get_default_config(offset);
+            break;
+
+        case CLOCK_TRIGGERED_OR_FALLING:
+            config = sequencer_pio_clock_triggered_or_falling_program_get_default_config(offset);
+            break;
+
+        case CLOCK_TRIGGERED_AND_RISING:
+            config = sequencer_pio_clock_triggered_and_rising_program_get_default_config(offset);
+            break;
+
+        case CLOCK_TRIGGERED_AND_FALLING:
+            config = sequencer_pio_clock_triggered_and_falling_program_get_default_config(offset);
+            break;
+
+        case CLOCK_TRIGGERED_ARM_RISING:
+            config = sequencer_pio_clock_triggered_arm_rising_program_get_default_config(offset);
+            break;
+
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            config = sequencer_pio_clock_triggered_arm_falling_program_get_default_config(offset);
+            break;
+
+        default:
+            // We should never get to this point...
+            return;
+    }
+
+    // Set output pins of config to output pins
+	sm_config_set_set_pins(
+        &config,
+        pin_out, 
+        1 // only one pin is used
+    );
+
+    // Input A is the input pin and input B is the jmp pin, so the two
+    // inputs don't have to be consecutive. Only input A is sampled by
+    // mov y, pins so all other input pins are masked.
+    sm_config_set_in_pins(
+        &config,
+        pin_trig
+    );
+
+    sm_config_set_in_pin_count(
+        &config,
+        1
+    );
+
+    sm_config_set_jmp_pin(
+        &config,
+        pin_trig_aux
+    );
+
+    // Trigger records are pulled manually since the filter length
+    // has to stay in the OSR
+    sm_config_set_out_shift(
+        &config, 
         true, 
+        false, 
         32
     );
 
-    // Setup clock clock divider
-    sm_config_set_clkdiv(
+    // Setup clock clock divider (16.8 fixed point)
+    sm_config_set_clkdiv_int_frac8(
         &config,
-        (float) clock_divider
+        clock_divider,
+        clock_divider_frac
     );
 
     pio_sm_init(
@@ -517,6 +1102,32 @@ void sequencer_triggered_sm_helper_init(
 }
 
 
+// Load a constant into a scratch register (X, Y or ISR) of a disabled state
+// machine. Programs use this for parameters that never change during a
+// sequence so they don't have to be streamed by the DMA.
+// NOTE: Must be called after pio_sm_init since a restart clears the registers.
+void sequencer_clock_sm_register_preload(
+    PIO pio, uint sm,
+    enum pio_src_dest dest,
+    uint32_t value
+) {
+    pio_sm_put_blocking(
+        pio, sm,
+        value
+    );
+
+    pio_sm_exec(
+        pio, sm,
+        pio_encode_pull(false, true)
+    );
+
+    pio_sm_exec(
+        pio, sm,
+        pio_encode_mov(dest, pio_osr)
+    );
+}
+
+
 // NOTE: Claims both state machine and PIO memory
 // NOTE: sets configured to true
 void sequencer_clock_sm_config(
@@ -538,6 +1149,13 @@ void sequencer_clock_sm_config(
         return;
     }
 
+    // Loading a program that doesn't fit panics, so leave the clock
+    // unconfigured instead and let the arm request fail
+    if (!sequencer_program_clock_fits(config -> pio, clock_type))
+    {
+        return;
+    }
+
     // Claim unused state machine
     pio_claim_sm_mask(
         config -> pio,
@@ -571,7 +1189,8 @@ void sequencer_clock_sm_config(
                 config -> sm,
                 config -> program_offset,
                 config -> clock_pin,
-                config -> clock_divider
+                config -> clock_divider,
+                config -> clock_divider_frac
             );
             break;
 
@@ -587,8 +1206,95 @@ void sequencer_clock_sm_config(
                 config -> clock_pin,
                 config -> trigger_pin,
                 config -> clock_divider,
+                config -> clock_divider_frac,
                 clock_type
             );
+
+            if (clock_type == CLOCK_TRIGGERED_HIGH ||
+                clock_type == CLOCK_TRIGGERED_LOW)
+            {
+                break;
+            }
+
+            // Pack trigger skips (index 0) and filter loops into one trigger record
+            config -> trigger_record = (config -> trigger_config[0] & 0xFFFF) |
+                (sequencer_clock_trigger_filter_loops(config) << 16);
+
+            // Trigger delay is index 1 of the trigger config
+            sequencer_clock_sm_register_preload(
+                config -> pio,
+                config -> sm,
+                pio_isr,
+                config -> trigger_config[1]
+            );
+            break;
+
+        case CLOCK_TRIGGERED_OR_RISING:
+        case CLOCK_TRIGGERED_OR_FALLING:
+        case CLOCK_TRIGGERED_AND_RISING:
+        case CLOCK_TRIGGERED_AND_FALLING:
+        case CLOCK_TRIGGERED_ARM_RISING:
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            sequencer_triggered_logic_sm_helper_init(
+                config -> pio,
+                config -> sm,
+                config -> program_offset,
+                config -> clock_pin,
+                config -> trigger_pin,
+                config -> trigger_pin_aux,
+                config -> clock_divider,
+                config -> clock_divider_frac,
+                clock_type
+            );
+
+            // Same trigger record as the single input edge programs. Only the
+            // arm-then-fire programs use the filter loops.
+            config -> trigger_record = (config -> trigger_config[0] & 0xFFFF) |
+                (sequencer_clock_trigger_filter_loops(config) << 16);
+
+            // Trigger delay is index 1 of the trigger config
+            sequencer_clock_sm_register_preload(
+                config -> pio,
+                config -> sm,
+                pio_isr,
+                config -> trigger_config[1]
+            );
+            break;
+
+        case CLOCK_TRIGGERED_MASK_RISING:
+        case CLOCK_TRIGGERED_MASK_FALLING:
+            sequencer_triggered_mask_sm_helper_init(
+                config -> pio,
+                config -> sm,
+                config -> program_offset,
+                config -> clock_pin,
+                config -> trigger_pin,
+                config -> clock_divider,
+                config -> clock_divider_frac,
+                config -> trigger_mask_bits,
+                clock_type
+            );
+
+            // Drop an edge flag left over from the previous run
+            pio_interrupt_clear(
+                config -> pio,
+                CLOCK_TRIGGER_EDGE_IRQ_BASE + config -> sm
+            );
+
+            sequencer_clock_sm_register_preload(
+                config -> pio,
+                config -> sm,
+                pio_x,
+                sequencer_clock_trigger_filter_loops(config)
+            );
+
+            // Trigger delay is index 1 of the trigger config
+            sequencer_clock_sm_register_preload(
+                config -> pio,
+                config -> sm,
+                pio_isr,
+                config -> trigger_config[1]
+            );
             break;
 
         default:
@@ -596,6 +1302,15 @@ void sequencer_clock_sm_config(
             return;
     }
 
+    // Release the clock pin when all listeners use the IRQ flag, the
+    // state machine keeps driving its (now disconnected) pin
+    if (!config -> clock_pin_output)
+    {
+        gpio_deinit(
+            config -> clock_pin
+        );
+    }
+
     sequencer_clock_dma_configure(
         config,
         clock_type
@@ -605,6 +1320,96 @@ void sequencer_clock_sm_config(
 }
 
 
+// Check if a clock channel waits on external triggers. These programs pull
+// one DMA word per accepted trigger (or per mask word for mask programs).
+bool sequencer_clock_externally_triggered(
+    struct clock_config* config
+) {
+    uint32_t clock_type = 0;
+
+    if (!clock_sequencer_map_mode(
+        config,
+        &clock_type
+    )) {
+        return false;
+    }
+
+    switch (clock_type)
+    {
+        case CLOCK_TRIGGERED:
+        case CLOCK_TRIGGERED_RISING:
+        case CLOCK_TRIGGERED_FALLING:
+        case CLOCK_TRIGGERED_MASK_RISING:
+        case CLOCK_TRIGGERED_MASK_FALLING:
+        case CLOCK_TRIGGERED_OR_RISING:
+        case CLOCK_TRIGGERED_OR_FALLING:
+        case CLOCK_TRIGGERED_AND_RISING:
+        case CLOCK_TRIGGERED_AND_FALLING:
+        case CLOCK_TRIGGERED_ARM_RISING:
+        case CLOCK_TRIGGERED_ARM_FALLING:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+// Get the amount of words the state machine did not pull yet (words left
+// in the DMA transfer + words waiting in the TX FIFO). This decreases by one
+// every time an external trigger is accepted.
+uint32_t sequencer_clock_trigger_remaining(
+    struct clock_config* config
+) {
+    const uint32_t dma_remaining = dma_channel_hw_addr(config -> dma_chan) -> transfer_count &
+        DMA_CH0_TRANS_COUNT_COUNT_BITS;
+
+    const uint32_t fifo_remaining = pio_sm_get_tx_fifo_level(
+        config -> pio,
+        config -> sm
+    );
+
+    return dma_remaining + fifo_remaining;
+}
+
+
+// Check and clear the edge flag of a mask triggered clock. Mask programs pull
+// one DMA word per mask word, the flag is raised for every filtered trigger
+// edge, including edges the mask rejects.
+bool sequencer_clock_trigger_edge_take(
+    struct clock_config* config
+) {
+    uint32_t clock_type = 0;
+
+    if (!clock_sequencer_map_mode(
+        config,
+        &clock_type
+    )) {
+        return false;
+    }
+
+    if ((clock_type != CLOCK_TRIGGERED_MASK_RISING) &&
+        (clock_type != CLOCK_TRIGGERED_MASK_FALLING))
+    {
+        return false;
+    }
+
+    const uint irq_flag = CLOCK_TRIGGER_EDGE_IRQ_BASE + config -> sm;
+
+    if (!pio_interrupt_get(config -> pio, irq_flag))
+    {
+        return false;
+    }
+
+    pio_interrupt_clear(
+        config -> pio,
+        irq_flag
+    );
+
+    return true;
+}
+
+
 void sequencer_clock_dma_free(
     struct clock_config* config
 ) {
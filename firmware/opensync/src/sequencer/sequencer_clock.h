@@ -7,11 +7,38 @@
 #include "sequencer_common.h"
 
 
+bool clock_sequencer_map_logic(
+    struct clock_config* config,
+    uint32_t* internal_mode
+);
+
+bool clock_sequencer_map_mode(
+    struct clock_config* config,
+    uint32_t* internal_mode
+);
+
+const pio_program_t* sequencer_program_clock_get(
+    uint32_t clock_type
+);
+
 uint sequencer_program_clock_add(
     PIO pio_clock,
     uint32_t clock_type
 );
 
+bool sequencer_program_clock_fits(
+    PIO pio_clock,
+    uint32_t clock_type
+);
+
+uint32_t sequencer_clock_trigger_pins_get(
+    struct clock_config* config
+);
+
+bool sequencer_clock_programs_validate(
+    struct clock_config* config_array
+);
+
 void sequencer_program_clock_remove(
     PIO pio_clock, 
     uint offset,
@@ -50,6 +77,38 @@ void sequencer_clock_insert_instructions_triggered_delay(
     uint32_t delay
 );
 
+bool sequencer_clock_trigger_mask_words_get(
+    uint32_t length,
+    uint32_t* words
+);
+
+void sequencer_clock_insert_instructions_triggered_mask(
+    struct clock_config* config,
+    uint32_t mask[CLOCK_TRIGGER_MASK_WORDS],
+    uint32_t length
+);
+
+uint32_t sequencer_clock_trigger_mask_accepts_get(
+    const struct clock_config* config
+);
+
+bool sequencer_clock_trigger_count_validate(
+    struct clock_config* config
+);
+
+void sequencer_clock_insert_instructions_triggered_filter(
+    struct clock_config* config,
+    uint32_t filter
+);
+
+uint32_t sequencer_clock_trigger_filter_loops(
+    struct clock_config* config
+);
+
+uint32_t sequencer_clock_trigger_filter_latency(
+    struct clock_config* config
+);
+
 void sequencer_clock_config_reset(
     struct clock_config* config
 );
@@ -63,7 +122,8 @@ void sequencer_freerun_sm_helper_init(
     PIO pio, uint sm, 
     uint offset, 
     uint pin_out,
-    uint clock_divider
+    uint clock_divider,
+    uint clock_divider_frac
 );
 
 void sequencer_triggered_sm_helper_init(
@@ -72,13 +132,54 @@ void sequencer_triggered_sm_helper_init(
     uint pin_out,
     uint pin_trig, 
     uint clock_divider,
+    uint clock_divider_frac,
+    uint32_t clock_type
+);
+
+void sequencer_triggered_logic_sm_helper_init(
+    PIO pio, uint sm, 
+    uint offset, 
+    uint pin_out,
+    uint pin_trig, 
+    uint pin_trig_aux, 
+    uint clock_divider,
+    uint clock_divider_frac,
+    uint32_t clock_type
+);
+
+void sequencer_triggered_mask_sm_helper_init(
+    PIO pio, uint sm, 
+    uint offset, 
+    uint pin_out,
+    uint pin_trig, 
+    uint clock_divider,
+    uint clock_divider_frac,
+    uint mask_bits,
     uint32_t clock_type
 );
 
+void sequencer_clock_sm_register_preload(
+    PIO pio, uint sm,
+    enum pio_src_dest dest,
+    uint32_t value
+);
+
 void sequencer_clock_sm_config(
     struct clock_config* config
 );
 
+bool sequencer_clock_externally_triggered(
+    struct clock_config* config
+);
+
+uint32_t sequencer_clock_trigger_remaining(
+    struct clock_config* config
+);
+
+bool sequencer_clock_trigger_edge_take(
+    struct clock_config* config
+);
+
 void sequencer_clock_dma_free(
     struct clock_config* config
 );
@@ -21,19 +21,28 @@ const uint32_t CLOCK_DIV_DEFAULT = CLOCK_DIV_RES_HIGH;
 const uint32_t SEQUENCE_FLAG_END = 0;
 const uint32_t ITERATIONS_MAX = 500000;
 const uint32_t TRIGGER_SKIPS_MAX = 500;
+const uint32_t TRIGGER_FILTER_MAX = 131072; // 2 cycles per filter loop * 2^16 loops
 const uint32_t CLOCK_DIVIDER_MAX = 50000;
+const uint32_t CLOCK_DIVIDER_FRAC_BITS = 8; // PIO dividers are 16.8 fixed point
 const uint32_t PULSE_INSTRUCTION_OFFSET = 4;
 const uint32_t CLOCK_INSTRUCTION_OFFSET = 1;
+const uint32_t PULSE_EXTENDED_INSTRUCTION_OFFSET = 7;
+const uint64_t PULSE_EXTENDED_BLOCK_CYCLES = 1ull << 31; // ~8.6 s per block at divider 1
+const uint32_t PULSE_EXTENDED_BLOCK_LOOPS = (1u << 31) - 3; // mov + jmp y-- add 3 cycles per block
+const uint32_t PULSE_PACKED_DELAY_MAX = (1u << (32 - PULSE_PACKED_STATE_BITS)) - 1;
+const uint32_t PULSE_FAST_INSTRUCTION_OFFSET = 3; // out pins + out exec + executed nop
+const uint32_t PULSE_FAST_DELAY_MAX = 31; // PIO delay field without side-set
+const uint32_t PULSE_FAST_WAIT_DELAY = 5; // keeps the input latency of the standard pulser
 const uint32_t CLOCK_INSTRUCTION_MIN = PULSE_INSTRUCTIONS_MAX * PULSE_INSTRUCTION_OFFSET;
 const uint32_t INTERNAL_PULSE_IDS[PULSES_MAX] = {0, 1, 2};
 const uint32_t INTERNAL_CLOCK_IDS[CLOCKS_MAX] = {0, 1, 2};
 const uint32_t INTERNAL_CLOCK_PINS[CLOCKS_MAX] = {16, 17, 18};
-const uint32_t EXTERNAL_TRIGGER_IDS[TRIGGERS_MAX] = {0};
-const uint32_t EXTERNAL_TRIGGER_PINS[TRIGGERS_MAX] = {13};
+const uint32_t EXTERNAL_TRIGGER_IDS[TRIGGERS_MAX] = {0, 1};
+const uint32_t EXTERNAL_TRIGGER_PINS[TRIGGERS_MAX] = {13, 14};
 const uint32_t CLOCK_MODE_DEFAULT   = CLOCK_SCPI_MODE_FREERUN;
 const uint32_t TRIGGER_MODE_DEFAULT = CLOCK_TRIG_SOURCE_IMMEDIATE;
 const uint32_t TRIGGER_EDGE_DEFAULT = CLOCK_TRIG_EDGE_POSITIVE;
 const uint32_t TRIGGER_GATE_DEFAULT = CLOCK_GATE_LEVEL_HIGH;
-const double PULSE_UNITS_OFFSET_DEFAULT = 1e3; // microseconds
-const double CLOCK_UNITS_OFFSET_DEFAULT = 1.0; // Hertz
-const double SEQUENCER_DOUBLE_EPS = 1e-8;
+const uint32_t TRIGGER_LOGIC_DEFAULT = CLOCK_TRIG_LOGIC_SINGLE;
+const uint64_t PULSE_UNITS_OFFSET_DEFAULT = 1000; // microseconds
+const uint64_t CLOCK_UNITS_OFFSET_DEFAULT = 1; // Hertz
@@ -23,9 +23,18 @@ extern const uint32_t CLOCK_DIV_DEFAULT;
 extern const uint32_t SEQUENCE_FLAG_END;
 extern const uint32_t ITERATIONS_MAX;
 extern const uint32_t TRIGGER_SKIPS_MAX;
+extern const uint32_t TRIGGER_FILTER_MAX;
 extern const uint32_t CLOCK_DIVIDER_MAX;
+extern const uint32_t CLOCK_DIVIDER_FRAC_BITS;
 extern const uint32_t PULSE_INSTRUCTION_OFFSET;
 extern const uint32_t CLOCK_INSTRUCTION_OFFSET;
+extern const uint32_t PULSE_EXTENDED_INSTRUCTION_OFFSET;
+extern const uint64_t PULSE_EXTENDED_BLOCK_CYCLES;
+extern const uint32_t PULSE_EXTENDED_BLOCK_LOOPS;
+extern const uint32_t PULSE_PACKED_DELAY_MAX;
+extern const uint32_t PULSE_FAST_INSTRUCTION_OFFSET;
+extern const uint32_t PULSE_FAST_DELAY_MAX;
+extern const uint32_t PULSE_FAST_WAIT_DELAY;
 extern const uint32_t CLOCK_INSTRUCTION_MIN;
 extern const uint32_t INTERNAL_PULSE_IDS[PULSES_MAX];
 extern const uint32_t INTERNAL_CLOCK_IDS[CLOCKS_MAX];
@@ -36,6 +45,6 @@ extern const uint32_t CLOCK_MODE_DEFAULT;
 extern const uint32_t TRIGGER_MODE_DEFAULT;
 extern const uint32_t TRIGGER_EDGE_DEFAULT;
 extern const uint32_t TRIGGER_GATE_DEFAULT;
-extern const double PULSE_UNITS_OFFSET_DEFAULT;
-extern const double CLOCK_UNITS_OFFSET_DEFAULT;
-extern const double SEQUENCER_DOUBLE_EPS;
+extern const uint32_t TRIGGER_LOGIC_DEFAULT;
+extern const uint64_t PULSE_UNITS_OFFSET_DEFAULT;
+extern const uint64_t CLOCK_UNITS_OFFSET_DEFAULT;
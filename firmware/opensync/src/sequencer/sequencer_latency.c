@@ -0,0 +1,239 @@
+#include "sequencer_latency.h"
+
+#include <stdint.h>
+
+#include "overclock/overclock.h"
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+#include "sequencer_common.h"
+#include "sequencer_clock.h"
+
+
+/* Note:
+   The pipeline latency of every path is counted from the PIO programs at a
+   clock divider of 1 and includes the 2 cycle GPIO input synchronizer. The
+   values are in state machine cycles, so they scale with the clock divider.
+
+   Clock programs: cycles from the trigger edge to the rising clock edge,
+   without the glitch filter and the trigger delay loop (both added in
+   sequencer_latency_trigger_get). Untriggered programs are not compensated.
+*/
+const uint32_t CLOCK_TRIGGER_LATENCY_CYCLES[CLOCK_TRIGGERED_ARM_FALLING + 1] = {
+    [CLOCK_FREERUN]               = 0,
+    [CLOCK_TRIGGERED]             = 0,
+    [CLOCK_TRIGGERED_RISING]      = 6, // sync + wait + skip + delay load + set
+    [CLOCK_TRIGGERED_HIGH]        = 0,
+    [CLOCK_TRIGGERED_FALLING]     = 6,
+    [CLOCK_TRIGGERED_LOW]         = 0,
+    [CLOCK_TRIGGERED_SNIFFER]     = 0,
+    [CLOCK_TRIGGERED_MASK_RISING] = 7, // sync + wait + mask check (2) + delay load + set
+    [CLOCK_TRIGGERED_MASK_FALLING]= 7,
+    [CLOCK_TRIGGERED_OR_RISING]   = 7, // sync + decision (2, nominal) + skip + delay load + set
+    [CLOCK_TRIGGERED_OR_FALLING]  = 7,
+    [CLOCK_TRIGGERED_AND_RISING]  = 7,
+    [CLOCK_TRIGGERED_AND_FALLING] = 7,
+    [CLOCK_TRIGGERED_ARM_RISING]  = 6, // sync + wait jmppin + skip + delay load + set
+    [CLOCK_TRIGGERED_ARM_FALLING] = 6
+};
+
+// Pulse programs: cycles from the input edge to the first output edge
+const uint32_t PULSE_INPUT_LATENCY_CYCLES[PULSE_INPUT_CLOCK_IRQ + 1] = {
+    [PULSE_INPUT_CLOCK]     = 9, // sync + wait [4] + jmp + out
+    [PULSE_INPUT_EXTERNAL]  = 9, // same program as the clock pin input
+    [PULSE_INPUT_CLOCK_IRQ] = 3  // irq set after the clock edge + wait irq + out
+};
+
+
+// Get the latency in clock cycles from the trigger edge to the clock edge of
+// a clock channel with a trigger delay of 0.
+uint32_t sequencer_latency_trigger_get(
+    struct clock_config* config
+) {
+    // jmp y-- loops y + 1 times, so a zero trigger delay still takes a cycle
+    const uint32_t DELAY_LOOP_MIN = 1;
+
+    uint32_t clock_type = 0;
+
+    if (!sequencer_clock_externally_triggered(config))
+    {
+        return 0;
+    }
+
+    if (!clock_sequencer_map_mode(
+        config,
+        &clock_type
+    )) {
+        return 0;
+    }
+
+    uint32_t latency = CLOCK_TRIGGER_LATENCY_CYCLES[clock_type] + DELAY_LOOP_MIN;
+
+    switch (clock_type)
+    {
+        // No glitch filter in the combined input programs
+        case CLOCK_TRIGGERED_OR_RISING:
+        case CLOCK_TRIGGERED_OR_FALLING:
+        case CLOCK_TRIGGERED_AND_RISING:
+        case CLOCK_TRIGGERED_AND_FALLING:
+            break;
+
+        default:
+            latency += sequencer_clock_trigger_filter_latency(config);
+            break;
+    }
+
+    return latency;
+}
+
+
+// Get the latency in clock cycles from the input edge to the first output edge
+// of a pulse channel.
+uint32_t sequencer_latency_pulse_get(
+    struct pulse_config* config
+) {
+    if (config -> input_source > PULSE_INPUT_CLOCK_IRQ)
+    {
+        return 0;
+    }
+
+    return PULSE_INPUT_LATENCY_CYCLES[config -> input_source];
+}
+
+
+// Get the clock channel a pulse channel listens to. Returns false for
+// external trigger inputs.
+bool sequencer_latency_clock_id_get(
+    struct pulse_config* config,
+    uint32_t* clock_id
+) {
+    if (config -> input_source == PULSE_INPUT_CLOCK_IRQ)
+    {
+        *clock_id = config -> clock_irq;
+        return true;
+    }
+
+    if (config -> input_source != PULSE_INPUT_CLOCK)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        if (INTERNAL_CLOCK_PINS[i] == config -> clock_pin)
+        {
+            *clock_id = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Convert a number of state machine cycles at a 16.8 fixed point clock
+// divider into nanoseconds
+uint64_t sequencer_latency_cycles_nanos_get(
+    uint32_t cycles,
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac
+) {
+    const uint64_t divider_fixed = ((uint64_t) clock_divider << CLOCK_DIVIDER_FRAC_BITS) + clock_divider_frac;
+    const struct overclock_profile* profile = overclock_profile_get();
+
+    return ((uint64_t) cycles * divider_fixed * profile -> cycle_nanos_num / profile -> cycle_nanos_den) >> CLOCK_DIVIDER_FRAC_BITS;
+}
+
+
+// Get the total latency in nanoseconds from the trigger (or clock) edge to the
+// first output edge of a pulse channel, with a trigger delay of 0.
+uint64_t sequencer_latency_path_nanos_get(
+    struct pulse_config* pulse_config,
+    struct clock_config* clock_config_array
+) {
+    uint32_t clock_id = 0;
+
+    uint64_t latency = sequencer_latency_cycles_nanos_get(
+        sequencer_latency_pulse_get(pulse_config),
+        pulse_config -> clock_divider,
+        pulse_config -> clock_divider_frac
+    );
+
+    if (sequencer_latency_clock_id_get(
+        pulse_config,
+        &clock_id
+    )) {
+        latency += sequencer_latency_cycles_nanos_get(
+            sequencer_latency_trigger_get(&clock_config_array[clock_id]),
+            clock_config_array[clock_id].clock_divider,
+            clock_config_array[clock_id].clock_divider_frac
+        );
+    }
+
+    return latency;
+}
+
+
+// Subtract a path latency from a programmed delay. Returns false if the delay
+// is shorter than the latency plus the minimum the program can run.
+bool sequencer_latency_compensate(
+    uint64_t cycles,
+    uint64_t latency,
+    uint64_t cycles_min,
+    uint64_t* compensated
+) {
+    if (cycles < (latency + cycles_min))
+    {
+        return false;
+    }
+
+    *compensated = cycles - latency;
+
+    return true;
+}
+
+
+// Compensate the trigger delay of a clock channel again for its current
+// trigger mode and filter, which may have changed since the delay was set.
+// Returns false if the delay is now shorter than the latency.
+bool sequencer_latency_trigger_update(
+    struct clock_config* config
+) {
+    uint64_t delay = 0;
+
+    if (config -> trigger_latency == CLOCK_LATENCY_NONE)
+    {
+        return true;
+    }
+
+    const uint32_t latency = sequencer_latency_trigger_get(config);
+
+    // Delay from the trigger edge as it was set, index 1 of the trigger config
+    if (!sequencer_latency_compensate(
+        (uint64_t) config -> trigger_config[1] + config -> trigger_latency,
+        latency,
+        0,
+        &delay
+    )) {
+        return false;
+    }
+
+    sequencer_clock_insert_instructions_triggered_delay(
+        config,
+        (uint32_t) delay
+    );
+
+    config -> trigger_latency = latency;
+
+    return true;
+}
+
+
+// Check that the first state of a pulse channel was compensated for its
+// current input. The states are encoded per format, so they are not
+// compensated again in place, the data has to be applied again instead.
+bool sequencer_latency_pulse_validate(
+    struct pulse_config* config
+) {
+    return (config -> input_latency == PULSE_LATENCY_NONE) ||
+        (config -> input_latency == sequencer_latency_pulse_get(config));
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+
+
+extern const uint32_t CLOCK_TRIGGER_LATENCY_CYCLES[CLOCK_TRIGGERED_ARM_FALLING + 1];
+extern const uint32_t PULSE_INPUT_LATENCY_CYCLES[PULSE_INPUT_CLOCK_IRQ + 1];
+
+uint32_t sequencer_latency_trigger_get(
+    struct clock_config* config
+);
+
+uint32_t sequencer_latency_pulse_get(
+    struct pulse_config* config
+);
+
+bool sequencer_latency_clock_id_get(
+    struct pulse_config* config,
+    uint32_t* clock_id
+);
+
+uint64_t sequencer_latency_cycles_nanos_get(
+    uint32_t cycles,
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac
+);
+
+uint64_t sequencer_latency_path_nanos_get(
+    struct pulse_config* pulse_config,
+    struct clock_config* clock_config_array
+);
+
+bool sequencer_latency_compensate(
+    uint64_t cycles,
+    uint64_t latency,
+    uint64_t cycles_min,
+    uint64_t* compensated
+);
+
+bool sequencer_latency_trigger_update(
+    struct clock_config* config
+);
+
+bool sequencer_latency_pulse_validate(
+    struct pulse_config* config
+);
@@ -4,35 +4,174 @@
 #include <math.h>
 
 #include "hardware/dma.h"
+#include "hardware/gpio.h"
 #include "hardware/pio.h"
 #include "structs/clock_config.h"
 #include "structs/pulse_config.h"
 #include "sequencer_common.h"
+#include "sequencer_clock.h"
 
 #include "sequencer_pio_pulse_sequencer.pio.h"
+#include "sequencer_pio_pulse_sequencer_irq.pio.h"
+#include "sequencer_pio_pulse_sequencer_extended.pio.h"
+#include "sequencer_pio_pulse_sequencer_packed.pio.h"
+#include "sequencer_pio_pulse_sequencer_fast.pio.h"
 
 
 uint32_t PULSE_INSTRUCTIONS_DEFAULT[PULSE_INSTRUCTIONS_MAX] = {0};
 
 
+// Index bits of the PIO irq/wait irq instruction encoding
+const uint16_t PIO_IRQ_INDEX_MASK = 0x7u;
+
+uint16_t PULSE_IRQ_INSTRUCTIONS[PULSES_MAX][sizeof(sequencer_pio_pulser_irq_program_instructions) / sizeof(uint16_t)];
+
+// Read addresses of the sequence table entries, in the order the control DMA
+// channel hands them to the data channel. A single step repeats the selected
+// entry until the step is rewritten.
+static volatile uint32_t __attribute__((aligned(PULSE_SEQUENCE_STEPS_MAX * sizeof(uint32_t)))) PULSE_SEQUENCE_STEPS[PULSES_MAX][PULSE_SEQUENCE_STEPS_MAX];
+
+// Instruction variants of a scan, every point has a copy with the marker
+// outputs for its first sequence and a plain copy for the other sequences.
+// Each copy is aligned for the DMA read ring.
+static uint32_t __attribute__((aligned(PULSE_INSTRUCTIONS_MAX * sizeof(uint32_t)))) PULSE_SCAN_INSTRUCTIONS[PULSES_MAX][2 * PULSE_SCAN_POINTS_MAX][PULSE_INSTRUCTIONS_MAX];
+
+// DMA control blocks of a scan, written into the alias 1 registers (ctrl,
+// read, write, transfer count trigger) of the data channel one at a time
+struct pulse_scan_block
+{
+    uint32_t ctrl;
+    uint32_t read_addr;
+    uint32_t write_addr;
+    uint32_t transfer_count;
+};
+
+static struct pulse_scan_block PULSE_SCAN_BLOCKS[PULSES_MAX][2 * PULSE_SCAN_POINTS_MAX];
+
+
+const pio_program_t* sequencer_program_output_get(
+    struct pulse_config* config,
+    pio_program_t* program_irq
+) {
+    if (config -> instruction_format == PULSE_FORMAT_EXTENDED)
+    {
+        return &sequencer_pio_pulser_extended_program;
+    }
+
+    if (config -> instruction_format == PULSE_FORMAT_PACKED)
+    {
+        return &sequencer_pio_pulser_packed_program;
+    }
+
+    if (config -> instruction_format == PULSE_FORMAT_FAST)
+    {
+        return &sequencer_pio_pulser_fast_program;
+    }
+
+    if (config -> input_source != PULSE_INPUT_CLOCK_IRQ)
+    {
+        return &sequencer_pio_pulser_program;
+    }
+
+    uint16_t* instructions = PULSE_IRQ_INSTRUCTIONS[config -> sm];
+
+    for (uint32_t i = 0; i < sequencer_pio_pulser_irq_program.length; i++)
+    {
+        instructions[i] = sequencer_pio_pulser_irq_program_instructions[i];
+    }
+
+    /* Note:
+       The clock state machine i raises the IRQ flag i of its PIO block, so
+       the flag index of the clear and wait instructions is patched to the
+       clock id before loading. The prev index mode bits are kept.
+    */
+    const uint32_t IRQ_PATCH_OFFSETS[] = {
+        sequencer_pio_pulser_irq_offset_output_wait,
+        sequencer_pio_pulser_irq_offset_output_wait_irq
+    };
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        uint16_t* instruction = &instructions[IRQ_PATCH_OFFSETS[i]];
+        *instruction = (*instruction & ~PIO_IRQ_INDEX_MASK) | (uint16_t) config -> clock_irq;
+    }
+
+    *program_irq = sequencer_pio_pulser_irq_program;
+    program_irq -> instructions = instructions;
+
+    return program_irq;
+}
+
+
 uint sequencer_program_output_add(
-    PIO pio_clock
+    struct pulse_config* config
 ) {
+    pio_program_t program_irq;
+
     return pio_add_program(
-        pio_clock,
-        &sequencer_pio_pulser_program
+        config -> pio,
+        sequencer_program_output_get(
+            config,
+            &program_irq
+        )
     );
 }
 
 
+// Check if the program of a pulse sequencer can be loaded
+bool sequencer_program_output_fits(
+    struct pulse_config* config
+) {
+    pio_program_t program_irq;
+
+    return pio_can_add_program(
+        config -> pio,
+        sequencer_program_output_get(
+            config,
+            &program_irq
+        )
+    );
+}
+
+
+// Check that the programs of all active pulse sequencers fit into the PIO
+// instruction memory together. Every pulse sequencer loads its own copy.
+bool sequencer_output_programs_validate(
+    struct pulse_config* config_array
+) {
+    uint32_t length = 0;
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        pio_program_t program_irq;
+
+        if (config_array[i].active == false)
+        {
+            continue;
+        }
+
+        length += sequencer_program_output_get(
+            &config_array[i],
+            &program_irq
+        ) -> length;
+    }
+
+    return length <= PIO_INSTRUCTION_COUNT;
+}
+
+
 void sequencer_program_ouput_remove(
-    PIO pio_clock, 
-    uint offset
+    struct pulse_config* config
 ) {
+    pio_program_t program_irq;
+
     pio_remove_program(
-        pio_clock,
-        &sequencer_pio_pulser_program,
-        offset
+        config -> pio,
+        sequencer_program_output_get(
+            config,
+            &program_irq
+        ),
+        config -> program_offset
     );
 }
 
@@ -48,8 +187,31 @@ void sequencer_output_init(
         config_array[i].dma_chan = i;
         config_array[i].program_offset = 0;
         config_array[i].clock_pin = INTERNAL_CLOCK_PINS[0]; // Default to all using the same internal pin
+        config_array[i].input_source = PULSE_INPUT_CLOCK;
+        config_array[i].clock_irq = 0;
         config_array[i].clock_divider = CLOCK_DIV_DEFAULT;
+        config_array[i].clock_divider_frac = 0;
         config_array[i].unit_offset = PULSE_UNITS_OFFSET_DEFAULT;
+        config_array[i].instruction_format = PULSE_FORMAT_STANDARD;
+        config_array[i].instruction_words = PULSE_INSTRUCTIONS_MAX;
+        config_array[i].dma_chan_repeat = -1;
+        config_array[i].linear_offset = 0;
+        config_array[i].linear_words = 0;
+        config_array[i].repeat_offset = 0;
+        config_array[i].repeat_words = 0;
+        config_array[i].repeat_count = 0;
+        config_array[i].input_latency = PULSE_LATENCY_NONE;
+        config_array[i].sequences_stored = 0;
+        config_array[i].sequence_mode = PULSE_SEQUENCE_OFF;
+        config_array[i].sequence_select = 0;
+        config_array[i].sequence_steps[0] = 0;
+        config_array[i].sequence_step_count = 1;
+        config_array[i].scan_state = 0;
+        config_array[i].scan_start = 0;
+        config_array[i].scan_step = 0;
+        config_array[i].scan_points = 0;
+        config_array[i].scan_triggers = 1;
+        config_array[i].scan_marker = 0;
         config_array[i].active = false;
         config_array[i].configured = false;
     }
@@ -75,6 +237,93 @@ void  sequencer_output_insert_instructions(
 }
 
 
+// Get all output pins a set of instructions drives, based on its format
+static uint32_t sequencer_output_instructions_state_mask_get(
+    const uint32_t instructions[PULSE_INSTRUCTIONS_MAX],
+    uint32_t instruction_format
+) {
+    uint32_t outputs = 0;
+
+    switch (instruction_format)
+    {
+        case PULSE_FORMAT_PACKED:
+        case PULSE_FORMAT_FAST:
+            // Unused words and terminators are zero, so the whole buffer can be used
+            for (uint32_t i = 0; i < PULSE_INSTRUCTIONS_MAX; i++)
+            {
+                outputs |= instructions[i] & ((1u << PULSE_PACKED_STATE_BITS) - 1);
+            }
+            break;
+
+        case PULSE_FORMAT_EXTENDED:
+            for (uint32_t i = 0; i < PULSE_INSTRUCTIONS_OUTPUT_TERM; i += PULSE_EXTENDED_WORDS)
+            {
+                outputs |= instructions[i];
+            }
+            break;
+
+        default:
+            for (uint32_t i = 0; i < PULSE_INSTRUCTIONS_MAX; i += 2)
+            {
+                outputs |= instructions[i];
+            }
+            break;
+    }
+
+    return outputs;
+}
+
+
+// Get all output pins a pulse channel drives, based on its instruction format.
+// With the sequence table in use every stored entry can be streamed.
+uint32_t sequencer_output_state_mask_get(
+    struct pulse_config* config
+) {
+    uint32_t outputs = sequencer_output_instructions_state_mask_get(
+        config -> instructions,
+        config -> instruction_format
+    );
+
+    if (config -> scan_points > 0)
+    {
+        outputs |= config -> scan_marker;
+    }
+
+    if (config -> sequence_mode == PULSE_SEQUENCE_OFF)
+    {
+        return outputs;
+    }
+
+    for (uint32_t i = 0; i < PULSE_SEQUENCES_MAX; i++)
+    {
+        if (config -> sequences_stored & (1u << i))
+        {
+            outputs |= sequencer_output_instructions_state_mask_get(
+                config -> sequences[i].instructions,
+                config -> sequences[i].instruction_format
+            );
+        }
+    }
+
+    return outputs;
+}
+
+
+// Get terminating word i of a fast sequence. The fast pulser has no wait
+// instructions of its own, so a sequence starts with waiting for the falling
+// and then the rising edge of the input. The delay of the second wait keeps
+// the input latency of the standard pulser.
+uint32_t sequencer_output_fast_term_get(
+    uint32_t index
+) {
+    const uint32_t instruction = (index == 0)
+        ? pio_encode_wait_pin(false, 0)
+        : pio_encode_wait_pin(true, 0) | pio_encode_delay(PULSE_FAST_WAIT_DELAY);
+
+    return instruction << PULSE_PACKED_STATE_BITS;
+}
+
+
 void sequencer_output_config_reset(
     struct pulse_config* config
 ) {
@@ -84,8 +333,30 @@ void sequencer_output_config_reset(
     );
 
     config -> clock_pin = INTERNAL_CLOCK_PINS[0];
+    config -> input_source = PULSE_INPUT_CLOCK;
+    config -> clock_irq = 0;
     config -> clock_divider = CLOCK_DIV_DEFAULT;
+    config -> clock_divider_frac = 0;
     config -> unit_offset = PULSE_UNITS_OFFSET_DEFAULT;
+    config -> instruction_format = PULSE_FORMAT_STANDARD;
+    config -> instruction_words = PULSE_INSTRUCTIONS_MAX;
+    config -> linear_offset = 0;
+    config -> linear_words = 0;
+    config -> repeat_offset = 0;
+    config -> repeat_words = 0;
+    config -> repeat_count = 0;
+    config -> input_latency = PULSE_LATENCY_NONE;
+    config -> sequences_stored = 0;
+    config -> sequence_mode = PULSE_SEQUENCE_OFF;
+    config -> sequence_select = 0;
+    config -> sequence_steps[0] = 0;
+    config -> sequence_step_count = 1;
+    config -> scan_state = 0;
+    config -> scan_start = 0;
+    config -> scan_step = 0;
+    config -> scan_points = 0;
+    config -> scan_triggers = 1;
+    config -> scan_marker = 0;
     config -> active = false;
 }
 
@@ -93,7 +364,8 @@ void sequencer_output_config_reset(
 void sequencer_output_dma_configure(
     struct pulse_config* config
 ) {
-    const uint RING_BUFF_SIZE_POWER = (uint) log2(PULSE_INSTRUCTIONS_MAX * 4);
+    // Packed sequences only loop over the used part of the instruction buffer
+    const uint RING_BUFF_SIZE_POWER = (uint) log2(config -> instruction_words * 4);
 
     config -> dma_chan = dma_claim_unused_channel(true);
     
@@ -137,13 +409,409 @@ void sequencer_output_dma_configure(
 }
 
 
+// Configure the two DMA channels of a sequence with a repeat block. The
+// linear channel streams the pads, the terminator and the prefix states, then
+// chains to the repeat channel, which loops over the repeat block ring
+// repeat_count times and chains back. Both reads are rings that end where they
+// started, so the channels ping-pong without processor intervention.
+void sequencer_output_dma_repeat_configure(
+    struct pulse_config* config
+) {
+    const uint LINEAR_RING_SIZE_POWER = (uint) log2(config -> linear_words * 4);
+    const uint REPEAT_RING_SIZE_POWER = (uint) log2(config -> repeat_words * 4);
+
+    config -> dma_chan = dma_claim_unused_channel(true);
+    config -> dma_chan_repeat = dma_claim_unused_channel(true);
+
+    dma_channel_config linear_config = dma_channel_get_default_config(config -> dma_chan);
+    dma_channel_config repeat_config = dma_channel_get_default_config(config -> dma_chan_repeat);
+
+    dma_channel_config* dma_configs[] = {&linear_config, &repeat_config};
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        // Enable read increment and disable write increment
+        channel_config_set_read_increment(dma_configs[i], true);
+        channel_config_set_write_increment(dma_configs[i], false);
+
+        channel_config_set_transfer_data_size(
+            dma_configs[i],
+            DMA_SIZE_32
+        );
+
+        channel_config_set_dreq(
+            dma_configs[i],
+            pio_get_dreq(
+                config -> pio,
+                config -> sm,
+                true
+            )
+        );
+    }
+
+    channel_config_set_ring(
+        &linear_config,
+        false,
+        LINEAR_RING_SIZE_POWER
+    );
+
+    channel_config_set_ring(
+        &repeat_config,
+        false,
+        REPEAT_RING_SIZE_POWER
+    );
+
+    channel_config_set_chain_to(
+        &linear_config,
+        config -> dma_chan_repeat
+    );
+
+    channel_config_set_chain_to(
+        &repeat_config,
+        config -> dma_chan
+    );
+
+    // Configure the repeat channel first, it is only started by the chain
+    dma_channel_configure(
+        config -> dma_chan_repeat,
+        &repeat_config,
+        &config -> pio->txf[config -> sm],
+        &config -> instructions[config -> repeat_offset],
+        config -> repeat_words * config -> repeat_count,
+        false
+    );
+
+    dma_channel_configure(
+        config -> dma_chan,
+        &linear_config,
+        &config -> pio->txf[config -> sm],
+        &config -> instructions[config -> linear_offset],
+        config -> linear_words,
+        true // Start transfers immediately
+    );
+}
+
+
+// Configure the two DMA channels of a sequence table. The data channel streams
+// one stored entry and chains to the control channel, which writes the next
+// step of PULSE_SEQUENCE_STEPS into the read address trigger alias of the data
+// channel. Entries are switched by re-pointing the data channel right at the
+// sequence boundary, the transmit FIFO keeps the output gapless.
+void sequencer_output_dma_sequence_configure(
+    struct pulse_config* config
+) {
+    volatile uint32_t* steps = PULSE_SEQUENCE_STEPS[config -> sm];
+
+    // Bus and external selection use a single step that is rewritten live
+    const uint32_t step_count = (config -> sequence_mode == PULSE_SEQUENCE_LIST)
+        ? config -> sequence_step_count
+        : 1;
+
+    for (uint32_t i = 0; i < step_count; i++)
+    {
+        const uint32_t entry = (config -> sequence_mode == PULSE_SEQUENCE_LIST)
+            ? config -> sequence_steps[i]
+            : config -> sequence_select;
+
+        steps[i] = (uint32_t) (uintptr_t) config -> sequences[entry].instructions;
+    }
+
+    config -> dma_chan = dma_claim_unused_channel(true);
+    config -> dma_chan_repeat = dma_claim_unused_channel(true);
+
+    dma_channel_config data_config = dma_channel_get_default_config(config -> dma_chan);
+    dma_channel_config control_config = dma_channel_get_default_config(config -> dma_chan_repeat);
+
+    // Enable read increment and disable write increment
+    channel_config_set_read_increment(&data_config, true);
+    channel_config_set_write_increment(&data_config, false);
+
+    channel_config_set_transfer_data_size(
+        &data_config,
+        DMA_SIZE_32
+    );
+
+    channel_config_set_dreq(
+        &data_config,
+        pio_get_dreq(
+            config -> pio,
+            config -> sm,
+            true
+        )
+    );
+
+    channel_config_set_chain_to(
+        &data_config,
+        config -> dma_chan_repeat
+    );
+
+    // The control channel is unpaced and walks the step ring, one step per
+    // sequence. Step counts are always a power of two.
+    channel_config_set_read_increment(&control_config, true);
+    channel_config_set_write_increment(&control_config, false);
+
+    channel_config_set_transfer_data_size(
+        &control_config,
+        DMA_SIZE_32
+    );
+
+    channel_config_set_ring(
+        &control_config,
+        false,
+        2 + __builtin_ctz(step_count)
+    );
+
+    // The data channel is only started by the control channel
+    dma_channel_configure(
+        config -> dma_chan,
+        &data_config,
+        &config -> pio->txf[config -> sm],
+        (const void*) (uintptr_t) steps[0],
+        config -> instruction_words,
+        false
+    );
+
+    dma_channel_configure(
+        config -> dma_chan_repeat,
+        &control_config,
+        &dma_hw -> ch[config -> dma_chan].al3_read_addr_trig,
+        steps,
+        1,
+        true // Start transfers immediately
+    );
+}
+
+
+// Select the entry a running bus or external sequence table streams after the
+// current sequence. A single aligned word write, so no locking is needed.
+void sequencer_output_sequence_select(
+    struct pulse_config* config,
+    uint32_t entry
+) {
+    PULSE_SEQUENCE_STEPS[config -> sm][0] = (uint32_t) (uintptr_t) config -> sequences[entry].instructions;
+}
+
+
+// Get the entry selected by the external trigger inputs, trigger input i is
+// bit i of the entry
+uint32_t sequencer_output_sequence_external_get()
+{
+    uint32_t entry = 0;
+
+    for (uint32_t i = 0; i < PULSE_SEQUENCE_SELECT_BITS; i++)
+    {
+        entry |= (uint32_t) gpio_get(EXTERNAL_TRIGGER_PINS[i]) << i;
+    }
+
+    return entry;
+}
+
+
+// Get the word index of the delay of a standard or packed state
+uint32_t sequencer_output_scan_delay_index_get(
+    uint32_t instruction_format,
+    uint32_t state
+) {
+    return (instruction_format == PULSE_FORMAT_PACKED) ? state : 2 * state + 1;
+}
+
+
+// Write the instruction variant of a scan point: the loaded instructions with
+// the swept delay replaced and the marker outputs added to the first state
+static void sequencer_output_scan_variant_write(
+    struct pulse_config* config,
+    uint32_t* instructions,
+    uint32_t cycles,
+    uint32_t marker
+) {
+    const uint32_t index = sequencer_output_scan_delay_index_get(
+        config -> instruction_format,
+        config -> scan_state
+    );
+
+    for (uint32_t i = 0; i < PULSE_INSTRUCTIONS_MAX; i++)
+    {
+        instructions[i] = config -> instructions[i];
+    }
+
+    if (config -> instruction_format == PULSE_FORMAT_PACKED)
+    {
+        const uint32_t OUTPUT_MASK = (1u << PULSE_PACKED_STATE_BITS) - 1;
+
+        instructions[index] = (instructions[index] & OUTPUT_MASK) |
+            ((cycles - PULSE_INSTRUCTION_OFFSET) << PULSE_PACKED_STATE_BITS);
+    }
+    else
+    {
+        instructions[index] = cycles - PULSE_INSTRUCTION_OFFSET;
+    }
+
+    // The outputs of the first state are in the first word for both formats
+    instructions[0] |= marker;
+}
+
+
+// Pre-compute the instruction variants and DMA control blocks of a scan.
+// Returns the number of control blocks.
+static uint32_t sequencer_output_scan_prepare(
+    struct pulse_config* config,
+    dma_channel_config* data_config
+) {
+    uint32_t (*variants)[PULSE_INSTRUCTIONS_MAX] = PULSE_SCAN_INSTRUCTIONS[config -> sm];
+    struct pulse_scan_block* blocks = PULSE_SCAN_BLOCKS[config -> sm];
+    uint32_t block_count = 0;
+
+    // The marker copy covers the first sequence of a point, the plain copy
+    // all sequences after it
+    const uint32_t sequences[] = {1, config -> scan_triggers - 1};
+
+    for (uint32_t point = 0; point < config -> scan_points; point++)
+    {
+        const uint32_t cycles = config -> scan_start + point * config -> scan_step;
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if (sequences[i] == 0)
+            {
+                continue;
+            }
+
+            uint32_t* instructions = variants[2 * point + i];
+
+            sequencer_output_scan_variant_write(
+                config,
+                instructions,
+                cycles,
+                (i == 0) ? config -> scan_marker : 0
+            );
+
+            blocks[block_count].ctrl = channel_config_get_ctrl_value(data_config);
+            blocks[block_count].read_addr = (uint32_t) (uintptr_t) instructions;
+            blocks[block_count].write_addr = (uint32_t) (uintptr_t) &config -> pio->txf[config -> sm];
+            blocks[block_count].transfer_count = config -> instruction_words * sequences[i];
+            block_count++;
+        }
+    }
+
+    // The last block chains to itself, which ends the scan
+    channel_config_set_chain_to(
+        data_config,
+        config -> dma_chan
+    );
+
+    blocks[block_count - 1].ctrl = channel_config_get_ctrl_value(data_config);
+
+    return block_count;
+}
+
+
+// Configure the two DMA channels of a scan. The control channel writes one
+// control block into the data channel and triggers it. The data channel
+// streams the instruction variant of the block through a read ring for the
+// sequences of the block, then chains back to the control channel for the
+// next block. A whole scan runs without processor intervention.
+void sequencer_output_dma_scan_configure(
+    struct pulse_config* config
+) {
+    const uint RING_BUFF_SIZE_POWER = (uint) log2(config -> instruction_words * 4);
+
+    config -> dma_chan = dma_claim_unused_channel(true);
+    config -> dma_chan_repeat = dma_claim_unused_channel(true);
+
+    dma_channel_config data_config = dma_channel_get_default_config(config -> dma_chan);
+    dma_channel_config control_config = dma_channel_get_default_config(config -> dma_chan_repeat);
+
+    // Enable read increment and disable write increment
+    channel_config_set_read_increment(&data_config, true);
+    channel_config_set_write_increment(&data_config, false);
+
+    channel_config_set_transfer_data_size(
+        &data_config,
+        DMA_SIZE_32
+    );
+
+    channel_config_set_dreq(
+        &data_config,
+        pio_get_dreq(
+            config -> pio,
+            config -> sm,
+            true
+        )
+    );
+
+    channel_config_set_ring(
+        &data_config,
+        false,
+        RING_BUFF_SIZE_POWER
+    );
+
+    channel_config_set_chain_to(
+        &data_config,
+        config -> dma_chan_repeat
+    );
+
+    sequencer_output_scan_prepare(
+        config,
+        &data_config
+    );
+
+    // The control channel is unpaced, its writes wrap around the four alias 1
+    // registers of the data channel
+    channel_config_set_read_increment(&control_config, true);
+    channel_config_set_write_increment(&control_config, true);
+
+    channel_config_set_transfer_data_size(
+        &control_config,
+        DMA_SIZE_32
+    );
+
+    channel_config_set_ring(
+        &control_config,
+        true,
+        4 // log2(sizeof(struct pulse_scan_block))
+    );
+
+    dma_channel_configure(
+        config -> dma_chan_repeat,
+        &control_config,
+        &dma_hw -> ch[config -> dma_chan].al1_ctrl,
+        PULSE_SCAN_BLOCKS[config -> sm],
+        sizeof(struct pulse_scan_block) / sizeof(uint32_t),
+        true // Start transfers immediately
+    );
+}
+
+
+// Get the point a running scan is at from the control blocks the control
+// channel has read so far
+uint32_t sequencer_output_scan_point_get(
+    const struct pulse_config* config
+) {
+    const uint32_t blocks_base = (uint32_t) (uintptr_t) PULSE_SCAN_BLOCKS[config -> sm];
+    const uint32_t blocks_read = (dma_channel_hw_addr(config -> dma_chan_repeat) -> read_addr - blocks_base) /
+        sizeof(struct pulse_scan_block);
+
+    const uint32_t blocks_per_point = (config -> scan_triggers > 1) ? 2 : 1;
+
+    if (blocks_read == 0)
+    {
+        return 0;
+    }
+
+    return (blocks_read - 1) / blocks_per_point;
+}
+
+
 void sequencer_output_sm_helper_init(
     PIO pio, uint sm, 
     uint offset, 
     uint pin_out_base,
     uint pin_out_count,
     uint pin_trig, 
-    uint clock_divider
+    uint32_t input_source,
+    uint32_t instruction_format,
+    uint clock_divider,
+    uint clock_divider_frac
 ) {
     assert(clock_divider < 65535);
 
@@ -164,6 +832,23 @@ void sequencer_output_sm_helper_init(
     // Get config for pio state machine
 	pio_sm_config config = sequencer_pio_pulser_program_get_default_config(offset);
 
+    if (instruction_format == PULSE_FORMAT_EXTENDED)
+    {
+        config = sequencer_pio_pulser_extended_program_get_default_config(offset);
+    }
+    else if (instruction_format == PULSE_FORMAT_PACKED)
+    {
+        config = sequencer_pio_pulser_packed_program_get_default_config(offset);
+    }
+    else if (instruction_format == PULSE_FORMAT_FAST)
+    {
+        config = sequencer_pio_pulser_fast_program_get_default_config(offset);
+    }
+    else if (input_source == PULSE_INPUT_CLOCK_IRQ)
+    {
+        config = sequencer_pio_pulser_irq_program_get_default_config(offset);
+    }
+
     // Set output pins of config to output pins
 	sm_config_set_out_pins(
         &config,
@@ -174,7 +859,21 @@ void sequencer_output_sm_helper_init(
     /* Note:
        The GPIO clock trigger pins would be already initialized by the
        clock PIO programs. DO NOT RECONFIGURE PIN DIRCTIONS!!!
+       External trigger pins are only read, so they are initialized here in
+       case no clock program listens to the same pin. IRQ listeners do not
+       read the input pin at all.
     */
+    if (input_source == PULSE_INPUT_EXTERNAL)
+    {
+        pio_gpio_init(pio, pin_trig);
+
+        pio_sm_set_consecutive_pindirs(
+            pio, sm,
+            pin_trig,
+            1, // only one pin is used
+            false // input direction
+        );
+    }
     
     // Set clock trigger pins of config to input pins
     sm_config_set_in_pins(
@@ -182,12 +881,12 @@ void sequencer_output_sm_helper_init(
         pin_trig
     );
 
-    // Setup autopull for 32 bit words
+    // Setup autopull for 32 bit words. Fast states only use the low 24 bits.
     sm_config_set_out_shift(
         &config, 
         true, 
         true, 
-        32
+        (instruction_format == PULSE_FORMAT_FAST) ? 24 : 32
     );
 
     // Combine read and transmit FIFO to increase performance
@@ -196,10 +895,11 @@ void sequencer_output_sm_helper_init(
         PIO_FIFO_JOIN_TX
     );
 
-    // Setup clock clock divider
-    sm_config_set_clkdiv(
+    // Setup clock clock divider (16.8 fixed point)
+    sm_config_set_clkdiv_int_frac8(
         &config,
-        (float) clock_divider
+        clock_divider,
+        clock_divider_frac
     );
 
     pio_sm_init(
@@ -215,6 +915,13 @@ void sequencer_output_sm_helper_init(
 void sequencer_output_sm_config(
     struct pulse_config* config
 ) {
+    // Loading a program that doesn't fit panics, so leave the pulse
+    // sequencer unconfigured instead and let the arm request fail
+    if (!sequencer_program_output_fits(config))
+    {
+        return;
+    }
+
     // Claim unused state machine memory
     pio_claim_sm_mask(
         config -> pio,
@@ -223,7 +930,7 @@ void sequencer_output_sm_config(
 
     // Claim unused PIO memory
     config -> program_offset = sequencer_program_output_add(
-        config -> pio
+        config
     );
 
     // Make sure the state machine is disabled
@@ -246,12 +953,81 @@ void sequencer_output_sm_config(
         OUTPUT_PIN_BASE,
         OUTPUT_PIN_COUNT,
         config -> clock_pin,
-        config -> clock_divider
+        config -> input_source,
+        config -> instruction_format,
+        config -> clock_divider,
+        config -> clock_divider_frac
     );
 
-    sequencer_output_dma_configure(
-        config
-    );
+    // The extended pulser reloads its delay block length from the ISR. The
+    // preload leaves the OSR full, so empty it before the DMA starts.
+    if (config -> instruction_format == PULSE_FORMAT_EXTENDED)
+    {
+        sequencer_clock_sm_register_preload(
+            config -> pio,
+            config -> sm,
+            pio_isr,
+            PULSE_EXTENDED_BLOCK_LOOPS
+        );
+
+        pio_sm_exec(
+            config -> pio,
+            config -> sm,
+            pio_encode_out(pio_null, 32)
+        );
+    }
+
+    // The linear DMA segment of a repeat sequence starts with the terminator,
+    // so start at the first output instead of waiting for the input
+    if (config -> repeat_count > 0)
+    {
+        const uint32_t output_start = (config -> input_source == PULSE_INPUT_CLOCK_IRQ)
+            ? sequencer_pio_pulser_irq_offset_output_start
+            : (config -> instruction_format == PULSE_FORMAT_PACKED)
+                ? sequencer_pio_pulser_packed_offset_output_start
+                : sequencer_pio_pulser_offset_output_start;
+
+        pio_sm_exec(
+            config -> pio,
+            config -> sm,
+            pio_encode_jmp(config -> program_offset + output_start)
+        );
+
+        sequencer_output_dma_repeat_configure(
+            config
+        );
+    }
+    else if (config -> scan_points > 0)
+    {
+        sequencer_output_dma_scan_configure(
+            config
+        );
+    }
+    else if (config -> sequence_mode != PULSE_SEQUENCE_OFF)
+    {
+        // Select inputs that no program claimed still need their pads set up
+        if (config -> sequence_mode == PULSE_SEQUENCE_EXTERNAL)
+        {
+            for (uint32_t i = 0; i < PULSE_SEQUENCE_SELECT_BITS; i++)
+            {
+                if (gpio_get_function(EXTERNAL_TRIGGER_PINS[i]) == GPIO_FUNC_NULL)
+                {
+                    gpio_init(EXTERNAL_TRIGGER_PINS[i]);
+                    gpio_set_dir(EXTERNAL_TRIGGER_PINS[i], false);
+                }
+            }
+        }
+
+        sequencer_output_dma_sequence_configure(
+            config
+        );
+    }
+    else
+    {
+        sequencer_output_dma_configure(
+            config
+        );
+    }
 
     config -> configured = true;
 }
@@ -260,6 +1036,29 @@ void sequencer_output_sm_config(
 void sequencer_output_dma_free(
     struct pulse_config* config
 ) { 
+    // The repeat channels chain to each other. Cleanup breaks the chain
+    // before aborting, so neither channel restarts the other.
+    if (config -> dma_chan_repeat >= 0)
+    {
+        dma_channel_cleanup(
+            config -> dma_chan_repeat
+        );
+
+        dma_channel_cleanup(
+            config -> dma_chan
+        );
+
+        dma_channel_abort(
+            config -> dma_chan_repeat
+        );
+
+        dma_channel_unclaim(
+            config -> dma_chan_repeat
+        );
+
+        config -> dma_chan_repeat = -1;
+    }
+
     dma_channel_abort(
         config -> dma_chan
     );
@@ -311,8 +1110,7 @@ void sequencer_output_sm_free(
 
     // Unclaim PIO memory
     sequencer_program_ouput_remove(
-        config -> pio,
-        config -> program_offset
+        config
     );
 }
 
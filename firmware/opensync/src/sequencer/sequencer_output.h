@@ -8,13 +8,25 @@
 #include "sequencer_common.h"
 
 
+const pio_program_t* sequencer_program_output_get(
+    struct pulse_config* config,
+    pio_program_t* program_irq
+);
+
 uint sequencer_program_output_add(
-    PIO pio_clock
+    struct pulse_config* config
+);
+
+bool sequencer_program_output_fits(
+    struct pulse_config* config
+);
+
+bool sequencer_output_programs_validate(
+    struct pulse_config* config_array
 );
 
 void sequencer_program_ouput_remove(
-    PIO pio_clock, 
-    uint offset
+    struct pulse_config* config
 );
 
 void sequencer_output_init(
@@ -32,6 +44,14 @@ void sequencer_output_insert_instructions(
     uint32_t instructions[PULSE_INSTRUCTIONS_MAX]
 );
 
+uint32_t sequencer_output_state_mask_get(
+    struct pulse_config* config
+);
+
+uint32_t sequencer_output_fast_term_get(
+    uint32_t index
+);
+
 void sequencer_output_config_reset(
     struct pulse_config* config
 );
@@ -40,13 +60,44 @@ void sequencer_output_dma_configure(
     struct pulse_config* config
 );
 
+void sequencer_output_dma_repeat_configure(
+    struct pulse_config* config
+);
+
+void sequencer_output_dma_sequence_configure(
+    struct pulse_config* config
+);
+
+void sequencer_output_sequence_select(
+    struct pulse_config* config,
+    uint32_t entry
+);
+
+uint32_t sequencer_output_sequence_external_get();
+
+uint32_t sequencer_output_scan_delay_index_get(
+    uint32_t instruction_format,
+    uint32_t state
+);
+
+void sequencer_output_dma_scan_configure(
+    struct pulse_config* config
+);
+
+uint32_t sequencer_output_scan_point_get(
+    const struct pulse_config* config
+);
+
 void sequencer_output_sm_helper_init(
     PIO pio, uint sm, 
     uint offset, 
     uint pin_out_base,
     uint pin_out_count,
     uint pin_trig, 
-    uint clock_divider
+    uint32_t input_source,
+    uint32_t instruction_format,
+    uint clock_divider,
+    uint clock_divider_frac
 );
 
 void sequencer_output_sm_config(
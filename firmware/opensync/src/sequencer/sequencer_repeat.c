@@ -0,0 +1,100 @@
+#include "sequencer_repeat.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "structs/pulse_config.h"
+
+
+// Number of words of a sequence with a repeat block. The linear segment holds
+// the prefix states and the terminator, rounded up to a power of two for the
+// DMA ring.
+uint32_t pulse_sequence_repeat_words_get(
+    uint32_t prefix_states,
+    uint32_t repeat_states,
+    uint32_t state_words
+) {
+    uint32_t linear_words = 2;
+
+    while (linear_words < ((prefix_states + 1) * state_words))
+    {
+        linear_words *= 2;
+    }
+
+    return linear_words + repeat_states * state_words;
+}
+
+
+// Find the repeat block that compresses the tail of the sequence the most.
+// Returns the number of words of the layout, or 0 if no repeat block saves
+// words over the plain layout. Only the tail is searched: the sequence ends
+// with the repeat block, a suffix would need a third DMA segment. Blocks are
+// powers of two since the repeat block is a DMA ring.
+uint32_t pulse_sequence_repeat_detect(
+    const uint32_t outputs[PULSE_PACKED_STATES_MAX],
+    const uint64_t state_cycles[PULSE_PACKED_STATES_MAX],
+    uint32_t states_used,
+    uint32_t state_words,
+    uint32_t plain_words,
+    uint32_t* repeat_states,
+    uint32_t* repeat_count
+) {
+    uint32_t words_best = 0;
+
+    for (uint32_t states = 1; (states * 2) <= states_used; states *= 2)
+    {
+        const uint32_t last = states_used - states;
+        uint32_t count = 1;
+
+        // Count the blocks in front of the last block that match it
+        while (((count + 1) * states) <= states_used)
+        {
+            const uint32_t first = states_used - (count + 1) * states;
+            bool match = true;
+
+            for (uint32_t i = 0; i < states; i++)
+            {
+                if ((outputs[first + i] != outputs[last + i]) ||
+                    (state_cycles[first + i] != state_cycles[last + i]))
+                {
+                    match = false;
+                    break;
+                }
+            }
+
+            if (!match)
+            {
+                break;
+            }
+
+            count++;
+        }
+
+        if (count < 2)
+        {
+            continue;
+        }
+
+        // The linear segment always keeps at least one state
+        uint32_t prefix = states_used - states * count;
+
+        if (prefix == 0)
+        {
+            prefix = states;
+            count--;
+        }
+
+        const uint32_t words = pulse_sequence_repeat_words_get(prefix, states, state_words);
+
+        if ((words <= PULSE_INSTRUCTIONS_MAX) &&
+            (words < plain_words) &&
+            ((words_best == 0) || (words < words_best)))
+        {
+            words_best = words;
+            *repeat_states = states;
+            *repeat_count = count;
+        }
+    }
+
+    return words_best;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "structs/pulse_config.h"
+
+
+uint32_t pulse_sequence_repeat_words_get(
+    uint32_t prefix_states,
+    uint32_t repeat_states,
+    uint32_t state_words
+);
+
+uint32_t pulse_sequence_repeat_detect(
+    const uint32_t outputs[PULSE_PACKED_STATES_MAX],
+    const uint64_t state_cycles[PULSE_PACKED_STATES_MAX],
+    uint32_t states_used,
+    uint32_t state_words,
+    uint32_t plain_words,
+    uint32_t* repeat_states,
+    uint32_t* repeat_count
+);
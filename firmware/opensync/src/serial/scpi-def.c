@@ -8,10 +8,13 @@
 
 #include "scpi-def.h"
 
+#include "scpi_dispatch.h"
 #include "scpi_system.h"
 #include "scpi_device.h"
 #include "scpi_clock_sequencer.h"
 #include "scpi_pulse_sequencer.h"
+#include "scpi_config.h"
+#include "scpi_macro.h"
 
 static char scpi_input_buffer[SCPI_INPUT_BUFFER_LENGTH];
 
@@ -24,14 +27,23 @@ static bool unique_initialised = false;
 
 const scpi_command_t scpi_commands[] = {
     /* IEEE Mandated Commands (SCPI std V1999.0 4.1.1) */
-    { .pattern = "*CLS", .callback = SCPI_CoreCls,},
+    { .pattern = "*CLS", .callback = SCPI_DeviceCls,},
+    { .pattern = "*DMC", .callback = SCPI_MacroDefine,},
+    { .pattern = "*EMC", .callback = SCPI_MacroEnable,},
+    { .pattern = "*EMC?", .callback = SCPI_MacroEnableQ,},
     { .pattern = "*ESE", .callback = SCPI_CoreEse,},
     { .pattern = "*ESE?", .callback = SCPI_CoreEseQ,},
     { .pattern = "*ESR?", .callback = SCPI_CoreEsrQ,},
+    { .pattern = "*GMC?", .callback = SCPI_MacroGetQ,},
     { .pattern = "*IDN?", .callback = SCPI_CoreIdnQ,},
-    { .pattern = "*OPC", .callback = SCPI_CoreOpc,},
+    { .pattern = "*LMC?", .callback = SCPI_MacroListQ,},
+    { .pattern = "*OPC", .callback = SCPI_DeviceOpc,},
     { .pattern = "*OPC?", .callback = SCPI_CoreOpcQ,},
+    { .pattern = "*PMC", .callback = SCPI_MacroPurge,},
+    { .pattern = "*RCL", .callback = SCPI_ConfigRecall,},
+    { .pattern = "*RMC", .callback = SCPI_MacroRemove,},
     { .pattern = "*RST", .callback = SCPI_CoreRst,},
+    { .pattern = "*SAV", .callback = SCPI_ConfigSave,},
     { .pattern = "*SRE", .callback = SCPI_CoreSre,},
     { .pattern = "*SRE?", .callback = SCPI_CoreSreQ,},
     { .pattern = "*STB?", .callback = SCPI_CoreStbQ,},
@@ -68,10 +80,17 @@ const scpi_command_t scpi_commands[] = {
     /* OpenSync device pulse sequencer settings */
     INSTRUMENT_PULSE_COMMANDS
 
+    /* OpenSync staged configuration */
+    INSTRUMENT_CONFIG_COMMANDS
+
     SCPI_CMD_LIST_END
 };
 
 
+// A response line that is not terminated yet
+static bool scpi_output_open = false;
+
+
 size_t SCPI_Write(
     scpi_t* context, 
     const char* data, 
@@ -79,10 +98,23 @@ size_t SCPI_Write(
 ) {
     (void) context;
 
+    if (len > 0)
+    {
+        scpi_output_open = (data[len - 1] != '\n');
+    }
+
     return fwrite(data, 1, len, stdout);
 }
 
 
+// Check if a response has been started but not terminated, unsolicited
+// messages must not go out in between
+bool scpi_output_open_get()
+{
+    return scpi_output_open;
+}
+
+
 int SCPI_Error(
     scpi_t* context, 
     int_fast16_t err
@@ -98,7 +130,7 @@ scpi_interface_t scpi_interface = {
     .write = SCPI_Write,
     .error = SCPI_Error,
     .reset = SCPI_DeviceReset,            
-    .control = NULL,
+    .control = SCPI_DeviceControl,
     .flush = NULL,
 };
 
@@ -120,4 +152,7 @@ void scpi_instrument_init()
         scpi_input_buffer, SCPI_INPUT_BUFFER_LENGTH,
         scpi_error_queue_data, SCPI_ERROR_QUEUE_SIZE
     );
+
+    // Header lookup through the generated dispatch table
+    scpi_dispatch_init(scpi_commands);
 }
\ No newline at end of file
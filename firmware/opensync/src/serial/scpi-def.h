@@ -1,11 +1,13 @@
 #pragma once
 
+#include <stdbool.h>
 #include "scpi/scpi.h"
 
 #include "version/opensync_version_info.h"
 
 
-#define SCPI_INPUT_BUFFER_LENGTH 256
+// Fits a SYSTem:CONFig:DATA message with its configuration snapshot block
+#define SCPI_INPUT_BUFFER_LENGTH 8192
 #define SCPI_ERROR_QUEUE_SIZE 17
 
 #define SCPI_IDN1 "OpenPIV"
@@ -13,9 +15,21 @@
 #define SCPI_IDN3 NULL
 #define SCPI_IDN4 OPENSYNC_FIRMWARE_VERSION
 
+// Questionable status bits
+#define QUES_TRIGGER_TIMEOUT QUES_USER_DEFINED_0
+
+// Operation status bits
+#define OPER_SCAN_POINT OPER_USER_DEFINED_0
+#define OPER_RUN_COMPLETE OPER_USER_DEFINED_1
+#define OPER_RUN_ABORTED OPER_USER_DEFINED_2
+#define OPER_TRIGGER_TIMEOUT OPER_USER_DEFINED_3
+#define OPER_ARM_COMPLETE OPER_USER_DEFINED_4
+
 extern scpi_interface_t scpi_interface;
 // extern char scpi_input_buffer[];
 extern scpi_error_t scpi_error_queue_data[];
 extern scpi_t scpi_context;
 
-void scpi_instrument_init();
\ No newline at end of file
+void scpi_instrument_init();
+
+bool scpi_output_open_get();
\ No newline at end of file
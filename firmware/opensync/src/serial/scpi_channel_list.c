@@ -0,0 +1,276 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "scpi/scpi.h"
+
+#include "system/core_1.h"
+#include "scpi_common.h"
+#include "scpi_channel_list.h"
+
+
+static int32_t channel_list_id = -1; // STATEFUL outside of a channel list run
+
+
+// Get the channel of the running channel list entry. Returns false (and
+// leaves channel_id untouched) outside of a channel list run.
+bool channel_list_id_get(
+    uint32_t* channel_id
+) {
+    if (channel_list_id == STATEFUL)
+    {
+        return false;
+    }
+
+    *channel_id = (uint32_t) channel_list_id;
+
+    return true;
+}
+
+
+// Check if the parameters of a command contain a channel list at all
+static bool channel_list_present(
+    const lex_state_t* state
+) {
+    const char* end = state->buffer + state->len;
+
+    for (const char* c = state->pos; c + 1 < end; c++)
+    {
+        if ((c[0] == '(') && (c[1] == '@'))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+// Read the channels of a channel list parameter. Returns the number of
+// channels or -1 if an error was pushed.
+static int32_t channel_list_parse(
+    scpi_t* context,
+    scpi_parameter_t* param,
+    channel_validate_t channel_validate,
+    uint32_t channels[CHANNEL_LIST_MAX]
+) {
+    int32_t count = 0;
+
+    for (int index = 0; ; index++)
+    {
+        scpi_bool_t is_range = FALSE;
+        int32_t from = 0;
+        int32_t to = 0;
+        size_t dimensions = 0;
+
+        scpi_expr_result_t result = SCPI_ExprChannelListEntry(
+            context,
+            param,
+            index,
+            &is_range,
+            &from,
+            &to,
+            1, // channels have a single dimension
+            &dimensions
+        );
+
+        if (result == SCPI_EXPR_NO_MORE)
+        {
+            break;
+        }
+
+        if (result != SCPI_EXPR_OK)
+        {
+            return -1;
+        }
+
+        if (!is_range)
+        {
+            to = from;
+        }
+
+        // Ranges may count down, e.g. (@2:0)
+        const int32_t step = (from <= to) ? 1 : -1;
+
+        for (int32_t id = from; ; id += step)
+        {
+            if ((dimensions != 1) || (id < 0) || !channel_validate((uint32_t) id))
+            {
+                SCPI_ErrorPush(
+                    context,
+                    SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+                );
+
+                return -1;
+            }
+
+            if (count == CHANNEL_LIST_MAX)
+            {
+                SCPI_ErrorPush(
+                    context,
+                    SCPI_ERROR_TOO_MUCH_DATA
+                );
+
+                return -1;
+            }
+
+            channels[count++] = (uint32_t) id;
+
+            if (id == to)
+            {
+                break;
+            }
+        }
+    }
+
+    if (count == 0)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return -1;
+    }
+
+    return count;
+}
+
+
+// Read a trailing channel list parameter and cut it from the parameters, so
+// the handler only sees its own. Returns the number of channels, 0 if the
+// last parameter is not a channel list or -1 if an error was pushed.
+static int32_t channel_list_read(
+    scpi_t* context,
+    channel_validate_t channel_validate,
+    uint32_t channels[CHANNEL_LIST_MAX]
+) {
+    lex_state_t* state = &context->param_list.lex_state;
+    char* const pos = state->pos;
+    const int_fast16_t input_count = context->input_count;
+
+    char* list_start = pos;
+    char* param_end = pos;
+    scpi_parameter_t param = {0};
+    scpi_parameter_t last = {0};
+    int32_t count = 0;
+
+    if (!channel_list_present(state))
+    {
+        return 0;
+    }
+
+    // Find the last parameter and where the one before it ends
+    while (SCPI_Parameter(context, &param, FALSE))
+    {
+        list_start = param_end;
+        param_end = state->pos;
+        last = param;
+    }
+
+    if (context->cmd_error)
+    {
+        return -1;
+    }
+
+    if ((last.type == SCPI_TOKEN_PROGRAM_EXPRESSION) &&
+        (last.len > 1) &&
+        (last.ptr[1] == '@'))
+    {
+        int32_t numbers[1] = {STATEFUL};
+
+        count = channel_list_parse(
+            context,
+            &last,
+            channel_validate,
+            channels
+        );
+
+        if (count < 0)
+        {
+            return -1;
+        }
+
+        // The channel list replaces the header suffix, do not take both
+        SCPI_CommandNumbers(
+            context,
+            numbers,
+            1,
+            STATEFUL
+        );
+
+        if (numbers[0] != STATEFUL)
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_INVALID_SUFFIX
+            );
+
+            return -1;
+        }
+
+        state->len = (int) (list_start - state->buffer);
+    }
+
+    // Rewind so the handler reads its parameters from the start
+    state->pos = pos;
+    context->input_count = input_count;
+
+    return count;
+}
+
+
+// Run a per channel handler for every channel of a trailing channel list,
+// or once as usual without one. The list is validated before the first run
+// and the runs stop at the first error, which drops the staged changes of
+// the channels before it, so a list is applied to all channels or none.
+// Query results of all channels end up comma separated in a single response.
+scpi_result_t SCPI_ChannelListRun(
+    scpi_t* context,
+    scpi_command_callback_t callback,
+    channel_validate_t channel_validate
+) {
+    uint32_t channels[CHANNEL_LIST_MAX] = {0};
+    scpi_result_t result = SCPI_RES_OK;
+
+    const int32_t count = channel_list_read(
+        context,
+        channel_validate,
+        channels
+    );
+
+    if (count < 0)
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (count == 0)
+    {
+        return callback(context);
+    }
+
+    lex_state_t* state = &context->param_list.lex_state;
+    char* const pos = state->pos;
+    const int_fast16_t input_count = context->input_count;
+
+    sequencer_config_checkpoint();
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        state->pos = pos;
+        context->input_count = input_count;
+        channel_list_id = (int32_t) channels[i];
+
+        result = callback(context);
+
+        if ((result != SCPI_RES_OK) || context->cmd_error)
+        {
+            sequencer_config_rollback();
+            result = SCPI_RES_ERR;
+            break;
+        }
+    }
+
+    channel_list_id = STATEFUL;
+
+    return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "scpi/scpi.h"
+
+
+#define CHANNEL_LIST_MAX 16
+
+typedef bool (*channel_validate_t)(uint32_t channel_id);
+
+bool channel_list_id_get(
+    uint32_t* channel_id
+);
+
+scpi_result_t SCPI_ChannelListRun(
+    scpi_t* context,
+    scpi_command_callback_t callback,
+    channel_validate_t channel_validate
+);
+
+// <callback>Channels runs a per channel handler once for every channel of a
+// trailing channel list parameter, e.g. "SOURce:CLOCk:MODe FREE,(@0:2)"
+#define SCPI_CHANNEL_LIST_DECLARE(callback) \
+    scpi_result_t callback##Channels(scpi_t* context)
+
+#define SCPI_CHANNEL_LIST_DEFINE(callback, channel_validate) \
+    SCPI_CHANNEL_LIST_DECLARE(callback) \
+    { \
+        return SCPI_ChannelListRun(context, callback, channel_validate); \
+    }
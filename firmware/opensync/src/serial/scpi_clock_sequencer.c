@@ -10,7 +10,11 @@
 #include "system/core_1.h"
 #include "structs/clock_config.h"
 #include "sequencer/sequencer_common.h"
+#include "sequencer/sequencer_clock.h"
+#include "sequencer/sequencer_latency.h"
 #include "scpi_common.h"
+#include "scpi_numeric.h"
+#include "scpi_channel_list.h"
 
 
 enum {
@@ -21,10 +25,11 @@ enum {
     MEGAHERTZ
 };
 
-static double clock_sequence_buffer_freq[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+static struct numeric_value clock_sequence_buffer_freq[CLOCK_INSTRUCTIONS_MAX / 2] = {0}; // converted at APPly, 0 if not set
 static uint32_t clock_sequence_buffer_reps[CLOCK_INSTRUCTIONS_MAX / 2] = {0.0};
 static size_t  clock_sequence_buffer_freqs_read = 0;
 static size_t  clock_sequence_buffer_reps_read = 0;
+static uint64_t clock_sequence_applied_period[CLOCKS_MAX][CLOCK_INSTRUCTIONS_MAX / 2] = {{0}};
 const uint32_t clock_sequence_buffer_size = CLOCK_INSTRUCTIONS_MAX / 2;
 
 // This is used in the INSTructions submodule for stateful operation.
@@ -36,7 +41,7 @@ void clock_sequencer_cache_freq_clear()
 {
     for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
     {
-        clock_sequence_buffer_freq[i] = 0;
+        clock_sequence_buffer_freq[i] = (struct numeric_value) {0};
     }
 
     clock_sequence_buffer_freqs_read = 0;
@@ -99,6 +104,9 @@ bool SCPI_check_clock_id_and_append_error(
         clock_id_res = (uint32_t) numbers[0];
     }
 
+    // A channel list run overrides both
+    channel_list_id_get(&clock_id_res);
+
     // Validate the ID
     if (!clock_id_validate(clock_id_res))
     {
@@ -367,6 +375,95 @@ scpi_result_t SCPI_ClockClockDividerQ(
 }
 
 
+// Set a fractional clock divider (8 fractional bits) at clock sequencer N
+scpi_result_t SCPI_ClockClockDividerValue(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    uint64_t clock_divider_fixed = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Round to the nearest divider the hardware can represent
+    if (!SCPI_ParamFixed(
+        context,
+        &clock_divider_fixed,
+        CLOCK_DIVIDER_FRAC_BITS,
+        UINT32_MAX,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!clock_divider_fixed_validate((uint32_t) clock_divider_fixed))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    bool success = clock_divider_fixed_set(
+        clock_id,
+        (uint32_t) clock_divider_fixed
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the fractional clock divider at clock sequencer N
+scpi_result_t SCPI_ClockClockDividerValueQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    SCPI_ResultDouble(
+        context,
+        config_array[clock_id].clock_divider + (double) config_array[clock_id].clock_divider_frac / (1u << CLOCK_DIVIDER_FRAC_BITS)
+    );
+
+    return SCPI_RES_OK;
+}
+
+
 // Set clock units at clock sequencer N
 scpi_result_t SCPI_ClockeUnits(
     scpi_t* context
@@ -412,16 +509,16 @@ scpi_result_t SCPI_ClockeUnits(
     switch (choice)
     {
         case HERTZ:
-            unit_offset = 1.0;
+            unit_offset = 1;
             break;
         case KILOHERTZ:
-            unit_offset = 1e3;
+            unit_offset = 1000;
             break;
         case MEGAHERTZ:
-            unit_offset = 1e6;
+            unit_offset = 1000000;
             break;
         default: // Default to Hertz
-            unit_offset = 1.0;
+            unit_offset = 1;
     }
 
     // Cast choice into usable clock divider type
@@ -465,12 +562,12 @@ scpi_result_t SCPI_ClockUnitsQ(
     struct clock_config* config_array = sequencer_clock_config_get();
 
     // Get the unit offset of the clock sequencer at clock_id
-    double unit_offset = config_array[clock_id].unit_offset;
+    uint64_t unit_offset = config_array[clock_id].unit_offset;
 
     // Return as double
     SCPI_ResultDouble(
         context,
-        unit_offset
+        (double) unit_offset
     );
     
     return SCPI_RES_OK;
@@ -561,13 +658,13 @@ scpi_result_t SCPI_ClockDataFreq(
     // Clear delay cache
     clock_sequencer_cache_freq_clear();
 
-    // Now get the instruction buffer, if present
-    if (!SCPI_ParamArrayDouble(
+    // Now get the instruction buffer, if present. Values without a unit suffix
+    // take the data units of the clock sequencer they are applied to.
+    if (!SCPI_ParamArrayPeriods(
         context,
         clock_sequence_buffer_freq,
         clock_sequence_buffer_size,
         &clock_sequence_buffer_freqs_read,
-        0, // scpi array format type??
         TRUE
     )) {
         return SCPI_RES_ERR;
@@ -590,9 +687,56 @@ scpi_result_t SCPI_ClockDataFreqQ(
         return SCPI_RES_ERR;
     }
 
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+        config_array[clock_id].clock_divider,
+        config_array[clock_id].clock_divider_frac
+    );
+    const uint64_t unit_offset = config_array[clock_id].unit_offset;
+
+    double freqs[CLOCK_INSTRUCTIONS_MAX / 2] = {0.0};
+
+    // Report the cached entries as frequencies in the current data units,
+    // cycle counts at the current divider. Periods are converted in integer
+    // picoseconds, frequencies are echoed as entered.
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        struct numeric_value* freq = &clock_sequence_buffer_freq[i];
+        uint64_t period = 0;
+        uint64_t cycles = 0;
+
+        switch (freq -> suffix)
+        {
+            case NUMERIC_SUFFIX_TIME:
+                numeric_value_picos_get(freq, unit_offset, &period);
+                break;
+
+            case NUMERIC_SUFFIX_CYCLES:
+                if (numeric_value_cycles_get(freq, CLOCK_CYCLES_MAX, &cycles))
+                {
+                    period = clock_cycles_picos_get(cycles, cycle_nanos_fixed);
+                }
+                break;
+
+            case NUMERIC_SUFFIX_FREQUENCY:
+                freqs[i] = numeric_value_double_get(freq) / unit_offset;
+                break;
+
+            default:
+                freqs[i] = numeric_value_double_get(freq);
+                break;
+        }
+
+        if (period > 0)
+        {
+            freqs[i] = 1e12 / ((double) period * unit_offset);
+        }
+    }
+
     SCPI_ResultArrayDouble(
         context,
-        clock_sequence_buffer_freq,
+        freqs,
         clock_sequence_buffer_size,
         0 // what is scpi array format??
     );
@@ -631,36 +775,211 @@ scpi_result_t SCPI_ClockDataClear(
 }
 
 
-// Set the clock instructions at clock sequencer N
-scpi_result_t SCPI_ClockDataApply(
-    scpi_t* context
+// Get the nearest cycle count for a period at a fixed point cycle length
+bool clock_period_cycles_get(
+    uint64_t period_picos,
+    uint64_t cycle_nanos_fixed,
+    uint32_t* cycles
 ) {
-    // Allocate some variables
-    uint32_t clock_id = 0;
-    uint32_t freq_cycles = 0;
+    const uint64_t cycles_raw = clock_cycles_nearest_get(
+        period_picos,
+        cycle_nanos_fixed
+    );
 
-    uint32_t local_buffer[CLOCK_INSTRUCTIONS_MAX] = {};
-    const uint32_t local_buffer_size = CLOCK_INSTRUCTIONS_MAX;
+    // Check for min cycles due to clock sequencer operations
+    if ((cycles_raw < CLOCK_INSTRUCTION_MIN) ||
+        (cycles_raw > CLOCK_CYCLES_MAX))
+    {
+        return 0;
+    }
 
-    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
-    if (SCPI_check_running_and_append_error(context))
+    *cycles = (uint32_t) cycles_raw;
+
+    return 1;
+}
+
+
+// Convert the cached entries to periods in picoseconds in the data units of
+// clock sequencer N. Cycle counts have no period, they are taken as they are.
+// Entries that are not set are 0 in both.
+static bool clock_sequence_periods_get(
+    uint32_t clock_id,
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2],
+    uint64_t cycles[CLOCK_INSTRUCTIONS_MAX / 2]
+) {
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
     {
-        return SCPI_RES_ERR;
+        struct numeric_value* freq = &clock_sequence_buffer_freq[i];
+
+        periods[i] = 0;
+        cycles[i] = 0;
+
+        const bool success = (freq -> suffix == NUMERIC_SUFFIX_CYCLES) ?
+            numeric_value_cycles_get(freq, CLOCK_CYCLES_MAX, &cycles[i]) :
+            numeric_value_period_picos_get(freq, config_array[clock_id].unit_offset, &periods[i]);
+
+        if (!success ||
+            ((cycles[i] != 0) && (cycles[i] < CLOCK_INSTRUCTION_MIN)))
+        {
+            return 0;
+        }
     }
 
-    // Get clock sequencer ID
-    if (SCPI_check_clock_id_and_append_error(
-        context,
-        &clock_id
-    )) {
-        return SCPI_RES_ERR;
+    return 1;
+}
+
+
+// Get the 128 bit product of two 64 bit values as high and low words
+static void clock_product_get(
+    uint64_t a,
+    uint64_t b,
+    uint64_t* high,
+    uint64_t* low
+) {
+    const uint64_t low_low = (a & UINT32_MAX) * (b & UINT32_MAX);
+    const uint64_t high_low = (a >> 32) * (b & UINT32_MAX);
+    const uint64_t low_high = (a & UINT32_MAX) * (b >> 32);
+    const uint64_t middle = (low_low >> 32) + (high_low & UINT32_MAX) + low_high;
+
+    *low = (middle << 32) | (low_low & UINT32_MAX);
+    *high = (a >> 32) * (b >> 32) + (high_low >> 32) + (middle >> 32);
+}
+
+
+// Check if the relative error error_a / period_a is below error_b / period_b,
+// cross multiplied so nothing is rounded
+static bool clock_error_below(
+    uint64_t error_a,
+    uint64_t period_a,
+    uint64_t error_b,
+    uint64_t period_b
+) {
+    uint64_t a_high = 0;
+    uint64_t a_low = 0;
+    uint64_t b_high = 0;
+    uint64_t b_low = 0;
+
+    clock_product_get(error_a, period_b, &a_high, &a_low);
+    clock_product_get(error_b, period_a, &b_high, &b_low);
+
+    return (a_high < b_high) || ((a_high == b_high) && (a_low < b_low));
+}
+
+
+// Pick the fixed point divider with the lowest worst case frequency error over
+// the given periods. The search starts at the smallest divider that can hold
+// the longest period, larger dividers trade cycle resolution for a better
+// common multiple of the periods.
+bool clock_sequence_divider_solve(
+    const uint64_t* periods,
+    uint32_t* divider_fixed
+) {
+    const uint32_t DIVIDER_SPAN = 16u << CLOCK_DIVIDER_FRAC_BITS;
+    const uint32_t DIVIDER_MAX = CLOCK_DIVIDER_MAX << CLOCK_DIVIDER_FRAC_BITS;
+
+    uint64_t period_max = 0;
+    uint64_t error_best = 0;        // worst case error of the best divider in ps ...
+    uint64_t error_best_period = 0; // ... relative to this period, 0 until one is found
+
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        if (periods[i] > period_max)
+        {
+            period_max = periods[i];
+        }
+    }
+
+    // Smallest divider whose longest delay loop still holds the longest period
+    const uint64_t scale = clock_cycle_fixed_scale_get();
+    const uint64_t loop_picos_max = CLOCK_CYCLES_MAX * clock_cycle_nanos_num_get() * PICOS_PER_NANOSECOND;
+    const uint64_t divider_min_raw = (period_max / loop_picos_max) * scale +
+        ((period_max % loop_picos_max) * scale + loop_picos_max - 1) / loop_picos_max;
+
+    if (divider_min_raw > DIVIDER_MAX)
+    {
+        return 0;
+    }
+
+    uint32_t divider_min = (uint32_t) divider_min_raw;
+
+    if (divider_min < (1u << CLOCK_DIVIDER_FRAC_BITS))
+    {
+        divider_min = 1u << CLOCK_DIVIDER_FRAC_BITS;
+    }
+
+    for (uint32_t divider = divider_min; (divider < divider_min + DIVIDER_SPAN) && (divider <= DIVIDER_MAX); divider++)
+    {
+        const uint64_t cycle_nanos_fixed = (uint64_t) divider * clock_cycle_nanos_num_get();
+        uint64_t error_max = 0;
+        uint64_t error_max_period = 1;
+        bool valid = true;
+
+        for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+        {
+            uint32_t cycles = 0;
+
+            if (periods[i] == 0)
+            {
+                continue;
+            }
+
+            if (!clock_period_cycles_get(periods[i], cycle_nanos_fixed, &cycles))
+            {
+                valid = false;
+                break;
+            }
+
+            const int64_t error = clock_cycles_error_picos_get(
+                periods[i],
+                cycles,
+                cycle_nanos_fixed
+            );
+
+            if (clock_error_below(error_max, error_max_period, (uint64_t) llabs(error), periods[i]))
+            {
+                error_max = (uint64_t) llabs(error);
+                error_max_period = periods[i];
+            }
+        }
+
+        // Ties keep the smaller divider and its finer trigger resolution
+        if (valid &&
+            ((error_best_period == 0) || clock_error_below(error_max, error_max_period, error_best, error_best_period)))
+        {
+            error_best = error_max;
+            error_best_period = error_max_period;
+            *divider_fixed = divider;
+        }
+
+        if ((error_best_period != 0) && (error_best == 0))
+        {
+            break;
+        }
     }
 
+    return error_best_period != 0;
+}
+
+
+// Convert the cached frequencies and counts at the current clock divider and
+// load them into clock sequencer N
+scpi_result_t clock_sequencer_data_apply(
+    scpi_t* context,
+    uint32_t clock_id
+) {
+    uint32_t freq_cycles = 0;
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    uint64_t cycles[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+
+    uint32_t local_buffer[CLOCK_INSTRUCTIONS_MAX] = {};
+
     // Make sure both instruction buffers have read same number of elements
     if (clock_sequence_buffer_freqs_read != clock_sequence_buffer_reps_read)
     {
         SCPI_ErrorPush(
-            context, 
+            context,
             SCPI_ERROR_LISTS_NOT_SAME_LENGTH
         );
 
@@ -670,38 +989,44 @@ scpi_result_t SCPI_ClockDataApply(
     // Now get unit conversion paramerters
     struct clock_config* config_array = sequencer_clock_config_get();
 
-    const double unit_offset = config_array[clock_id].unit_offset;
-    const uint clock_divider = config_array[clock_id].clock_divider;
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+        config_array[clock_id].clock_divider,
+        config_array[clock_id].clock_divider_frac
+    );
+
+    if (!clock_sequence_periods_get(
+        clock_id,
+        periods,
+        cycles
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
 
     for (uint32_t i = 0, j = 0; i < clock_sequence_buffer_size; i++, j+=2)
     {
         uint32_t reps = clock_sequence_buffer_reps[i];
-        double freq = clock_sequence_buffer_freq[i];
+        const uint64_t period = periods[i];
 
-        if (freq > SEQUENCER_DOUBLE_EPS)
+        // Cycle counts are taken as they are
+        if (cycles[i] > 0)
         {
-            // Convert delay into nanoseconds
-            freq = 1e9 / (freq * unit_offset);
-
-            // Convert nanoseconds to cycles, if possible
-            if (!convert_nanos_to_cycles(
-                (uint64_t) freq, // This truncates decimals similar to floor operation (e.g, 120.5 ns --> 120 ns)
-                clock_divider,
+            freq_cycles = (uint32_t) cycles[i];
+        }
+        else if (period > 0)
+        {
+            // Round to the nearest cycle, if possible
+            if (!clock_period_cycles_get(
+                period,
+                cycle_nanos_fixed,
                 &freq_cycles
             )) {
                 SCPI_ErrorPush(
-                    context, 
-                    SCPI_ERROR_DATA_OUT_OF_RANGE
-                );
-
-                return SCPI_RES_ERR;
-            } 
-
-            // Check for min cycles due to clock sequencer operations
-            if (freq_cycles < CLOCK_INSTRUCTION_MIN)
-            {
-                SCPI_ErrorPush(
-                    context, 
+                    context,
                     SCPI_ERROR_DATA_OUT_OF_RANGE
                 );
 
@@ -733,25 +1058,37 @@ scpi_result_t SCPI_ClockDataApply(
     if (!success)
     {
         SCPI_ErrorPush(
-            context, 
+            context,
             SCPI_ERROR_PARAMETER_ERROR
         );
 
         return SCPI_RES_ERR;
     }
 
+    // Keep the requested periods for the achieved frequency report, cycle
+    // counts have no error
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        clock_sequence_applied_period[clock_id][i] = periods[i];
+    }
+
     return SCPI_RES_OK;
 }
 
 
-// Query instructions at clock sequencer N
-scpi_result_t SCPI_ClockDataQ(
+// Set the clock instructions at clock sequencer N
+scpi_result_t SCPI_ClockDataApply(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t clock_id = 0;
 
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
     // Get clock sequencer ID
     if (SCPI_check_clock_id_and_append_error(
         context,
@@ -760,29 +1097,23 @@ scpi_result_t SCPI_ClockDataQ(
         return SCPI_RES_ERR;
     }
 
-    // Retrieve clock sequencer container
-    struct clock_config* config_array = sequencer_clock_config_get();
-
-    SCPI_ResultArrayUInt32(
+    return clock_sequencer_data_apply(
         context,
-        config_array[clock_id].instructions,
-        CLOCK_INSTRUCTIONS_MAX,
-        0 // what is scpi array format??
+        clock_id
     );
-    
-    return SCPI_RES_OK;
 }
 
 
-// Set clock mode at clock sequencer N
-scpi_result_t SCPI_ClockMode(
+// Pick the fractional clock divider with the lowest frequency error for the
+// cached entries, then apply them to clock sequencer N
+scpi_result_t SCPI_ClockDataSolve(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
-    int32_t choice = 0;
     uint32_t clock_id = 0;
-    uint32_t clock_mode = 1;
+    uint32_t divider_fixed = 0;
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    uint64_t cycles[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
 
     // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
@@ -798,20 +1129,307 @@ scpi_result_t SCPI_ClockMode(
         return SCPI_RES_ERR;
     }
 
-    // Valid clock mode choices
-    const scpi_choice_def_t options[] = {
-        {"INTernal",         CLOCK_SCPI_MODE_FREERUN},
-        {"EXTernal",         CLOCK_SCPI_MODE_SEQUENCER},
-        SCPI_CHOICE_LIST_END
-    };
+    // Cycle counts don't depend on the divider and are left out
+    if (!clock_sequence_periods_get(
+            clock_id,
+            periods,
+            cycles
+        ) ||
+        !clock_sequence_divider_solve(
+            periods,
+            &divider_fixed
+        ))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
 
-    // Now get the clock divider if present
-    if (!SCPI_ParamChoice(
-        context,
-        options,
-        &choice,
-        TRUE
-    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!clock_divider_fixed_set(
+        clock_id,
+        divider_fixed
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return clock_sequencer_data_apply(
+        context,
+        clock_id
+    );
+}
+
+
+// Get the achieved period and its error (requested - achieved) in
+// picoseconds of every applied entry at clock sequencer N, 0 for entries
+// without cycles
+void clock_sequence_achieved_get(
+    uint32_t clock_id,
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2],
+    int64_t errors[CLOCK_INSTRUCTIONS_MAX / 2]
+) {
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+        config_array[clock_id].clock_divider,
+        config_array[clock_id].clock_divider_frac
+    );
+
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        const uint32_t cycles = config_array[clock_id].instructions[2 * i + 1];
+        const uint64_t period_requested = clock_sequence_applied_period[clock_id][i];
+
+        periods[i] = 0;
+        errors[i] = 0;
+
+        if (cycles == 0)
+        {
+            continue;
+        }
+
+        periods[i] = clock_cycles_picos_get(
+            cycles,
+            cycle_nanos_fixed
+        );
+
+        if (period_requested > 0)
+        {
+            errors[i] = (int64_t) period_requested - (int64_t) periods[i];
+        }
+    }
+}
+
+
+// Query the achieved frequencies of the applied entries at clock sequencer N
+scpi_result_t SCPI_ClockDataFreqAchievedQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    int64_t errors[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    double freqs[CLOCK_INSTRUCTIONS_MAX / 2] = {0.0};
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    clock_sequence_achieved_get(
+        clock_id,
+        periods,
+        errors
+    );
+
+    // Only the conversion to the clock units is floating point
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        if (periods[i] > 0)
+        {
+            freqs[i] = 1e12 / ((double) periods[i] * config_array[clock_id].unit_offset);
+        }
+    }
+
+    SCPI_ResultArrayDouble(
+        context,
+        freqs,
+        clock_sequence_buffer_size,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the relative frequency errors (ppm) of the applied entries at clock sequencer N
+scpi_result_t SCPI_ClockDataErrorQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    uint64_t periods[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    int64_t errors[CLOCK_INSTRUCTIONS_MAX / 2] = {0};
+    double errors_ppm[CLOCK_INSTRUCTIONS_MAX / 2] = {0.0};
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    clock_sequence_achieved_get(
+        clock_id,
+        periods,
+        errors
+    );
+
+    // Only the ratio in ppm is floating point
+    for (uint32_t i = 0; i < clock_sequence_buffer_size; i++)
+    {
+        if (periods[i] > 0)
+        {
+            errors_ppm[i] = (double) errors[i] / (double) periods[i] * 1e6;
+        }
+    }
+
+    SCPI_ResultArrayDouble(
+        context,
+        errors_ppm,
+        clock_sequence_buffer_size,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query instructions at clock sequencer N
+scpi_result_t SCPI_ClockDataQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t clock_id = 0;
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve clock sequencer container
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    SCPI_ResultArrayUInt32(
+        context,
+        config_array[clock_id].instructions,
+        CLOCK_INSTRUCTIONS_MAX,
+        0 // what is scpi array format??
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
+// Overwrite single words of the instruction buffer at clock sequencer N,
+// given as index and value pairs. Either all pairs are applied or none.
+scpi_result_t SCPI_ClockDataPatch(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    uint32_t indices[CLOCK_INSTRUCTIONS_MAX] = {0};
+    uint32_t values[CLOCK_INSTRUCTIONS_MAX] = {0};
+    uint32_t pairs = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamPatchPairs(
+        context,
+        indices,
+        values,
+        CLOCK_INSTRUCTIONS_MAX,
+        &pairs
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Check every cycle word before touching the buffer
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        if ((indices[i] % 2 == 1) &&
+            (values[i] != 0) &&
+            ((values[i] < CLOCK_INSTRUCTION_MIN) || (values[i] > CLOCK_CYCLES_MAX)))
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+    }
+
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        clock_instruction_patch(
+            clock_id,
+            indices[i],
+            values[i]
+        );
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Set clock mode at clock sequencer N
+scpi_result_t SCPI_ClockMode(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    int32_t choice = 0;
+    uint32_t clock_id = 0;
+    uint32_t clock_mode = 1;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Valid clock mode choices
+    const scpi_choice_def_t options[] = {
+        {"INTernal",         CLOCK_SCPI_MODE_FREERUN},
+        {"EXTernal",         CLOCK_SCPI_MODE_SEQUENCER},
+        SCPI_CHOICE_LIST_END
+    };
+
+    // Now get the clock divider if present
+    if (!SCPI_ParamChoice(
+        context,
+        options,
+        &choice,
+        TRUE
+    )) {
         return SCPI_RES_ERR;
     }
 
@@ -898,6 +1516,7 @@ scpi_result_t SCPI_TriggerMode(
         {"IMMediate",   CLOCK_TRIG_SOURCE_IMMEDIATE},
         {"EDGE",        CLOCK_TRIG_SOURCE_EDGE},
         {"GATE",        CLOCK_TRIG_SOURCE_GATE},
+        {"MASK",        CLOCK_TRIG_SOURCE_MASK},
         SCPI_CHOICE_LIST_END
     };
 
@@ -1155,7 +1774,9 @@ scpi_result_t SCPI_TriggerLevelQ(
 }
 
 
-// Set trigger pin at clock sequencer N
+// Set trigger inputs at clock sequencer N.
+// One or two trigger input IDs can be given. With two inputs, the first input
+// is input A and the second input is input B of the trigger logic.
 scpi_result_t SCPI_TriggerPin(
     scpi_t* context
 ) {
@@ -1163,7 +1784,8 @@ scpi_result_t SCPI_TriggerPin(
     int32_t numbers[1] = {0};
     uint32_t clock_id = 0;
     uint32_t param = 0;
-    uint trigger_pin_id = 0;
+    uint32_t trigger_pin_ids[CLOCK_TRIGGER_INPUTS_MAX] = {0};
+    uint32_t trigger_inputs = 0;
 
     // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
@@ -1179,16 +1801,42 @@ scpi_result_t SCPI_TriggerPin(
         return SCPI_RES_ERR;
     }
 
-    // Now get the trigger pin if present
-    if (!SCPI_ParamUInt32(context, &param, TRUE))
+    // Now get the trigger inputs if present (first one is mandatory)
+    while (trigger_inputs < CLOCK_TRIGGER_INPUTS_MAX)
     {
-        return SCPI_RES_ERR;
+        if (!SCPI_ParamUInt32(context, &param, trigger_inputs == 0))
+        {
+            if (SCPI_ParamErrorOccurred(context))
+            {
+                return SCPI_RES_ERR;
+            }
+
+            break;
+        }
+
+        // Validate the ID
+        if (!trigger_id_validate(param))
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_PARAMETER_ERROR
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        trigger_pin_ids[trigger_inputs] = param;
+        trigger_inputs++;
     }
 
-    trigger_pin_id = (uint) param;
+    bool success = trigger_pins_set(
+        clock_id,
+        trigger_pin_ids,
+        trigger_inputs
+    );
 
-    // Validate the ID
-    if (!trigger_id_validate(trigger_pin_id))
+    // If for some wierd reason we failed, raise an error
+    if (!success)
     {
         SCPI_ErrorPush(
             context, 
@@ -1198,9 +1846,102 @@ scpi_result_t SCPI_TriggerPin(
         return SCPI_RES_ERR;
     }
 
-    bool success = trigger_pin_set(
+    return SCPI_RES_OK;
+}
+
+
+// Query trigger inputs at clock sequencer N
+scpi_result_t SCPI_TriggerPinQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t clock_id = 0;
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve clock sequencer container
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    const uint32_t trigger_pins[CLOCK_TRIGGER_INPUTS_MAX] = {
+        config_array[clock_id].trigger_pin,
+        config_array[clock_id].trigger_pin_aux
+    };
+
+    // Return the trigger input IDs of the selected pins
+    for (uint32_t i = 0; i < config_array[clock_id].trigger_inputs; i++)
+    {
+        for (uint32_t j = 0; j < TRIGGERS_MAX; j++)
+        {
+            if (EXTERNAL_TRIGGER_PINS[j] == trigger_pins[i])
+            {
+                SCPI_ResultUInt32(
+                    context,
+                    EXTERNAL_TRIGGER_IDS[j]
+                );
+            }
+        }
+    }
+    
+    return SCPI_RES_OK;
+}
+
+
+// Set trigger input logic at clock sequencer N
+scpi_result_t SCPI_TriggerLogic(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    int32_t choice = 0;
+    uint32_t clock_id = 0;
+    uint32_t trigger_logic = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Valid trigger logic choices
+    const scpi_choice_def_t options[] = {
+        {"SINGle",  CLOCK_TRIG_LOGIC_SINGLE},
+        {"OR",      CLOCK_TRIG_LOGIC_OR},
+        {"AND",     CLOCK_TRIG_LOGIC_AND},
+        {"ARM",     CLOCK_TRIG_LOGIC_ARM},
+        SCPI_CHOICE_LIST_END
+    };
+
+    // Now get the trigger logic if present
+    if (!SCPI_ParamChoice(
+        context,
+        options,
+        &choice,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Cast to usable type
+    trigger_logic = (uint32_t) choice;
+
+    bool success = sequencer_trigger_logic_set(
         clock_id,
-        trigger_pin_id
+        trigger_logic
     );
 
     // If for some wierd reason we failed, raise an error
@@ -1218,8 +1959,8 @@ scpi_result_t SCPI_TriggerPin(
 }
 
 
-// Query clock pin at clock sequencer N
-scpi_result_t SCPI_TriggerPinQ(
+// Query trigger input logic at clock sequencer N
+scpi_result_t SCPI_TriggerLogicQ(
     scpi_t* context
 ) {
     // Allocate some variables
@@ -1237,13 +1978,12 @@ scpi_result_t SCPI_TriggerPinQ(
     // Retrieve clock sequencer container
     struct clock_config* config_array = sequencer_clock_config_get();
 
-    // Get the trigger pin of the trigger sequencer at ckock_id
-    uint32_t trigger_pin = config_array[clock_id].trigger_pin;
+    // Get the trigger logic of the clock sequencer at clock_id
+    uint32_t logic = config_array[clock_id].trigger_logic;
 
-    // Return as uint32
     SCPI_ResultUInt32(
         context,
-        trigger_pin
+        logic
     );
     
     return SCPI_RES_OK;
@@ -1360,12 +2100,12 @@ scpi_result_t SCPI_TriggerUnitsQ(
     struct clock_config* config_array = sequencer_clock_config_get();
 
     // Get the clock divider of the clock sequencer at clock_id
-    double unit_offset = config_array[clock_id].unit_offset_trigger;
+    uint64_t unit_offset = config_array[clock_id].unit_offset_trigger;
 
     // Return as uint32
     SCPI_ResultDouble(
         context,
-        unit_offset
+        (double) unit_offset
     );
     
     return SCPI_RES_OK;
@@ -1462,8 +2202,9 @@ scpi_result_t SCPI_TriggerDelay(
     uint32_t clock_id = 0;
     uint32_t param = 0;
     uint32_t trigger_delay_cycles = 0;
-    double trigger_delay = 0;
-    double delay = 0.0;
+    uint32_t trigger_latency = CLOCK_LATENCY_NONE;
+    uint64_t delay_picos = 0;
+    uint64_t delay_compensated = 0;
 
     // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
@@ -1479,25 +2220,29 @@ scpi_result_t SCPI_TriggerDelay(
         return SCPI_RES_ERR;
     }
 
-    // Now get the trigger delay if present
-    if(!SCPI_ParamDouble(context, &trigger_delay, TRUE))
-    {
-        return SCPI_RES_ERR;
-    } 
-
     // Now get unit conversion paramerters
     struct clock_config* config_array = sequencer_clock_config_get();
 
-    const double unit_offset = config_array[clock_id].unit_offset_trigger;
+    const uint64_t unit_offset = config_array[clock_id].unit_offset_trigger;
     const uint clock_divider = config_array[clock_id].clock_divider;
+    const uint clock_divider_frac = config_array[clock_id].clock_divider_frac;
 
-    // Convert delay into nanoseconds
-    delay = trigger_delay * unit_offset;
+    // Now get the trigger delay if present, values without a unit suffix use
+    // the trigger units
+    if (!SCPI_ParamPicos(
+        context,
+        &delay_picos,
+        unit_offset,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
 
-    // Convert nanoseconds to cycles, if possible
-    if (!convert_nanos_to_cycles(
-        (uint64_t) delay, // This truncates decimals similar to floor operation (e.g, 120.5 ns --> 120 ns)
+    // Convert picoseconds to the nearest cycle, if possible
+    if (!convert_picos_to_cycles(
+        delay_picos,
         clock_divider,
+        clock_divider_frac,
         &trigger_delay_cycles
     )) {
         SCPI_ErrorPush(
@@ -1508,10 +2253,35 @@ scpi_result_t SCPI_TriggerDelay(
         return SCPI_RES_ERR;
     }
 
+    // Subtract the trigger-to-clock pipeline latency of the current trigger
+    // mode, so the delay is measured from the trigger edge. A delay of 0 adds
+    // no delay loop cycles and is not compensated.
+    if (trigger_delay_cycles > 0)
+    {
+        trigger_latency = sequencer_latency_trigger_get(&config_array[clock_id]);
+
+        if (!sequencer_latency_compensate(
+            trigger_delay_cycles,
+            trigger_latency,
+            0,
+            &delay_compensated
+        )) {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        trigger_delay_cycles = (uint32_t) delay_compensated;
+    }
+
     // This is not ideal, but there should only ever be two external trigger instructions and never more
     const bool success = trigger_delay_set(
         clock_id,
-        trigger_delay_cycles
+        trigger_delay_cycles,
+        trigger_latency
     );
 
     // If for some wierd reason we failed, raise an error
@@ -1640,6 +2410,242 @@ scpi_result_t SCPI_TriggerCountQ(
 }
 
 
+// Set trigger accept mask at clock sequencer N.
+// The mask is a string of '0' (reject) and '1' (accept) characters where the
+// first character belongs to the first trigger edge.
+scpi_result_t SCPI_TriggerMask(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    const char* mask_string = NULL;
+    size_t mask_length = 0;
+    uint32_t trigger_mask[CLOCK_TRIGGER_MASK_WORDS] = {0};
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Now get the mask string if present
+    if (!SCPI_ParamCharacters(context, &mask_string, &mask_length, TRUE))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if ((mask_length == 0) ||
+        (mask_length > CLOCK_TRIGGER_MASK_BITS_MAX))
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Convert mask string to bits
+    for (size_t i = 0; i < mask_length; i++)
+    {
+        if (mask_string[i] == '1')
+        {
+            trigger_mask[i / 32] |= 1u << (i % 32);
+        }
+        else if (mask_string[i] != '0')
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_PARAMETER_ERROR
+            );
+
+            return SCPI_RES_ERR;
+        }
+    }
+
+    const bool success = trigger_mask_set(
+        clock_id,
+        trigger_mask,
+        (uint32_t) mask_length
+    );
+
+    // Every mask word holds the same amount of bits (the pull threshold) and
+    // the DMA ring needs 1, 2 or 4 words, so a mask longer than 32 bits has to
+    // split evenly into 2 or 4 words of at most 32 bits. Padding the last word
+    // would consume trigger edges, so other lengths are rejected.
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query trigger accept mask at clock sequencer N
+scpi_result_t SCPI_TriggerMaskQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    char mask_string[CLOCK_TRIGGER_MASK_BITS_MAX + 1] = {0};
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve clock sequencer container
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    const uint32_t mask_words = config_array[clock_id].trigger_mask_words;
+    const uint32_t mask_bits = config_array[clock_id].trigger_mask_bits;
+
+    // Convert mask words back to a string
+    for (uint32_t i = 0; i < mask_words * mask_bits; i++)
+    {
+        const uint32_t bit = (config_array[clock_id].trigger_mask[i / mask_bits] >> (i % mask_bits)) & 1u;
+
+        mask_string[i] = bit ? '1' : '0';
+    }
+
+    SCPI_ResultText(
+        context,
+        mask_string
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
+// Set trigger glitch filter length (in cycles) at clock sequencer N
+scpi_result_t SCPI_TriggerFilter(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+    uint32_t trigger_filter = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Now get the filter length if present
+    if(!SCPI_ParamUInt32(context, &trigger_filter, TRUE))
+    {
+        return SCPI_RES_ERR;
+    } 
+
+    const bool success = trigger_filter_set(
+        clock_id,
+        trigger_filter
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query trigger glitch filter length at clock sequencer N
+scpi_result_t SCPI_TriggerFilterQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve clock sequencer container
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[clock_id].trigger_filter
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
+// Query the fixed latency (in nanoseconds) the glitch filter adds at clock sequencer N
+scpi_result_t SCPI_TriggerFilterLatencyQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t clock_id = 0;
+
+    // Get clock sequencer ID
+    if (SCPI_check_clock_id_and_append_error(
+        context,
+        &clock_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve clock sequencer container
+    struct clock_config* config_array = sequencer_clock_config_get();
+
+    const uint32_t latency_cycles = sequencer_clock_trigger_filter_latency(
+        &config_array[clock_id]
+    );
+
+    const uint64_t latency = sequencer_latency_cycles_nanos_get(
+        latency_cycles,
+        config_array[clock_id].clock_divider,
+        config_array[clock_id].clock_divider_frac
+    );
+
+    SCPI_ResultUInt64(
+        context,
+        latency
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
 // Reset clock sequencer N
 scpi_result_t SCPI_ClockReset(
     scpi_t* context
@@ -1678,4 +2684,47 @@ scpi_result_t SCPI_ClockReset(
     }
 
     return SCPI_RES_OK;
-}
\ No newline at end of file
+}
+
+
+// Channel list variants of the per clock sequencer commands
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockStatus, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockStatusQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockClockDivider, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockClockDividerQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockClockDividerValue, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockClockDividerValueQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockMode, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockModeQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockeUnits, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockUnitsQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataPatch, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockReset, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataApply, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataSolve, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataFreqAchievedQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_ClockDataErrorQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerMode, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerModeQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerEdge, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerEdgeQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerLevel, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerLevelQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerUnits, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerUnitsQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerPin, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerPinQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerLogic, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerLogicQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerDelay, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerDelayQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerSkip, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerSkipQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerCount, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerCountQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerMask, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerMaskQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerFilter, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerFilterQ, clock_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_TriggerFilterLatencyQ, clock_id_validate)
\ No newline at end of file
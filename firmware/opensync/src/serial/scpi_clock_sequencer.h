@@ -2,42 +2,57 @@
 
 #include "scpi/scpi.h"
 
+#include "scpi_channel_list.h"
+
 
 #define INSTRUMENT_CLOCK_COMMANDS \
     {.pattern = "SOURce:CLOCk:SELect",      .callback = SCPI_ClockIndex,}, \
     {.pattern = "SOURce:CLOCk:SELect?",     .callback = SCPI_ClockIndexQ,}, \
-    {.pattern = "SOURce:CLOCk#:STATe",      .callback = SCPI_ClockStatus,}, \
-    {.pattern = "SOURce:CLOCk#:State?",     .callback = SCPI_ClockStatusQ,}, \
-    {.pattern = "SOURce:CLOCk#:DIVider",    .callback = SCPI_ClockClockDivider,}, \
-    {.pattern = "SOURce:CLOCk#:DIVider?",   .callback = SCPI_ClockClockDividerQ,}, \
-    {.pattern = "SOURce:CLOCk#:MODe",       .callback = SCPI_ClockMode,}, \
-    {.pattern = "SOURce:CLOCk#:MODe?",      .callback = SCPI_ClockModeQ,}, \
-    {.pattern = "SOURce:CLOCk#:UNITs",      .callback = SCPI_ClockeUnits,}, \
-    {.pattern = "SOURce:CLOCk#:UNIts?",     .callback = SCPI_ClockUnitsQ,}, \
-    {.pattern = "SOURce:CLOCk#:DATA?",      .callback = SCPI_ClockDataQ,}, \
-    {.pattern = "SOURce:CLOCk#:RESet",      .callback = SCPI_ClockReset,}, \
+    {.pattern = "SOURce:CLOCk#:STATe",      .callback = SCPI_ClockStatusChannels,}, \
+    {.pattern = "SOURce:CLOCk#:State?",     .callback = SCPI_ClockStatusQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DIVider",    .callback = SCPI_ClockClockDividerChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DIVider?",   .callback = SCPI_ClockClockDividerQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DIVider:VALue",  .callback = SCPI_ClockClockDividerValueChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DIVider:VALue?", .callback = SCPI_ClockClockDividerValueQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:MODe",       .callback = SCPI_ClockModeChannels,}, \
+    {.pattern = "SOURce:CLOCk#:MODe?",      .callback = SCPI_ClockModeQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:UNITs",      .callback = SCPI_ClockeUnitsChannels,}, \
+    {.pattern = "SOURce:CLOCk#:UNIts?",     .callback = SCPI_ClockUnitsQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DATA?",      .callback = SCPI_ClockDataQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DATA:PATCh", .callback = SCPI_ClockDataPatchChannels,}, \
+    {.pattern = "SOURce:CLOCk#:RESet",      .callback = SCPI_ClockResetChannels,}, \
     {.pattern = "SOURce:CLOCk#:DATA:BUFFer:FREQuency",  .callback = SCPI_ClockDataFreq,}, \
     {.pattern = "SOURce:CLOCk#:DATA:BUFFer:FREQuency?", .callback = SCPI_ClockDataFreqQ,}, \
     {.pattern = "SOURce:CLOCk#:DATA:BUFFer:COUNt",      .callback = SCPI_ClockDataReps,}, \
     {.pattern = "SOURce:CLOCk#:DATA:BUFFer:COUNt?",     .callback = SCPI_ClockDataRepsQ,}, \
     {.pattern = "SOURce:CLOCk#:DATA:BUFFer:CLEar",      .callback = SCPI_ClockDataClear,}, \
-    {.pattern = "SOURce:CLOCk#:DATA:BUFFer:APPly",      .callback = SCPI_ClockDataApply,}, \
-    {.pattern = "TRIGger:CLOCk#:MODe",          .callback = SCPI_TriggerMode,}, \
-    {.pattern = "TRIGger:CLOCk#:MODe?",         .callback = SCPI_TriggerModeQ,}, \
-    {.pattern = "TRIGger:CLOCk#:EDGE",          .callback = SCPI_TriggerEdge,}, \
-    {.pattern = "TRIGger:CLOCk#:EDGE?",         .callback = SCPI_TriggerEdgeQ,}, \
-    {.pattern = "TRIGger:CLOCk#:GATE:LEVel",    .callback = SCPI_TriggerLevel,}, \
-    {.pattern = "TRIGger:CLOCk#:GATE:LEVel?",   .callback = SCPI_TriggerLevelQ,}, \
-    {.pattern = "TRIGger:CLOCk#:UNITs",         .callback = SCPI_TriggerUnits,}, \
-    {.pattern = "TRIGger:CLOCk#:UNITs?",        .callback = SCPI_TriggerUnitsQ,}, \
-    {.pattern = "TRIGger:CLOCk#:INPut",         .callback = SCPI_TriggerPin,}, \
-    {.pattern = "TRIGger:CLOCk#:INPut?",        .callback = SCPI_TriggerPinQ,}, \
-    {.pattern = "TRIGger:CLOCk#:DELay",         .callback = SCPI_TriggerDelay,}, \
-    {.pattern = "TRIGger:CLOCk#:DELay?",        .callback = SCPI_TriggerDelayQ,}, \
-    {.pattern = "TRIGger:CLOCk#:SKIP",          .callback = SCPI_TriggerSkip,}, \
-    {.pattern = "TRIGger:CLOCk#:SKIP?",         .callback = SCPI_TriggerSkipQ,}, \
-    {.pattern = "TRIGger:CLOCk#:COUNt",         .callback = SCPI_TriggerCount,}, \
-    {.pattern = "TRIGger:CLOCk#:COUNt?",        .callback = SCPI_TriggerCountQ,}, \
+    {.pattern = "SOURce:CLOCk#:DATA:BUFFer:APPly",      .callback = SCPI_ClockDataApplyChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DATA:BUFFer:SOLVe",      .callback = SCPI_ClockDataSolveChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DATA:FREQuency?",        .callback = SCPI_ClockDataFreqAchievedQChannels,}, \
+    {.pattern = "SOURce:CLOCk#:DATA:ERRor?",            .callback = SCPI_ClockDataErrorQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:MODe",          .callback = SCPI_TriggerModeChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:MODe?",         .callback = SCPI_TriggerModeQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:EDGE",          .callback = SCPI_TriggerEdgeChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:EDGE?",         .callback = SCPI_TriggerEdgeQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:GATE:LEVel",    .callback = SCPI_TriggerLevelChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:GATE:LEVel?",   .callback = SCPI_TriggerLevelQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:UNITs",         .callback = SCPI_TriggerUnitsChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:UNITs?",        .callback = SCPI_TriggerUnitsQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:INPut",         .callback = SCPI_TriggerPinChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:INPut?",        .callback = SCPI_TriggerPinQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:INPut:LOGic",   .callback = SCPI_TriggerLogicChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:INPut:LOGic?",  .callback = SCPI_TriggerLogicQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:DELay",         .callback = SCPI_TriggerDelayChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:DELay?",        .callback = SCPI_TriggerDelayQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:SKIP",          .callback = SCPI_TriggerSkipChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:SKIP?",         .callback = SCPI_TriggerSkipQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:COUNt",         .callback = SCPI_TriggerCountChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:COUNt?",        .callback = SCPI_TriggerCountQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:MASK",          .callback = SCPI_TriggerMaskChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:MASK?",         .callback = SCPI_TriggerMaskQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:FILTer",        .callback = SCPI_TriggerFilterChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:FILTer?",       .callback = SCPI_TriggerFilterQChannels,}, \
+    {.pattern = "TRIGger:CLOCk#:FILTer:LATency?", .callback = SCPI_TriggerFilterLatencyQChannels,}, \
     
 void clock_sequencer_cache_clear();
 
@@ -65,6 +80,14 @@ scpi_result_t SCPI_ClockClockDividerQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_ClockClockDividerValue(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ClockClockDividerValueQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_ClockeUnits(
     scpi_t* context
 );
@@ -97,10 +120,26 @@ scpi_result_t SCPI_ClockDataApply(
     scpi_t* context
 );
 
+scpi_result_t SCPI_ClockDataSolve(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ClockDataFreqAchievedQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ClockDataErrorQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_ClockDataQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_ClockDataPatch(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_ClockMode(
     scpi_t* context
 );
@@ -141,6 +180,14 @@ scpi_result_t SCPI_TriggerPinQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_TriggerLogic(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_TriggerLogicQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_TriggerUnits(
     scpi_t* context
 );
@@ -173,6 +220,68 @@ scpi_result_t SCPI_TriggerCountQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_TriggerMask(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_TriggerMaskQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_TriggerFilter(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_TriggerFilterQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_TriggerFilterLatencyQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_ClockReset(
     scpi_t* context
-);
\ No newline at end of file
+);
+
+// Per channel commands, also accept a trailing channel list
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockStatus);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockStatusQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockClockDivider);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockClockDividerQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockClockDividerValue);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockClockDividerValueQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockMode);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockModeQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockeUnits);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockUnitsQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataPatch);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockReset);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataApply);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataSolve);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataFreqAchievedQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_ClockDataErrorQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerMode);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerModeQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerEdge);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerEdgeQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerLevel);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerLevelQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerUnits);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerUnitsQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerPin);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerPinQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerLogic);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerLogicQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerDelay);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerDelayQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerSkip);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerSkipQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerCount);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerCountQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerMask);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerMaskQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerFilter);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerFilterQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_TriggerFilterLatencyQ);
\ No newline at end of file
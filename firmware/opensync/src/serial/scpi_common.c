@@ -2,29 +2,119 @@
 #include <stdint.h>
 #include "scpi/scpi.h"
 
+#include "overclock/overclock.h"
 #include "status/sequencer_status.h"
+#include "sequencer/sequencer_common.h"
 #include "scpi_common.h"
 
 
 const int32_t STATEFUL = -1;
 const uint64_t CLOCK_CYCLES_MAX  = 4294967200; // 2^32 - 96
-const uint64_t CLOCK_CYCLE_NANOS = 4; // Each clock cycle is 4 ns long
-const double OFFSET_NANOSECOND  = 1.0;
-const double OFFSET_MICROSECOND = 1e3;
-const double OFFSET_MILLISECOND = 1e6;
-const double OFFSET_SECOND      = 1e9;
-const double OFFSET_MINUTE      = 6e10;
-const double OFFSET_HOUR        = 3.6e12;
-
-
-// Convert nanoseconds to cycles, return 1 if success, 0 is not
-// TODO: round to nearest clock cycle using doubles instead of integer arithmetic
-bool convert_nanos_to_cycles(
-    uint64_t nanoseconds,
+const uint64_t CLOCK_CYCLES_EXTENDED_MAX = 1ull << 62; // keeps the delay block count within 32 bits
+const uint64_t PICOS_PER_NANOSECOND = 1000;
+const uint64_t PICOS_MAX = 1ull << 62; // about 53 days, keeps sums of delays within 64 bits
+const uint64_t OFFSET_NANOSECOND  = 1;
+const uint64_t OFFSET_MICROSECOND = 1000;
+const uint64_t OFFSET_MILLISECOND = 1000000;
+const uint64_t OFFSET_SECOND      = 1000000000;
+const uint64_t OFFSET_MINUTE      = 60000000000;
+const uint64_t OFFSET_HOUR        = 3600000000000;
+
+
+// Get the numerator of the system clock cycle period in ns, the period is
+// num / den of the clock profile the device booted with
+uint64_t clock_cycle_nanos_num_get()
+{
+    return overclock_profile_get() -> cycle_nanos_num;
+}
+
+
+// Get the fixed point steps per ns of clock_cycle_nanos_fixed_get
+uint64_t clock_cycle_fixed_scale_get()
+{
+    return (uint64_t) overclock_profile_get() -> cycle_nanos_den << 8;
+}
+
+
+// Get the length of a state machine cycle in 1/clock_cycle_fixed_scale_get()
+// ns steps for a 16.8 fixed point clock divider
+uint64_t clock_cycle_nanos_fixed_get(
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac
+) {
+    return (((uint64_t) clock_divider << CLOCK_DIVIDER_FRAC_BITS) + clock_divider_frac) * clock_cycle_nanos_num_get();
+}
+
+
+// Get the length of a state machine cycle in 1/clock_cycle_fixed_scale_get()
+// ps steps
+static uint64_t clock_cycle_picos_fixed_get(
+    uint64_t cycle_nanos_fixed
+) {
+    return cycle_nanos_fixed * PICOS_PER_NANOSECOND;
+}
+
+
+// Get the nearest number of cycles for picoseconds at a fixed point cycle
+// length. The division is split so the scaled remainder stays within 64 bits
+// for every divider.
+uint64_t clock_cycles_nearest_get(
+    uint64_t picoseconds,
+    uint64_t cycle_nanos_fixed
+) {
+    const uint64_t cycle_picos = clock_cycle_picos_fixed_get(cycle_nanos_fixed);
+    const uint64_t scale = clock_cycle_fixed_scale_get();
+
+    return (picoseconds / cycle_picos) * scale +
+        ((picoseconds % cycle_picos) * scale + cycle_picos / 2) / cycle_picos;
+}
+
+
+// Get the nearest number of picoseconds of a cycle count at a fixed point
+// cycle length
+uint64_t clock_cycles_picos_get(
+    uint64_t cycles,
+    uint64_t cycle_nanos_fixed
+) {
+    const uint64_t cycle_picos = clock_cycle_picos_fixed_get(cycle_nanos_fixed);
+    const uint64_t scale = clock_cycle_fixed_scale_get();
+
+    return (cycles / scale) * cycle_picos +
+        ((cycles % scale) * cycle_picos + scale / 2) / scale;
+}
+
+
+// Get the quantization error (requested - achieved) in picoseconds of a time
+// converted to cycles
+int64_t clock_cycles_error_picos_get(
+    uint64_t picoseconds,
+    uint64_t cycles,
+    uint64_t cycle_nanos_fixed
+) {
+    return (int64_t) picoseconds - (int64_t) clock_cycles_picos_get(
+        cycles,
+        cycle_nanos_fixed
+    );
+}
+
+
+// Convert picoseconds to the nearest number of cycles, return 1 if success,
+// 0 is not
+bool convert_picos_to_cycles(
+    uint64_t picoseconds,
     uint32_t clock_divider,
+    uint32_t clock_divider_frac,
     uint32_t* cycles
 ){
-    uint64_t clock_cycles_raw = nanoseconds / ((uint64_t) (clock_divider) * CLOCK_CYCLE_NANOS);
+    if (clock_divider == 0)
+    {
+        return 0;
+    }
+
+    uint64_t clock_cycles_raw = clock_cycles_nearest_get(
+        picoseconds,
+        clock_cycle_nanos_fixed_get(clock_divider, clock_divider_frac)
+    );
 
     if (clock_cycles_raw > CLOCK_CYCLES_MAX)
     {
@@ -37,6 +127,35 @@ bool convert_nanos_to_cycles(
 }
 
 
+// Convert picoseconds to the nearest number of cycles without the 32 bit limit
+// of a single delay loop. Used for delays split into hierarchical loops.
+bool convert_picos_to_cycles_extended(
+    uint64_t picoseconds,
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac,
+    uint64_t* cycles
+){
+    if (clock_divider == 0)
+    {
+        return 0;
+    }
+
+    uint64_t clock_cycles_raw = clock_cycles_nearest_get(
+        picoseconds,
+        clock_cycle_nanos_fixed_get(clock_divider, clock_divider_frac)
+    );
+
+    if (clock_cycles_raw > CLOCK_CYCLES_EXTENDED_MAX)
+    {
+        return 0;
+    }
+
+    *cycles = clock_cycles_raw;
+
+    return 1;
+}
+
+
 bool is_running()
 {
     uint32_t status_copy = sequencer_status_get();
@@ -61,4 +180,62 @@ bool SCPI_check_running_and_append_error(
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+// Get (index, value) pairs of an instruction patch, at least one pair is
+// mandatory. Indices must be below words. Pushes an error onto the SCPI
+// context and returns false on a malformed list.
+bool SCPI_ParamPatchPairs(
+    scpi_t* context,
+    uint32_t* indices,
+    uint32_t* values,
+    uint32_t words,
+    uint32_t* pairs
+) {
+    *pairs = 0;
+
+    while (true)
+    {
+        uint32_t index = 0;
+
+        if (!SCPI_ParamUInt32(context, &index, *pairs == 0))
+        {
+            if (SCPI_ParamErrorOccurred(context))
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        // A buffer can not take more patches than it has words
+        if (*pairs == words)
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_TOO_MUCH_DATA
+            );
+
+            return false;
+        }
+
+        // Every index needs its value
+        if (!SCPI_ParamUInt32(context, &values[*pairs], TRUE))
+        {
+            return false;
+        }
+
+        if (index >= words)
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return false;
+        }
+
+        indices[*pairs] = index;
+        (*pairs)++;
+    }
+}
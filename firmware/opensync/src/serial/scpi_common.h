@@ -18,21 +18,66 @@ enum {
 };
 
 extern const int32_t STATEFUL;
-extern const double OFFSET_NANOSECOND;
-extern const double OFFSET_MICROSECOND;
-extern const double OFFSET_MILLISECOND;
-extern const double OFFSET_SECOND;
-extern const double OFFSET_MINUTE;
-extern const double OFFSET_HOUR;
-
-bool convert_nanos_to_cycles(
-    uint64_t nanoseconds,
+extern const uint64_t CLOCK_CYCLES_MAX;
+extern const uint64_t CLOCK_CYCLES_EXTENDED_MAX;
+extern const uint64_t PICOS_PER_NANOSECOND;
+extern const uint64_t PICOS_MAX;
+extern const uint64_t OFFSET_NANOSECOND;
+extern const uint64_t OFFSET_MICROSECOND;
+extern const uint64_t OFFSET_MILLISECOND;
+extern const uint64_t OFFSET_SECOND;
+extern const uint64_t OFFSET_MINUTE;
+extern const uint64_t OFFSET_HOUR;
+
+uint64_t clock_cycle_nanos_num_get();
+
+uint64_t clock_cycle_fixed_scale_get();
+
+uint64_t clock_cycle_nanos_fixed_get(
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac
+);
+
+uint64_t clock_cycles_nearest_get(
+    uint64_t picoseconds,
+    uint64_t cycle_nanos_fixed
+);
+
+uint64_t clock_cycles_picos_get(
+    uint64_t cycles,
+    uint64_t cycle_nanos_fixed
+);
+
+int64_t clock_cycles_error_picos_get(
+    uint64_t picoseconds,
+    uint64_t cycles,
+    uint64_t cycle_nanos_fixed
+);
+
+bool convert_picos_to_cycles(
+    uint64_t picoseconds,
     uint32_t clock_divider,
+    uint32_t clock_divider_frac,
     uint32_t* cycles
 );
 
+bool convert_picos_to_cycles_extended(
+    uint64_t picoseconds,
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac,
+    uint64_t* cycles
+);
+
 bool is_running();
 
 bool SCPI_check_running_and_append_error(
     scpi_t* context
-);
\ No newline at end of file
+);
+
+bool SCPI_ParamPatchPairs(
+    scpi_t* context,
+    uint32_t* indices,
+    uint32_t* values,
+    uint32_t words,
+    uint32_t* pairs
+);
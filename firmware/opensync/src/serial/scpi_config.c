@@ -0,0 +1,524 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "pico/stdio.h"
+#include "pico/stdio_usb.h"
+
+#include "scpi/scpi.h"
+
+#include "overclock/overclock.h"
+#include "system/core_1.h"
+#include "system/config_slots.h"
+#include "system/config_snapshot.h"
+#include "scpi_common.h"
+#include "scpi_config.h"
+#include "scpi-def.h"
+
+// The block of SYSTem:CONFig:DATA arrives in one program message
+_Static_assert(
+    CONFIG_SNAPSHOT_SIZE + 64 <= SCPI_INPUT_BUFFER_LENGTH,
+    "A configuration snapshot does not fit into the SCPI input buffer"
+);
+
+
+// Commit the staged configuration, if it fails push an error onto SCPI
+// context and return true
+bool SCPI_config_commit_and_append_error(
+    scpi_t* context
+) {
+    const uint32_t result = sequencer_config_commit();
+
+    if (result == CONFIG_COMMIT_OK)
+    {
+        return false;
+    }
+
+    // Output or IRQ conflicts between pulse sequencers, sequence select inputs
+    // that are also trigger inputs, clock modes without a program, or trigger
+    // counts that are not whole mask passes
+    if ((result == CONFIG_COMMIT_PULSE_CONFLICT) ||
+        (result == CONFIG_COMMIT_IRQ_CONFLICT) ||
+        (result == CONFIG_COMMIT_INPUT_CONFLICT) ||
+        (result == CONFIG_COMMIT_CLOCK_MODE) ||
+        (result == CONFIG_COMMIT_TRIGGER_COUNT))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_SETTINGS_CONFLICT
+        );
+    }
+    // Clock and pulse programs that don't fit the PIO instruction memory
+    else if (result == CONFIG_COMMIT_PROGRAM_SPACE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_OUT_OF_MEMORY
+        );
+    }
+    // Trigger delay shorter than the latency of a changed trigger mode
+    else if (result == CONFIG_COMMIT_DELAY_RANGE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+    }
+    // Pulse data applied before its input was changed
+    else if (result == CONFIG_COMMIT_DATA_STALE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_CORRUPT_OR_STALE
+        );
+    }
+    // Pulse program that can not run with its format and input
+    else
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_PROGRAM_ERROR
+        );
+    }
+
+    return true;
+}
+
+
+// Validate the staged configuration and publish it to the sequencer
+scpi_result_t SCPI_ConfigCommit(
+    scpi_t* context
+) {
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_commit_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Drop all staged changes since the last commit
+scpi_result_t SCPI_ConfigRevert(
+    scpi_t* context
+) {
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    sequencer_config_revert();
+
+    return SCPI_RES_OK;
+}
+
+
+// Load a configuration snapshot into the staged configs and commit it. A
+// snapshot that fails any check leaves the staged configs untouched.
+scpi_result_t SCPI_ConfigData(
+    scpi_t* context
+) {
+    static struct config_snapshot snapshot;
+
+    const char* data = NULL;
+    size_t length = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamArbitraryBlock(
+        context,
+        &data,
+        &length,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Copy out of the input buffer so the records are aligned
+    if (length != CONFIG_SNAPSHOT_SIZE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_INVALID_BLOCK_DATA
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    memcpy(&snapshot, data, length);
+
+    const uint32_t result = config_snapshot_load(
+        &snapshot,
+        length
+    );
+
+    // Records with settings the setters would have rejected
+    if (result == CONFIG_SNAPSHOT_OUT_OF_RANGE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Wrong layout, version or CRC
+    if (result != CONFIG_SNAPSHOT_OK)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_INVALID_BLOCK_DATA
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_commit_and_append_error(context))
+    {
+        config_snapshot_restore();
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the staged configs as a configuration snapshot
+scpi_result_t SCPI_ConfigDataQ(
+    scpi_t* context
+) {
+    static struct config_snapshot snapshot;
+
+    config_snapshot_save(&snapshot);
+
+    // The block is binary, keep stdio from expanding newlines inside it
+    fflush(stdout);
+    stdio_set_translate_crlf(&stdio_usb, false);
+
+    SCPI_ResultArbitraryBlock(
+        context,
+        &snapshot,
+        CONFIG_SNAPSHOT_SIZE
+    );
+
+    fflush(stdout);
+    stdio_set_translate_crlf(&stdio_usb, true);
+
+    return SCPI_RES_OK;
+}
+
+
+// Query a CRC-32 per committed clock and pulse config, clocks first
+scpi_result_t SCPI_ConfigHashQ(
+    scpi_t* context
+) {
+    uint32_t hashes[CLOCKS_MAX + PULSES_MAX] = {0};
+
+    config_snapshot_hash_get(hashes);
+
+    SCPI_ResultArrayUInt32(
+        context,
+        hashes,
+        CLOCKS_MAX + PULSES_MAX,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Get a configuration slot parameter and validate it. If valid, change slot
+// to that value
+static bool SCPI_config_slot_param_and_append_error(
+    scpi_t* context,
+    uint32_t* slot
+) {
+    if (!SCPI_ParamUInt32(
+        context,
+        slot,
+        TRUE
+    )) {
+        return true;
+    }
+
+    if (!config_slot_validate(*slot))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return true;
+    }
+
+    return false;
+}
+
+
+// Save the staged configs to configuration slot N (*SAV)
+scpi_result_t SCPI_ConfigSave(
+    scpi_t* context
+) {
+    uint32_t slot = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_slot_param_and_append_error(
+        context,
+        &slot
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (config_slot_save(slot) != CONFIG_SLOT_OK)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_MASS_STORAGE_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Recall configuration slot N into the staged configs and commit it (*RCL)
+scpi_result_t SCPI_ConfigRecall(
+    scpi_t* context
+) {
+    uint32_t slot = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_slot_param_and_append_error(
+        context,
+        &slot
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Empty slot, or one written by a firmware with another layout
+    if (config_slot_recall(slot) != CONFIG_SLOT_OK)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_CORRUPT_OR_STALE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_commit_and_append_error(context))
+    {
+        config_snapshot_restore();
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Enable or disable arming the autostart slot at power on
+scpi_result_t SCPI_ConfigAutostart(
+    scpi_t* context
+) {
+    int32_t choice = 0;
+    uint32_t slot = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Valid autostart state choices
+    const scpi_choice_def_t options[] = {
+        {"ON",  STATUS_ON},
+        {"OFF", STATUS_OFF},
+        SCPI_CHOICE_LIST_END
+    };
+
+    if (!SCPI_ParamChoice(
+        context,
+        options,
+        &choice,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    config_slot_autostart_get(&slot);
+
+    if (config_slot_autostart_set(
+        (bool) choice,
+        slot
+    ) != CONFIG_SLOT_OK) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_MASS_STORAGE_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query whether the autostart slot is armed at power on
+scpi_result_t SCPI_ConfigAutostartQ(
+    scpi_t* context
+) {
+    uint32_t slot = 0;
+
+    SCPI_ResultBool(
+        context,
+        config_slot_autostart_get(&slot)
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Set the configuration slot armed at power on
+scpi_result_t SCPI_ConfigAutostartSlot(
+    scpi_t* context
+) {
+    uint32_t slot = 0;
+    uint32_t slot_previous = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (SCPI_config_slot_param_and_append_error(
+        context,
+        &slot
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    const bool enabled = config_slot_autostart_get(&slot_previous);
+
+    if (config_slot_autostart_set(
+        enabled,
+        slot
+    ) != CONFIG_SLOT_OK) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_MASS_STORAGE_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the configuration slot armed at power on
+scpi_result_t SCPI_ConfigAutostartSlotQ(
+    scpi_t* context
+) {
+    uint32_t slot = 0;
+
+    config_slot_autostart_get(&slot);
+
+    SCPI_ResultUInt32(
+        context,
+        slot
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Set the system clock profile in MHz used from the next power on
+scpi_result_t SCPI_ConfigClock(
+    scpi_t* context
+) {
+    uint32_t clock_mhz = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &clock_mhz,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!overclock_profile_validate(clock_mhz))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    if (config_slot_clock_profile_set(clock_mhz) != CONFIG_SLOT_OK)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_MASS_STORAGE_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the system clock profile in MHz used from the next power on
+scpi_result_t SCPI_ConfigClockQ(
+    scpi_t* context
+) {
+    uint32_t clock_mhz = config_slot_clock_profile_get();
+
+    if (!overclock_profile_validate(clock_mhz))
+    {
+        clock_mhz = SYSTEM_CLOCK_MHZ;
+    }
+
+    SCPI_ResultUInt32(
+        context,
+        clock_mhz
+    );
+
+    return SCPI_RES_OK;
+}
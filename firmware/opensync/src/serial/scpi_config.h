@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdbool.h>
+#include "scpi/scpi.h"
+
+
+#define INSTRUMENT_CONFIG_COMMANDS \
+    {.pattern = "CONFigure:COMMit", .callback = SCPI_ConfigCommit,}, \
+    {.pattern = "CONFigure:REVert", .callback = SCPI_ConfigRevert,}, \
+    {.pattern = "SYSTem:CONFig:DATA", .callback = SCPI_ConfigData,}, \
+    {.pattern = "SYSTem:CONFig:DATA?", .callback = SCPI_ConfigDataQ,}, \
+    {.pattern = "SYSTem:CONFig:HASH?", .callback = SCPI_ConfigHashQ,}, \
+    {.pattern = "SYSTem:CONFig:AUTostart[:STATe]", .callback = SCPI_ConfigAutostart,}, \
+    {.pattern = "SYSTem:CONFig:AUTostart[:STATe]?", .callback = SCPI_ConfigAutostartQ,}, \
+    {.pattern = "SYSTem:CONFig:AUTostart:SLOT", .callback = SCPI_ConfigAutostartSlot,}, \
+    {.pattern = "SYSTem:CONFig:AUTostart:SLOT?", .callback = SCPI_ConfigAutostartSlotQ,}, \
+    {.pattern = "SYSTem:CONFig:CLOCk", .callback = SCPI_ConfigClock,}, \
+    {.pattern = "SYSTem:CONFig:CLOCk?", .callback = SCPI_ConfigClockQ,}, \
+
+bool SCPI_config_commit_and_append_error(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigCommit(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigRevert(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigData(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigDataQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigHashQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigSave(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigRecall(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigAutostart(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigAutostartQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigAutostartSlot(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigAutostartSlotQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigClock(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_ConfigClockQ(
+    scpi_t* context
+);
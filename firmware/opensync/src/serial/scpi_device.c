@@ -12,13 +12,29 @@
 #include "scpi/scpi.h"
 
 #include "system/core_1.h"
+#include "overclock/overclock.h"
 #include "structs/clock_config.h"
 #include "structs/pulse_config.h"
+#include "sequencer/sequencer_latency.h"
 #include "status/sequencer_status.h"
 #include "status/debug_status.h"
+#include "status/trigger_status.h"
+#include "status/scan_status.h"
+#include "status/arm_status.h"
+#include "scpi-def.h"
 #include "scpi_clock_sequencer.h"
 #include "scpi_pulse_sequencer.h"
 #include "scpi_common.h"
+#include "scpi_config.h"
+
+// Time DEVice:START waits for the sequencer core to arm
+#define DEVICE_ARM_TIMEOUT_MS 1000
+
+// A run started with DEVice:START that has not reported its end yet
+static bool scpi_device_run_pending = false;
+static bool scpi_device_arm_async = false;
+static bool scpi_device_opc_pending = false;
+static bool scpi_device_srq_pending = false;
 
 
 // Return system status
@@ -114,6 +130,7 @@ scpi_result_t SCPI_DeviceFrequencyQ(
     uint f_clk_peri = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_PERI);
     uint f_clk_usb = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_USB);
     uint f_clk_adc = frequency_count_khz(CLOCKS_FC0_SRC_VALUE_CLK_ADC);
+    const struct overclock_profile* profile = overclock_profile_get();
 
     // We can't use %d, so printf to local buffer then send to SCPI interface
     // TODO: Make this prettier
@@ -126,14 +143,19 @@ rosc = %ukHz,\
 clk_sys = %ukHz,\
 clk_peri = %ukHz,\
 clk_usb = %ukHz,\
-clk_adc = %ukHz",
+clk_adc = %ukHz,\
+profile = %uMHz,\
+cycle = %u/%uns",
         f_pll_sys,
         f_pll_usb,
         f_rosc,
         f_clk_sys,
         f_clk_peri,
         f_clk_usb,
-        f_clk_adc
+        f_clk_adc,
+        (uint) profile -> mhz,
+        (uint) profile -> cycle_nanos_num,
+        (uint) profile -> cycle_nanos_den
     );
 
     SCPI_ResultCharacters(
@@ -146,8 +168,9 @@ clk_adc = %ukHz",
 }
 
 
-// Start pulse sequence with current device settings
-scpi_result_t SCPI_DeviceStart(
+// Commit the staged configuration and hand an arm request to the sequencer
+// core. If that fails push an error onto SCPI context and return true.
+static bool SCPI_device_arm_and_append_error(
     scpi_t* context
 ) {
     // If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
@@ -158,13 +181,106 @@ scpi_result_t SCPI_DeviceStart(
             SCPI_ERROR_PROGRAM_CURRENTLY_RUNNING
         );
 
-        return SCPI_RES_ERR;
+        return true;
+    }
+
+    // Publish staged changes, a bad configuration fails here and not on
+    // the sequencer core
+    if (SCPI_config_commit_and_append_error(context))
+    {
+        return true;
     }
 
     // Push arming status to sequencer core
+    arm_result_reset();
+    scpi_device_run_pending = true;
     multicore_fifo_push_blocking(ARM_SEQUENCER);
 
-    // TODO: wait and check for status change?
+    return false;
+}
+
+
+// Start pulse sequence with current device settings. Returns once the
+// sequencer core has started the state machines or failed to arm them, or
+// after DEVICE_ARM_TIMEOUT_MS with the request still pending.
+scpi_result_t SCPI_DeviceStart(
+    scpi_t* context
+) {
+    uint32_t channel = 0;
+    uint32_t result = ARM_RESULT_PENDING;
+
+    scpi_device_arm_async = false;
+
+    if (SCPI_device_arm_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    const absolute_time_t deadline = make_timeout_time_ms(DEVICE_ARM_TIMEOUT_MS);
+
+    while ((result = arm_result_get(&channel)) == ARM_RESULT_PENDING)
+    {
+        // The request can't be taken back from the sequencer core, which may
+        // still start the run. Its result is reported through the status
+        // registers and DEVice:START:RESult? like for DEVice:START:ASYNc.
+        if (time_reached(deadline))
+        {
+            scpi_device_arm_async = true;
+
+            return SCPI_RES_OK;
+        }
+
+        sleep_us(10);
+    }
+
+    // The failure code and channel are queried with DEVice:START:RESult?
+    if (result != ARM_RESULT_OK)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ARM_IGNORED
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Start pulse sequence with current device settings without waiting for the
+// sequencer core. The arm result raises an OPERation event.
+scpi_result_t SCPI_DeviceStartAsync(
+    scpi_t* context
+) {
+    scpi_device_arm_async = true;
+
+    if (SCPI_device_arm_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the result of the last arm request and the channel that failed it
+scpi_result_t SCPI_DeviceStartResultQ(
+    scpi_t* context
+) {
+    uint32_t channel = 0;
+
+    const uint32_t result = arm_result_get(&channel);
+
+    SCPI_ResultUInt32(
+        context,
+        result
+    );
+
+    SCPI_ResultUInt32(
+        context,
+        channel
+    );
 
     return SCPI_RES_OK;
 }
@@ -206,6 +322,276 @@ scpi_result_t SCPI_DeviceStop(
 }
 
 
+// Set the trigger timeout in seconds (0 disables the timeout).
+// Externally triggered clocks have to accept a trigger within this time or
+// the run is aborted. In mask mode any trigger edge counts, also one the
+// mask rejects.
+scpi_result_t SCPI_DeviceTimeout(
+    scpi_t* context
+) {
+    const double TIMEOUT_SECONDS_MAX = 86400.0; // one day
+    double timeout_seconds = 0.0;
+
+    // If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (is_running())
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_PROGRAM_CURRENTLY_RUNNING
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve the timeout if present
+    if (!SCPI_ParamDouble(context, &timeout_seconds, TRUE))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if ((timeout_seconds < 0.0) ||
+        (timeout_seconds > TIMEOUT_SECONDS_MAX))
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    trigger_timeout_set(
+        (uint64_t) (timeout_seconds * 1e6)
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Return the trigger timeout in seconds
+scpi_result_t SCPI_DeviceTimeoutQ(
+    scpi_t* context
+) {
+    SCPI_ResultDouble(
+        context,
+        (double) trigger_timeout_get() / 1e6
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Return the clocks that starved in the last run (bit N = clock N)
+scpi_result_t SCPI_DeviceTimeoutStarvedQ(
+    scpi_t* context
+) {
+    SCPI_ResultUInt32(
+        context,
+        trigger_starved_get()
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the pipeline latency in nanoseconds from the trigger (or clock) edge
+// to the first output edge of every pulse sequencer. This latency is
+// subtracted from trigger delays and the first pulse delay when applied.
+scpi_result_t SCPI_DeviceLatencyQ(
+    scpi_t* context
+) {
+    uint32_t latency[PULSES_MAX] = {0};
+
+    struct clock_config* clock_config_array = sequencer_clock_config_get();
+    struct pulse_config* pulse_config_array = sequencer_pulse_config_get();
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        latency[i] = (uint32_t) sequencer_latency_path_nanos_get(
+            &pulse_config_array[i],
+            clock_config_array
+        );
+    }
+
+    SCPI_ResultArrayUInt32(
+        context,
+        latency,
+        PULSES_MAX,
+        0
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the microseconds from power on until the first sequence was armed, 0
+// if none was started yet
+scpi_result_t SCPI_DeviceBootArmedQ(
+    scpi_t* context
+) {
+    SCPI_ResultUInt32(
+        context,
+        sequencer_boot_armed_us_get()
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Move events raised by the sequencer core into the SCPI status registers.
+// The sequencer core can't touch the SCPI context, so this is called by the
+// SCPI core before every command and while it waits for one.
+void scpi_device_status_update(
+    scpi_t* context
+) {
+    if (trigger_timeout_event_take())
+    {
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_QUES,
+            QUES_TRIGGER_TIMEOUT
+        );
+
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_OPER,
+            OPER_TRIGGER_TIMEOUT
+        );
+    }
+
+    if (scan_point_event_take())
+    {
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_OPER,
+            OPER_SCAN_POINT
+        );
+    }
+
+    if (arm_event_take())
+    {
+        uint32_t channel = 0;
+
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_OPER,
+            OPER_ARM_COMPLETE
+        );
+
+        // DEVice:START reports its failures itself
+        if (scpi_device_arm_async &&
+            (arm_result_get(&channel) != ARM_RESULT_OK))
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_ARM_IGNORED
+            );
+        }
+    }
+
+    const uint32_t events = sequencer_event_take();
+
+    if (events & SEQUENCER_EVENT_COMPLETE)
+    {
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_OPER,
+            OPER_RUN_COMPLETE
+        );
+    }
+
+    if (events & SEQUENCER_EVENT_ABORTED)
+    {
+        SCPI_RegSetBits(
+            context,
+            SCPI_REG_OPER,
+            OPER_RUN_ABORTED
+        );
+    }
+
+    // A pending *OPC completes with the run, whichever way it ended
+    if ((events != 0) && !is_running())
+    {
+        scpi_device_run_pending = false;
+
+        if (scpi_device_opc_pending)
+        {
+            scpi_device_opc_pending = false;
+
+            SCPI_RegSetBits(
+                context,
+                SCPI_REG_ESR,
+                ESR_OPC
+            );
+        }
+    }
+
+    // Service requests go out here and not from the register update, so
+    // they never end up inside the response of a command. One waits while a
+    // message is only partly received or a response line is still open, and
+    // is dropped if *SRE no longer enables any bit of the status byte.
+    if (scpi_device_srq_pending &&
+        (context->buffer.position == 0) &&
+        !scpi_output_open_get())
+    {
+        const scpi_reg_val_t stb = SCPI_RegGet(context, SCPI_REG_STB);
+
+        scpi_device_srq_pending = false;
+
+        if (stb & SCPI_RegGet(context, SCPI_REG_SRE) & ~STB_SRQ)
+        {
+            printf("SRQ %u\r\n", (unsigned int) stb);
+            fflush(stdout);
+        }
+    }
+}
+
+
+// Note a service request raised by scpi-parser. A USB serial link has no SRQ
+// line, so the request is sent as a message by scpi_device_status_update.
+scpi_result_t SCPI_DeviceControl(
+    scpi_t* context,
+    scpi_ctrl_name_t ctrl,
+    scpi_reg_val_t val
+) {
+    (void) context;
+    (void) val;
+
+    if (ctrl == SCPI_CTRL_SRQ)
+    {
+        scpi_device_srq_pending = true;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Set the operation complete bit, once a started run has ended if there is
+// one
+scpi_result_t SCPI_DeviceOpc(
+    scpi_t* context
+) {
+    if (!scpi_device_run_pending && !is_running())
+    {
+        return SCPI_CoreOpc(context);
+    }
+
+    scpi_device_opc_pending = true;
+
+    return SCPI_RES_OK;
+}
+
+
+// Clear the status registers and drop a pending *OPC
+scpi_result_t SCPI_DeviceCls(
+    scpi_t* context
+) {
+    scpi_device_opc_pending = false;
+
+    return SCPI_CoreCls(context);
+}
+
+
 // Reset device
 scpi_result_t SCPI_DeviceReset(
     scpi_t* context
@@ -237,6 +623,9 @@ scpi_result_t SCPI_DeviceReset(
         );
     }
 
+    // Publish the defaults, they always pass validation
+    sequencer_config_commit();
+
     // Clear static instruction data caches
     pulse_sequencer_cache_clear();
     clock_sequencer_cache_clear();
@@ -245,6 +634,8 @@ scpi_result_t SCPI_DeviceReset(
     // TODO: Add reset functions for each
     sequencer_status_set(IDLE);
     debug_status_set(SEQUENCER_DNDEBUG);
+    trigger_timeout_set(TRIGGER_TIMEOUT_DISABLED);
+    trigger_starved_set(0);
 
     return SCPI_RES_OK;
 }
@@ -9,7 +9,14 @@
     {.pattern = "DEVice:DEBug?", .callback = SCPI_DeviceDebugQ,}, \
     {.pattern = "DEVice:FREQuency?", .callback = SCPI_DeviceFrequencyQ,}, \
     {.pattern = "DEVice:START", .callback = SCPI_DeviceStart,}, \
+    {.pattern = "DEVice:START:ASYNc", .callback = SCPI_DeviceStartAsync,}, \
+    {.pattern = "DEVice:START:RESult?", .callback = SCPI_DeviceStartResultQ,}, \
     {.pattern = "DEVice:STOP", .callback = SCPI_DeviceStop,}, \
+    {.pattern = "DEVice:TIMeout", .callback = SCPI_DeviceTimeout,}, \
+    {.pattern = "DEVice:TIMeout?", .callback = SCPI_DeviceTimeoutQ,}, \
+    {.pattern = "DEVice:TIMeout:STARved?", .callback = SCPI_DeviceTimeoutStarvedQ,}, \
+    {.pattern = "DEVice:LATency?", .callback = SCPI_DeviceLatencyQ,}, \
+    {.pattern = "DEVice:BOOT:ARMed?", .callback = SCPI_DeviceBootArmedQ,}, \
     {.pattern = "DEVice:RESet", .callback = SCPI_DeviceReset,}, \
     {.pattern = "DEVice:TEST?", .callback = SCPI_DeviceTestQ,}, \
 
@@ -33,14 +40,60 @@ scpi_result_t SCPI_DeviceStart(
     scpi_t* context
 );
 
+scpi_result_t SCPI_DeviceStartAsync(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceStartResultQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_DeviceStop(
     scpi_t* context
 );
 
+scpi_result_t SCPI_DeviceTimeout(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceTimeoutQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceTimeoutStarvedQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceLatencyQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceBootArmedQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_DeviceReset(
     scpi_t* context
 );
 
 scpi_result_t SCPI_DeviceTestQ(
     scpi_t* context
-);
\ No newline at end of file
+);
+
+void scpi_device_status_update(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceControl(
+    scpi_t* context,
+    scpi_ctrl_name_t ctrl,
+    scpi_reg_val_t val
+);
+
+scpi_result_t SCPI_DeviceOpc(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_DeviceCls(
+    scpi_t* context
+);
@@ -0,0 +1,192 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "scpi/scpi.h"
+
+#include "scpi_dispatch.h"
+#include "scpi_dispatch_table.h"
+
+
+static const scpi_command_t* scpi_dispatch_commands = NULL;
+static bool scpi_dispatch_enabled = false;
+
+
+// Check the command list matches the one the dispatch table was generated
+// from. If it does not, every message falls back to the linear search.
+bool scpi_dispatch_init(
+    const scpi_command_t* commands
+) {
+    uint32_t hash = 0x811C9DC5u;
+    uint32_t count = 0;
+
+    for (; commands[count].pattern != NULL; count++)
+    {
+        for (const char* c = commands[count].pattern; *c != '\0'; c++)
+        {
+            hash = (hash ^ (uint8_t) *c) * 0x01000193u;
+        }
+
+        hash = (hash ^ '\n') * 0x01000193u;
+    }
+
+    scpi_dispatch_commands = commands;
+    scpi_dispatch_enabled = (count == SCPI_DISPATCH_COMMANDS) && (hash == SCPI_DISPATCH_PATTERNS_HASH);
+
+    return scpi_dispatch_enabled;
+}
+
+
+// Find the first command that can match a program header. Numeric suffixes
+// are skipped, scpi-parser still checks them when it matches the command.
+bool scpi_dispatch_find(
+    const char* header,
+    size_t length,
+    uint32_t* command
+) {
+    uint32_t state = 0;
+    size_t i = 0;
+
+    // A single leading colon is optional
+    if ((length > 0) && (header[0] == ':'))
+    {
+        i++;
+    }
+
+    for (; i < length; i++)
+    {
+        if (isdigit((unsigned char) header[i]))
+        {
+            continue;
+        }
+
+        const char symbol = (char) toupper((unsigned char) header[i]);
+        const struct scpi_dispatch_edge* edge = &scpi_dispatch_edges[scpi_dispatch_states[state].first_edge];
+        const struct scpi_dispatch_edge* edge_end = edge + scpi_dispatch_states[state].edge_count;
+
+        while ((edge < edge_end) && (edge->symbol != symbol))
+        {
+            edge++;
+        }
+
+        if (edge == edge_end)
+        {
+            return false;
+        }
+
+        state = edge->next;
+    }
+
+    if (scpi_dispatch_states[state].command == SCPI_DISPATCH_NO_COMMAND)
+    {
+        return false;
+    }
+
+    *command = scpi_dispatch_states[state].command;
+
+    return true;
+}
+
+
+// Get the length of a well formed program header at the start of a message,
+// 0 if the lexer could read it differently
+static size_t scpi_dispatch_header_length(
+    const char* data,
+    size_t length
+) {
+    size_t i = 0;
+    bool mnemonic_start = true;
+
+    if ((i < length) && ((data[i] == ':') || (data[i] == '*')))
+    {
+        i++;
+    }
+
+    for (; i < length; i++)
+    {
+        const char c = data[i];
+
+        if (mnemonic_start)
+        {
+            if (!isalpha((unsigned char) c))
+            {
+                return 0;
+            }
+
+            mnemonic_start = false;
+        }
+        else if ((c == ':') && (data[0] != '*'))
+        {
+            mnemonic_start = true;
+        }
+        else if (c == '?')
+        {
+            i++;
+            break;
+        }
+        else if (!isalnum((unsigned char) c) && (c != '_'))
+        {
+            break;
+        }
+    }
+
+    if (mnemonic_start)
+    {
+        return 0;
+    }
+
+    // The header has to be followed by white space or the end of the message
+    if ((i < length) && (data[i] != ' ') && (data[i] != '\t') && (data[i] != '\r') && (data[i] != '\n'))
+    {
+        return 0;
+    }
+
+    return i;
+}
+
+
+// Pass a line to scpi-parser, narrowing its command list to the entry found
+// in the dispatch table. Anything but a single complete program message
+// (compound commands, partial lines, odd headers) uses the full list.
+scpi_bool_t scpi_dispatch_input(
+    scpi_t* context,
+    const char* data,
+    size_t length
+) {
+    const scpi_command_t* cmdlist = context->cmdlist;
+
+    if (scpi_dispatch_enabled &&
+        (context->buffer.position == 0) &&
+        (length > 0) &&
+        (data[length - 1] == '\n') &&
+        (memchr(data, '\n', length - 1) == NULL) &&
+        (memchr(data, ';', length) == NULL))
+    {
+        const size_t header_length = scpi_dispatch_header_length(data, length);
+        uint32_t command = 0;
+
+        if (header_length > 0)
+        {
+            // scpi-parser scans from the found entry onwards, an unknown
+            // header gets the list terminator
+            if (scpi_dispatch_find(data, header_length, &command))
+            {
+                context->cmdlist = &scpi_dispatch_commands[command];
+            }
+            else
+            {
+                context->cmdlist = &scpi_dispatch_commands[SCPI_DISPATCH_COMMANDS];
+            }
+        }
+    }
+
+    scpi_bool_t result = SCPI_Input(
+        context,
+        data,
+        length
+    );
+
+    context->cmdlist = cmdlist;
+
+    return result;
+}
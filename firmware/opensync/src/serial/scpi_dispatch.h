@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "scpi/scpi.h"
+
+
+#define SCPI_DISPATCH_NO_COMMAND 0xFFFF
+
+// Tables are generated at build time by tools/scpi_dispatch_gen.py
+struct scpi_dispatch_state
+{
+    uint16_t first_edge;
+    uint16_t edge_count;
+    uint16_t command;   // first command matching a header ending here
+};
+
+struct scpi_dispatch_edge
+{
+    char symbol;
+    uint16_t next;
+};
+
+bool scpi_dispatch_init(
+    const scpi_command_t* commands
+);
+
+bool scpi_dispatch_find(
+    const char* header,
+    size_t length,
+    uint32_t* command
+);
+
+scpi_bool_t scpi_dispatch_input(
+    scpi_t* context,
+    const char* data,
+    size_t length
+);
@@ -0,0 +1,689 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include "scpi/scpi.h"
+
+#include "scpi-def.h"
+#include "scpi_dispatch.h"
+#include "scpi_macro.h"
+
+#define SCPI_MACRO_ARGUMENTS_MAX 9
+
+struct scpi_macro
+{
+    char label[SCPI_MACRO_LABEL_MAX + 1]; // empty if the entry is free
+    char definition[SCPI_MACRO_DEFINITION_MAX];
+    size_t definition_length;
+};
+
+struct scpi_macro_argument
+{
+    const char* data;
+    size_t length;
+};
+
+static struct scpi_macro scpi_macros[SCPI_MACROS_MAX];
+static bool scpi_macros_enabled = true;
+
+// Expanded macro, handed to the parser as one program message
+static char scpi_macro_buffer[SCPI_INPUT_BUFFER_LENGTH];
+
+
+// A label is a single program mnemonic, so it never shadows a command with
+// a subsystem path or a common command
+static bool scpi_macro_label_validate(
+    const char* label,
+    size_t length
+) {
+    if ((length == 0) ||
+        (length > SCPI_MACRO_LABEL_MAX) ||
+        !isalpha((unsigned char) label[0]))
+    {
+        return false;
+    }
+
+    for (size_t i = 1; i < length; i++)
+    {
+        if (!isalnum((unsigned char) label[i]) && (label[i] != '_'))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Find a macro by its label, labels are not case sensitive
+static struct scpi_macro* scpi_macro_find(
+    const char* label,
+    size_t length
+) {
+    for (uint32_t i = 0; i < SCPI_MACROS_MAX; i++)
+    {
+        const char* entry = scpi_macros[i].label;
+
+        if ((entry[0] == '\0') || (strlen(entry) != length))
+        {
+            continue;
+        }
+
+        size_t j = 0;
+
+        while ((j < length) && (toupper((unsigned char) entry[j]) == toupper((unsigned char) label[j])))
+        {
+            j++;
+        }
+
+        if (j == length)
+        {
+            return &scpi_macros[i];
+        }
+    }
+
+    return NULL;
+}
+
+
+// Split the arguments of a macro call at commas outside of quotes and trim
+// the white space around them. Returns the number of arguments or -1 if
+// there are too many.
+static int32_t scpi_macro_arguments_get(
+    const char* data,
+    size_t length,
+    struct scpi_macro_argument arguments[SCPI_MACRO_ARGUMENTS_MAX]
+) {
+    int32_t count = 0;
+    size_t start = 0;
+    char quote = 0;
+
+    while ((length > 0) && isspace((unsigned char) data[length - 1]))
+    {
+        length--;
+    }
+
+    for (size_t i = 0; i <= length; i++)
+    {
+        if ((i < length) && (quote != 0))
+        {
+            if (data[i] == quote)
+            {
+                quote = 0;
+            }
+
+            continue;
+        }
+
+        if ((i < length) && ((data[i] == '"') || (data[i] == '\'')))
+        {
+            quote = data[i];
+            continue;
+        }
+
+        if ((i < length) && (data[i] != ','))
+        {
+            continue;
+        }
+
+        size_t end = i;
+
+        while ((start < end) && isspace((unsigned char) data[start]))
+        {
+            start++;
+        }
+
+        while ((end > start) && isspace((unsigned char) data[end - 1]))
+        {
+            end--;
+        }
+
+        // A call without arguments
+        if ((i == length) && (count == 0) && (start == end))
+        {
+            break;
+        }
+
+        if (count == SCPI_MACRO_ARGUMENTS_MAX)
+        {
+            return -1;
+        }
+
+        arguments[count].data = data + start;
+        arguments[count].length = end - start;
+        count++;
+
+        start = i + 1;
+    }
+
+    return count;
+}
+
+
+// Find the end of the message unit starting at start, the next semicolon
+// outside of strings and blocks or the end of the message
+static size_t scpi_macro_unit_end_get(
+    const char* data,
+    size_t start,
+    size_t length
+) {
+    char quote = 0;
+
+    for (size_t i = start; i < length; i++)
+    {
+        if (quote != 0)
+        {
+            if (data[i] == quote)
+            {
+                quote = 0;
+            }
+
+            continue;
+        }
+
+        if ((data[i] == '"') || (data[i] == '\''))
+        {
+            quote = data[i];
+            continue;
+        }
+
+        // Skip definite length blocks, an indefinite one ends the message
+        if ((data[i] == '#') && (i + 1 < length) && isdigit((unsigned char) data[i + 1]))
+        {
+            const size_t digits = (size_t) (data[i + 1] - '0');
+            size_t block_length = 0;
+
+            if (digits == 0)
+            {
+                return length;
+            }
+
+            for (size_t j = i + 2; (j < i + 2 + digits) && (j < length); j++)
+            {
+                block_length = block_length * 10 + (size_t) (data[j] - '0');
+            }
+
+            if (i + 2 + digits + block_length >= length)
+            {
+                return length;
+            }
+
+            i += 1 + digits + block_length;
+            continue;
+        }
+
+        if (data[i] == ';')
+        {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+
+// Find the macro a message unit calls, NULL if it is no macro call. Sets
+// arguments to the position after the label.
+static const struct scpi_macro* scpi_macro_call_find(
+    const char* data,
+    size_t length,
+    size_t* arguments
+) {
+    size_t i = 0;
+
+    while ((i < length) && isspace((unsigned char) data[i]))
+    {
+        i++;
+    }
+
+    const size_t label_start = i;
+
+    while ((i < length) && (isalnum((unsigned char) data[i]) || (data[i] == '_')))
+    {
+        i++;
+    }
+
+    // Anything but white space after the label is part of a command header
+    if ((i < length) && !isspace((unsigned char) data[i]))
+    {
+        return NULL;
+    }
+
+    *arguments = i;
+
+    return scpi_macro_find(
+        data + label_start,
+        i - label_start
+    );
+}
+
+
+// Append data to the expanded message, keeping room for the terminator.
+// Pushes an error and returns false if it does not fit.
+static bool scpi_macro_buffer_append(
+    scpi_t* context,
+    size_t* expanded,
+    const char* data,
+    size_t length
+) {
+    if (*expanded + length + 1 >= sizeof(scpi_macro_buffer))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_TOO_MUCH_DATA
+        );
+
+        return false;
+    }
+
+    memcpy(scpi_macro_buffer + *expanded, data, length);
+    *expanded += length;
+
+    return true;
+}
+
+
+// Append a message unit to the expanded message, a macro call is replaced by
+// the definition with its arguments. Pushes an error and returns false if
+// the call fails.
+static bool scpi_macro_unit_expand(
+    scpi_t* context,
+    const char* data,
+    size_t length,
+    size_t* expanded
+) {
+    struct scpi_macro_argument arguments[SCPI_MACRO_ARGUMENTS_MAX];
+    size_t i = 0;
+
+    const struct scpi_macro* macro = scpi_macro_call_find(
+        data,
+        length,
+        &i
+    );
+
+    if (macro == NULL)
+    {
+        return scpi_macro_buffer_append(
+            context,
+            expanded,
+            data,
+            length
+        );
+    }
+
+    const int32_t argument_count = scpi_macro_arguments_get(
+        data + i,
+        length - i,
+        arguments
+    );
+
+    if (argument_count < 0)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_TOO_MUCH_DATA
+        );
+
+        return false;
+    }
+
+    for (size_t j = 0; j < macro -> definition_length; j++)
+    {
+        const char* part = &macro -> definition[j];
+        size_t part_length = 1;
+
+        if ((macro -> definition[j] == '$') &&
+            (j + 1 < macro -> definition_length) &&
+            (macro -> definition[j + 1] >= '1') &&
+            (macro -> definition[j + 1] <= '9'))
+        {
+            const int32_t argument = macro -> definition[j + 1] - '1';
+
+            if (argument >= argument_count)
+            {
+                SCPI_ErrorPush(
+                    context,
+                    SCPI_ERROR_MISSING_PARAMETER
+                );
+
+                return false;
+            }
+
+            part = arguments[argument].data;
+            part_length = arguments[argument].length;
+            j++;
+        }
+
+        if (!scpi_macro_buffer_append(
+            context,
+            expanded,
+            part,
+            part_length
+        )) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// Run a message that calls macros. Every message unit that is a macro call
+// is replaced by the definition, so calls mix with commands in compound
+// messages. Returns false if the message calls no macro, so it is left to the
+// parser. Labels inside a definition are not expanded again, which rules out
+// recursion.
+bool scpi_macro_input(
+    scpi_t* context,
+    const char* data,
+    size_t length
+) {
+    size_t expanded = 0;
+    size_t arguments = 0;
+    bool called = false;
+
+    if (!scpi_macros_enabled)
+    {
+        return false;
+    }
+
+    while ((length > 0) && isspace((unsigned char) data[length - 1]))
+    {
+        length--;
+    }
+
+    for (size_t start = 0, end = 0; !called && (start <= length); start = end + 1)
+    {
+        end = scpi_macro_unit_end_get(data, start, length);
+        called = (scpi_macro_call_find(data + start, end - start, &arguments) != NULL);
+    }
+
+    if (!called)
+    {
+        return false;
+    }
+
+    // The message has been taken over, a failed call runs no part of it
+    for (size_t start = 0, end = 0; start <= length; start = end + 1)
+    {
+        end = scpi_macro_unit_end_get(data, start, length);
+
+        if (!scpi_macro_unit_expand(context, data + start, end - start, &expanded) ||
+            ((end < length) && !scpi_macro_buffer_append(context, &expanded, ";", 1)))
+        {
+            return true;
+        }
+    }
+
+    scpi_macro_buffer[expanded++] = '\n';
+    scpi_macro_buffer[expanded] = '\0';
+
+    scpi_dispatch_input(
+        context,
+        scpi_macro_buffer,
+        expanded
+    );
+
+    return true;
+}
+
+
+// Define a macro with a label and a definition, given as string or block
+scpi_result_t SCPI_MacroDefine(
+    scpi_t* context
+) {
+    const char* label = NULL;
+    size_t label_length = 0;
+    scpi_parameter_t param;
+
+    if (!SCPI_ParamCharacters(
+        context,
+        &label,
+        &label_length,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!scpi_macro_label_validate(label, label_length))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_Parameter(
+        context,
+        &param,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    const char* definition = param.ptr;
+    size_t definition_length = param.len;
+    char quote = 0;
+
+    // Strings keep their quotes in the token, blocks are passed as they are
+    if ((param.type == SCPI_TOKEN_SINGLE_QUOTE_PROGRAM_DATA) ||
+        (param.type == SCPI_TOKEN_DOUBLE_QUOTE_PROGRAM_DATA))
+    {
+        quote = definition[0];
+        definition++;
+        definition_length -= 2;
+    }
+    else if (param.type != SCPI_TOKEN_ARBITRARY_BLOCK_PROGRAM_DATA)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_TYPE_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    struct scpi_macro* macro = scpi_macro_find(label, label_length);
+
+    // Redefine the macro in place or take a free entry
+    for (uint32_t i = 0; (macro == NULL) && (i < SCPI_MACROS_MAX); i++)
+    {
+        if (scpi_macros[i].label[0] == '\0')
+        {
+            macro = &scpi_macros[i];
+        }
+    }
+
+    if (macro == NULL)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_TOO_MUCH_DATA
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[SCPI_MACRO_DEFINITION_MAX];
+    size_t length = 0;
+
+    for (size_t i = 0; i < definition_length; i++)
+    {
+        // A definition is one program message
+        if ((definition[i] == '\n') ||
+            (length == sizeof(buffer)))
+        {
+            SCPI_ErrorPush(
+                context,
+                (definition[i] == '\n') ? SCPI_ERROR_ILLEGAL_PARAMETER_VALUE : SCPI_ERROR_TOO_MUCH_DATA
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        buffer[length++] = definition[i];
+
+        // A doubled quote stands for one quote in a string
+        if ((quote != 0) && (definition[i] == quote))
+        {
+            i++;
+        }
+    }
+
+    memcpy(macro -> label, label, label_length);
+    macro -> label[label_length] = '\0';
+    memcpy(macro -> definition, buffer, length);
+    macro -> definition_length = length;
+
+    return SCPI_RES_OK;
+}
+
+
+// Enable or disable macro calls, the definitions are kept
+scpi_result_t SCPI_MacroEnable(
+    scpi_t* context
+) {
+    int32_t enabled = 0;
+
+    if (!SCPI_ParamInt32(
+        context,
+        &enabled,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    scpi_macros_enabled = (enabled != 0);
+
+    return SCPI_RES_OK;
+}
+
+
+// Query whether macro calls are enabled
+scpi_result_t SCPI_MacroEnableQ(
+    scpi_t* context
+) {
+    SCPI_ResultInt32(
+        context,
+        scpi_macros_enabled ? 1 : 0
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the definition of a macro as a block
+scpi_result_t SCPI_MacroGetQ(
+    scpi_t* context
+) {
+    const char* label = NULL;
+    size_t label_length = 0;
+
+    if (!SCPI_ParamCharacters(
+        context,
+        &label,
+        &label_length,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    const struct scpi_macro* macro = scpi_macro_find(label, label_length);
+
+    if (macro == NULL)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultArbitraryBlock(
+        context,
+        macro -> definition,
+        macro -> definition_length
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the labels of all macros, an empty string if there are none
+scpi_result_t SCPI_MacroListQ(
+    scpi_t* context
+) {
+    bool found = false;
+
+    for (uint32_t i = 0; i < SCPI_MACROS_MAX; i++)
+    {
+        if (scpi_macros[i].label[0] != '\0')
+        {
+            SCPI_ResultText(
+                context,
+                scpi_macros[i].label
+            );
+
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        SCPI_ResultText(
+            context,
+            ""
+        );
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Delete all macros
+scpi_result_t SCPI_MacroPurge(
+    scpi_t* context
+) {
+    (void) context;
+
+    memset(scpi_macros, 0, sizeof(scpi_macros));
+
+    return SCPI_RES_OK;
+}
+
+
+// Delete a single macro
+scpi_result_t SCPI_MacroRemove(
+    scpi_t* context
+) {
+    const char* label = NULL;
+    size_t label_length = 0;
+
+    if (!SCPI_ParamCharacters(
+        context,
+        &label,
+        &label_length,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct scpi_macro* macro = scpi_macro_find(label, label_length);
+
+    if (macro == NULL)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_ILLEGAL_PARAMETER_VALUE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    memset(macro, 0, sizeof(*macro));
+
+    return SCPI_RES_OK;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "scpi/scpi.h"
+
+
+// IEEE 488.2 user macros. A message that is just a macro label, optionally
+// followed by comma separated arguments, runs the definition of the macro
+// instead. "$1" to "$9" in a definition are replaced by the arguments.
+#define SCPI_MACROS_MAX 8
+#define SCPI_MACRO_LABEL_MAX 12
+#define SCPI_MACRO_DEFINITION_MAX 256
+
+bool scpi_macro_input(
+    scpi_t* context,
+    const char* data,
+    size_t length
+);
+
+scpi_result_t SCPI_MacroDefine(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroEnable(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroEnableQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroGetQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroListQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroPurge(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_MacroRemove(
+    scpi_t* context
+);
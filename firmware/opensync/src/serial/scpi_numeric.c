@@ -0,0 +1,798 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "scpi/scpi.h"
+
+#include "scpi_common.h"
+#include "scpi_numeric.h"
+
+
+/* Note:
+   Numeric program data of the sequence buffers is parsed here instead of
+   through strtod. A value is read as a decimal mantissa and a power of ten,
+   so integers and decimals convert to picoseconds with integer arithmetic
+   only, rounded to the nearest picosecond. An optional suffix sets the unit
+   of the value, otherwise the UNITs of the channel are used. CYC marks a
+   whole number of state machine cycles at the divider of the channel.
+
+   Sequence buffers keep the parsed values and convert them at APPly, so
+   values without a suffix take the units of the channel they are applied
+   to, like cycle counts take its divider.
+*/
+struct numeric_suffix_def
+{
+    const char* name;
+    uint32_t suffix;
+    int32_t exponent;
+    uint64_t multiplier;
+};
+
+static const struct numeric_suffix_def NUMERIC_SUFFIXES[] = {
+    {"PS",  NUMERIC_SUFFIX_TIME,      0,  1},
+    {"NS",  NUMERIC_SUFFIX_TIME,      3,  1},
+    {"US",  NUMERIC_SUFFIX_TIME,      6,  1},
+    {"MS",  NUMERIC_SUFFIX_TIME,      9,  1},
+    {"S",   NUMERIC_SUFFIX_TIME,      12, 1},
+    {"MIN", NUMERIC_SUFFIX_TIME,      13, 6},
+    {"H",   NUMERIC_SUFFIX_TIME,      14, 36},
+    {"HR",  NUMERIC_SUFFIX_TIME,      14, 36},
+    {"UHZ", NUMERIC_SUFFIX_FREQUENCY, -6, 1},
+    {"HZ",  NUMERIC_SUFFIX_FREQUENCY, 0,  1},
+    {"KHZ", NUMERIC_SUFFIX_FREQUENCY, 3,  1},
+    {"MHZ", NUMERIC_SUFFIX_FREQUENCY, 6,  1}, // SCPI reads MHZ as megahertz, see mHz below
+    {"CYC", NUMERIC_SUFFIX_CYCLES,    0,  1},
+};
+
+static const uint64_t NUMERIC_DIVISOR_MAX = 1000000000000000000ull; // keeps the long division remainder within 64 bits
+
+
+static bool numeric_is_digit(
+    char c
+) {
+    return (c >= '0') && (c <= '9');
+}
+
+
+static bool numeric_is_space(
+    char c
+) {
+    return (c == ' ') || (c == '\t');
+}
+
+
+static char numeric_upper(
+    char c
+) {
+    return ((c >= 'a') && (c <= 'z')) ? (char) (c - 'a' + 'A') : c;
+}
+
+
+// Look up a unit suffix, case insensitive except for the millihertz spelling mHz
+static void numeric_suffix_find(
+    const char* suffix,
+    size_t length,
+    struct numeric_value* value
+) {
+    value -> suffix = NUMERIC_SUFFIX_UNKNOWN;
+
+    if ((length == 3) && (suffix[0] == 'm') && (suffix[1] == 'H') && (suffix[2] == 'z'))
+    {
+        value -> suffix = NUMERIC_SUFFIX_FREQUENCY;
+        value -> suffix_exponent = -3;
+        value -> suffix_multiplier = 1;
+
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof(NUMERIC_SUFFIXES) / sizeof(NUMERIC_SUFFIXES[0]); i++)
+    {
+        const char* name = NUMERIC_SUFFIXES[i].name;
+        size_t j = 0;
+
+        while ((j < length) && (name[j] != '\0') && (numeric_upper(suffix[j]) == name[j]))
+        {
+            j++;
+        }
+
+        if ((j == length) && (name[j] == '\0'))
+        {
+            value -> suffix = NUMERIC_SUFFIXES[i].suffix;
+            value -> suffix_exponent = NUMERIC_SUFFIXES[i].exponent;
+            value -> suffix_multiplier = NUMERIC_SUFFIXES[i].multiplier;
+
+            return;
+        }
+    }
+}
+
+
+// Parse decimal numeric program data with an optional unit suffix, e.g.
+// "250", "12.5us", "1.2e3 kHz". Returns 0 for malformed or negative numbers.
+bool numeric_value_parse(
+    const char* text,
+    size_t length,
+    struct numeric_value* value
+) {
+    size_t i = 0;
+    uint32_t digits = 0;
+    bool has_digits = false;
+    bool fraction = false;
+
+    value -> mantissa = 0;
+    value -> exponent = 0;
+    value -> suffix = NUMERIC_SUFFIX_NONE;
+    value -> suffix_exponent = 0;
+    value -> suffix_multiplier = 1;
+
+    while ((i < length) && numeric_is_space(text[i]))
+    {
+        i++;
+    }
+
+    if ((i < length) && (text[i] == '+'))
+    {
+        i++;
+    }
+
+    // Mantissa, digits past the precision limit only move the exponent
+    for (; i < length; i++)
+    {
+        const char c = text[i];
+
+        if ((c == '.') && !fraction)
+        {
+            fraction = true;
+            continue;
+        }
+
+        if (!numeric_is_digit(c))
+        {
+            break;
+        }
+
+        has_digits = true;
+
+        if ((value -> mantissa == 0) && (c == '0'))
+        {
+            if (fraction)
+            {
+                value -> exponent--;
+            }
+
+            continue;
+        }
+
+        if (digits < NUMERIC_MANTISSA_DIGITS_MAX)
+        {
+            value -> mantissa = value -> mantissa * 10 + (uint64_t) (c - '0');
+            digits++;
+
+            if (fraction)
+            {
+                value -> exponent--;
+            }
+        }
+        else if (!fraction)
+        {
+            value -> exponent++;
+        }
+    }
+
+    if (!has_digits)
+    {
+        return 0;
+    }
+
+    // Exponent, only if followed by digits so suffixes are not mistaken for it
+    if ((i < length) && ((text[i] == 'e') || (text[i] == 'E')))
+    {
+        size_t j = i + 1;
+        bool negative = false;
+        int32_t exponent = 0;
+
+        if ((j < length) && ((text[j] == '+') || (text[j] == '-')))
+        {
+            negative = (text[j] == '-');
+            j++;
+        }
+
+        if ((j < length) && numeric_is_digit(text[j]))
+        {
+            for (; (j < length) && numeric_is_digit(text[j]); j++)
+            {
+                if (exponent < 1000)
+                {
+                    exponent = exponent * 10 + (text[j] - '0');
+                }
+            }
+
+            value -> exponent += negative ? -exponent : exponent;
+            i = j;
+        }
+    }
+
+    while ((i < length) && numeric_is_space(text[i]))
+    {
+        i++;
+    }
+
+    // Unit suffix
+    const size_t suffix_start = i;
+
+    while ((i < length) && (numeric_upper(text[i]) >= 'A') && (numeric_upper(text[i]) <= 'Z'))
+    {
+        i++;
+    }
+
+    if (i > suffix_start)
+    {
+        numeric_suffix_find(
+            &text[suffix_start],
+            i - suffix_start,
+            value
+        );
+    }
+
+    while ((i < length) && numeric_is_space(text[i]))
+    {
+        i++;
+    }
+
+    return i == length;
+}
+
+
+// Split a channel unit offset (e.g. 1000 for microseconds, 60000000000 for
+// minutes) into an integer multiplier and a power of ten
+static void numeric_unit_split(
+    uint64_t unit_offset,
+    int32_t* exponent,
+    uint64_t* multiplier
+) {
+    *exponent = 0;
+    *multiplier = unit_offset;
+
+    while ((*multiplier != 0) && (*multiplier % 10 == 0))
+    {
+        *multiplier /= 10;
+        (*exponent)++;
+    }
+}
+
+
+// Drop the last digit of the mantissa (rounded) until it times the multiplier
+// fits below limit
+static void numeric_mantissa_fit(
+    uint64_t* mantissa,
+    int32_t* exponent,
+    uint64_t multiplier,
+    uint64_t limit
+) {
+    while (*mantissa > limit / multiplier)
+    {
+        *mantissa = *mantissa / 10 + ((*mantissa % 10) >= 5);
+        (*exponent)++;
+    }
+}
+
+
+// Get mantissa * multiplier * 10^exponent rounded to the nearest integer,
+// return 0 if the result exceeds max
+static bool numeric_scale(
+    uint64_t mantissa,
+    uint64_t multiplier,
+    int32_t exponent,
+    uint64_t max,
+    uint64_t* result
+) {
+    numeric_mantissa_fit(
+        &mantissa,
+        &exponent,
+        multiplier,
+        UINT64_MAX
+    );
+
+    uint64_t scaled = mantissa * multiplier;
+
+    for (; (exponent > 0) && (scaled != 0); exponent--)
+    {
+        if (scaled > max / 10)
+        {
+            return 0;
+        }
+
+        scaled *= 10;
+    }
+
+    if (exponent < -19)
+    {
+        scaled = 0;
+    }
+    else if (exponent < 0)
+    {
+        uint64_t divisor = 1;
+
+        for (; exponent < 0; exponent++)
+        {
+            divisor *= 10;
+        }
+
+        const uint64_t remainder = scaled % divisor;
+
+        scaled = scaled / divisor + (remainder >= divisor - remainder);
+    }
+
+    if (scaled > max)
+    {
+        return 0;
+    }
+
+    *result = scaled;
+
+    return 1;
+}
+
+
+// Get 10^exponent / divisor rounded to the nearest integer with a digit by
+// digit long division, return 0 if the result exceeds max
+static bool numeric_power_divide(
+    int32_t exponent,
+    uint64_t divisor,
+    uint64_t max,
+    uint64_t* result
+) {
+    uint64_t quotient = 0;
+    uint64_t remainder = 0;
+
+    if (exponent < 0)
+    {
+        return 0;
+    }
+
+    for (int32_t i = 0; i <= exponent; i++)
+    {
+        remainder = remainder * 10 + ((i == 0) ? 1 : 0);
+
+        const uint64_t digit = remainder / divisor;
+
+        remainder %= divisor;
+
+        if (quotient > (max - digit) / 10)
+        {
+            return 0;
+        }
+
+        quotient = quotient * 10 + digit;
+    }
+
+    quotient += (remainder >= divisor - remainder);
+
+    // A frequency with a period below half a picosecond is out of range, not unset
+    if ((quotient == 0) || (quotient > max))
+    {
+        return 0;
+    }
+
+    *result = quotient;
+
+    return 1;
+}
+
+
+// Get the cycle count of a parsed value with the CYC suffix, return 0 if it
+// is not a whole number or exceeds max
+bool numeric_value_cycles_get(
+    struct numeric_value* value,
+    uint64_t max,
+    uint64_t* cycles
+) {
+    uint64_t mantissa = value -> mantissa;
+    int32_t exponent = value -> exponent;
+
+    if (value -> suffix != NUMERIC_SUFFIX_CYCLES)
+    {
+        return 0;
+    }
+
+    // Trailing zeros of the fraction, e.g. "12.0cyc"
+    for (; (exponent < 0) && (mantissa != 0) && (mantissa % 10 == 0); exponent++)
+    {
+        mantissa /= 10;
+    }
+
+    if ((mantissa != 0) && (exponent < 0))
+    {
+        return 0;
+    }
+
+    return numeric_scale(
+        mantissa,
+        1,
+        (mantissa != 0) ? exponent : 0,
+        max,
+        cycles
+    );
+}
+
+
+// Get a parsed value as a double in the base unit of its suffix (ps for
+// times, Hz for frequencies). Only used to echo cached values as entered.
+double numeric_value_double_get(
+    struct numeric_value* value
+) {
+    return (double) value -> mantissa * (double) value -> suffix_multiplier *
+        pow(10.0, value -> exponent + value -> suffix_exponent);
+}
+
+
+// Get a plain number as an unsigned fixed point value with frac_bits
+// fractional bits, rounded to the nearest step. Returns 0 if the value has a
+// suffix or exceeds max.
+bool numeric_value_fixed_get(
+    struct numeric_value* value,
+    uint32_t frac_bits,
+    uint64_t max,
+    uint64_t* fixed
+) {
+    if (value -> suffix != NUMERIC_SUFFIX_NONE)
+    {
+        return 0;
+    }
+
+    return numeric_scale(
+        value -> mantissa,
+        1ull << frac_bits,
+        value -> exponent,
+        max,
+        fixed
+    );
+}
+
+
+// Convert a parsed time to picoseconds. Values without a suffix are in units
+// of unit_offset nanoseconds.
+bool numeric_value_picos_get(
+    struct numeric_value* value,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+) {
+    int32_t exponent = value -> suffix_exponent;
+    uint64_t multiplier = value -> suffix_multiplier;
+
+    if (value -> suffix == NUMERIC_SUFFIX_NONE)
+    {
+        numeric_unit_split(
+            unit_offset,
+            &exponent,
+            &multiplier
+        );
+
+        exponent += 3; // ns to ps
+    }
+    else if (value -> suffix != NUMERIC_SUFFIX_TIME)
+    {
+        return 0;
+    }
+
+    return numeric_scale(
+        value -> mantissa,
+        multiplier,
+        value -> exponent + exponent,
+        PICOS_MAX,
+        picoseconds
+    );
+}
+
+
+// Convert a parsed frequency to a period in picoseconds, 0 for a frequency of
+// 0. Values without a suffix are in units of unit_offset hertz, values with a
+// time suffix are taken as the period itself.
+bool numeric_value_period_picos_get(
+    struct numeric_value* value,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+) {
+    int32_t exponent = value -> suffix_exponent;
+    uint64_t multiplier = value -> suffix_multiplier;
+    uint64_t mantissa = value -> mantissa;
+    int32_t value_exponent = value -> exponent;
+
+    if (value -> suffix == NUMERIC_SUFFIX_TIME)
+    {
+        return numeric_value_picos_get(
+            value,
+            unit_offset,
+            picoseconds
+        );
+    }
+
+    if (value -> suffix == NUMERIC_SUFFIX_NONE)
+    {
+        numeric_unit_split(
+            unit_offset,
+            &exponent,
+            &multiplier
+        );
+    }
+    else if (value -> suffix != NUMERIC_SUFFIX_FREQUENCY)
+    {
+        return 0;
+    }
+
+    if (mantissa == 0)
+    {
+        *picoseconds = 0;
+
+        return 1;
+    }
+
+    numeric_mantissa_fit(
+        &mantissa,
+        &value_exponent,
+        multiplier,
+        NUMERIC_DIVISOR_MAX
+    );
+
+    // period = 10^12 / (mantissa * multiplier * 10^(value_exponent + exponent))
+    return numeric_power_divide(
+        12 - value_exponent - exponent,
+        mantissa * multiplier,
+        PICOS_MAX,
+        picoseconds
+    );
+}
+
+
+// Read the next numeric parameter, pushing the matching SCPI error if it is
+// not a valid number. Returns 0 if there is no parameter or it is invalid.
+static bool numeric_param_get(
+    scpi_t* context,
+    struct numeric_value* value,
+    scpi_bool_t mandatory,
+    bool* found
+) {
+    scpi_parameter_t param;
+
+    *found = false;
+
+    if (!SCPI_Parameter(
+        context,
+        &param,
+        mandatory
+    )) {
+        return 0;
+    }
+
+    *found = true;
+
+    if ((param.type != SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA) &&
+        (param.type != SCPI_TOKEN_DECIMAL_NUMERIC_PROGRAM_DATA_WITH_SUFFIX))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_TYPE_ERROR
+        );
+
+        return 0;
+    }
+
+    if (!numeric_value_parse(
+        param.ptr,
+        param.len,
+        value
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_NUMERIC_DATA_ERROR
+        );
+
+        return 0;
+    }
+
+    if (value -> suffix == NUMERIC_SUFFIX_UNKNOWN)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_INVALID_SUFFIX
+        );
+
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Read a parameter list of times or frequencies. The values are kept as
+// parsed and converted when they are applied.
+static bool numeric_param_array_get(
+    scpi_t* context,
+    struct numeric_value* values,
+    size_t length,
+    size_t* read,
+    scpi_bool_t mandatory,
+    bool period,
+    bool cycles
+) {
+    bool found = false;
+
+    *read = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        struct numeric_value* value = &values[i];
+        uint64_t count = 0;
+
+        if (!numeric_param_get(
+            context,
+            value,
+            (i == 0) ? mandatory : FALSE,
+            &found
+        )) {
+            // The list simply ended
+            if (!found && ((i > 0) || !mandatory))
+            {
+                return 1;
+            }
+
+            return 0;
+        }
+
+        // Delays only take time suffixes, clock entries take both
+        if ((!period && (value -> suffix == NUMERIC_SUFFIX_FREQUENCY)) ||
+            (!cycles && (value -> suffix == NUMERIC_SUFFIX_CYCLES)))
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_INVALID_SUFFIX
+            );
+
+            return 0;
+        }
+
+        // Cycle counts are whole numbers
+        if ((value -> suffix == NUMERIC_SUFFIX_CYCLES) &&
+            !numeric_value_cycles_get(value, CLOCK_CYCLES_EXTENDED_MAX, &count))
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return 0;
+        }
+
+        (*read)++;
+    }
+
+    return 1;
+}
+
+
+// Read a single time parameter into picoseconds
+bool SCPI_ParamPicos(
+    scpi_t* context,
+    uint64_t* picoseconds,
+    uint64_t unit_offset,
+    scpi_bool_t mandatory
+) {
+    struct numeric_value value;
+    size_t read = 0;
+
+    if (!numeric_param_array_get(
+        context,
+        &value,
+        1,
+        &read,
+        mandatory,
+        false,
+        false
+    ) || (read != 1)) {
+        return 0;
+    }
+
+    if (!numeric_value_picos_get(
+        &value,
+        unit_offset,
+        picoseconds
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Read a single plain number into an unsigned fixed point value with
+// frac_bits fractional bits, rounded to the nearest step
+bool SCPI_ParamFixed(
+    scpi_t* context,
+    uint64_t* fixed,
+    uint32_t frac_bits,
+    uint64_t max,
+    scpi_bool_t mandatory
+) {
+    struct numeric_value value;
+    bool found = false;
+
+    if (!numeric_param_get(
+        context,
+        &value,
+        mandatory,
+        &found
+    )) {
+        return 0;
+    }
+
+    if (value.suffix != NUMERIC_SUFFIX_NONE)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_INVALID_SUFFIX
+        );
+
+        return 0;
+    }
+
+    if (!numeric_value_fixed_get(
+        &value,
+        frac_bits,
+        max,
+        fixed
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Read a list of times or cycle counts
+bool SCPI_ParamArrayTimes(
+    scpi_t* context,
+    struct numeric_value* values,
+    size_t length,
+    size_t* read,
+    scpi_bool_t mandatory
+) {
+    return numeric_param_array_get(
+        context,
+        values,
+        length,
+        read,
+        mandatory,
+        false,
+        true
+    );
+}
+
+
+// Read a list of frequencies, periods with a time suffix or periods in cycles
+bool SCPI_ParamArrayPeriods(
+    scpi_t* context,
+    struct numeric_value* values,
+    size_t length,
+    size_t* read,
+    scpi_bool_t mandatory
+) {
+    return numeric_param_array_get(
+        context,
+        values,
+        length,
+        read,
+        mandatory,
+        true,
+        true
+    );
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "scpi/scpi.h"
+
+
+#define NUMERIC_MANTISSA_DIGITS_MAX 18
+
+typedef enum {
+    NUMERIC_SUFFIX_NONE = 0,
+    NUMERIC_SUFFIX_TIME,
+    NUMERIC_SUFFIX_FREQUENCY,
+    NUMERIC_SUFFIX_CYCLES,
+    NUMERIC_SUFFIX_UNKNOWN
+} numeric_suffix_t;
+
+struct numeric_value
+{
+    uint64_t mantissa;
+    int32_t exponent;
+    uint32_t suffix;
+    int32_t suffix_exponent;    // power of ten of the suffix unit (ps for times, Hz for frequencies)
+    uint64_t suffix_multiplier; // extra integer factor of the suffix unit (min and h)
+};
+
+bool numeric_value_parse(
+    const char* text,
+    size_t length,
+    struct numeric_value* value
+);
+
+bool numeric_value_cycles_get(
+    struct numeric_value* value,
+    uint64_t max,
+    uint64_t* cycles
+);
+
+double numeric_value_double_get(
+    struct numeric_value* value
+);
+
+bool numeric_value_fixed_get(
+    struct numeric_value* value,
+    uint32_t frac_bits,
+    uint64_t max,
+    uint64_t* fixed
+);
+
+bool numeric_value_picos_get(
+    struct numeric_value* value,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+);
+
+bool numeric_value_period_picos_get(
+    struct numeric_value* value,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+);
+
+bool SCPI_ParamPicos(
+    scpi_t* context,
+    uint64_t* picoseconds,
+    uint64_t unit_offset,
+    scpi_bool_t mandatory
+);
+
+bool SCPI_ParamFixed(
+    scpi_t* context,
+    uint64_t* fixed,
+    uint32_t frac_bits,
+    uint64_t max,
+    scpi_bool_t mandatory
+);
+
+bool SCPI_ParamArrayTimes(
+    scpi_t* context,
+    struct numeric_value* values,
+    size_t length,
+    size_t* read,
+    scpi_bool_t mandatory
+);
+
+bool SCPI_ParamArrayPeriods(
+    scpi_t* context,
+    struct numeric_value* values,
+    size_t length,
+    size_t* read,
+    scpi_bool_t mandatory
+);
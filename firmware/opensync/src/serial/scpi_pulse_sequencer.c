@@ -11,13 +11,22 @@
 #include "structs/clock_config.h"
 #include "structs/pulse_config.h"
 #include "sequencer/sequencer_common.h"
+#include "sequencer/sequencer_latency.h"
+#include "sequencer/sequencer_output.h"
+#include "sequencer/sequencer_repeat.h"
+#include "status/scan_status.h"
 #include "scpi_common.h"
+#include "scpi_numeric.h"
+#include "scpi_channel_list.h"
 
-static double   pulse_sequence_buffer_delay[PULSE_INSTRUCTIONS_MAX / 2 - 1] = {0.0};
-static uint32_t pulse_sequence_buffer_output[PULSE_INSTRUCTIONS_MAX / 2 - 1] = {0};
+static struct numeric_value pulse_sequence_buffer_delay[PULSE_PACKED_STATES_MAX] = {0}; // converted at APPly
+static uint32_t pulse_sequence_buffer_output[PULSE_PACKED_STATES_MAX] = {0};
 static size_t  pulse_sequence_buffer_output_read = 0;
 static size_t  pulse_sequence_buffer_delay_read = 0;
-const uint32_t pulse_sequence_buffer_size = PULSE_INSTRUCTIONS_MAX / 2 - 1;
+static uint32_t pulse_sequence_repeat_states = 0;
+static uint32_t pulse_sequence_repeat_count = 0;
+static int32_t pulse_sequence_applied_error[PULSES_MAX][PULSE_PACKED_STATES_MAX] = {{0}};
+const uint32_t pulse_sequence_buffer_size = PULSE_PACKED_STATES_MAX;
 const uint32_t OFFSET_TERM = 2; // offset from last valid instruction of buffer
 
 // This is used in the INSTructions submodule for stateful operation.
@@ -41,38 +50,59 @@ void pulse_sequencer_cache_delay_clear()
 {
     for (uint32_t i = 0; i < pulse_sequence_buffer_size; i++)
     {
-        pulse_sequence_buffer_delay[i] = 0.0;
+        pulse_sequence_buffer_delay[i] = (struct numeric_value) {0};
     }
 
     pulse_sequence_buffer_delay_read = 0;
 }
 
 
+// Function to clear the cached repeat block
+void pulse_sequencer_cache_repeat_clear()
+{
+    pulse_sequence_repeat_states = 0;
+    pulse_sequence_repeat_count = 0;
+}
+
+
 // Clear all the pulse instructions cache
 void pulse_sequencer_cache_clear()
 {
     pulse_sequencer_cache_output_clear();
     pulse_sequencer_cache_delay_clear();
+    pulse_sequencer_cache_repeat_clear();
 }
 
 
-// Get pulse id from context and validate it. 
+// Write a single standard or packed state to the instruction buffer
+void pulse_state_encode(
+    uint32_t* words,
+    uint32_t instruction_format,
+    uint32_t output,
+    uint64_t cycles
+) {
+    if (instruction_format == PULSE_FORMAT_PACKED)
+    {
+        words[0] = output | ((uint32_t) (cycles - PULSE_INSTRUCTION_OFFSET) << PULSE_PACKED_STATE_BITS);
+    }
+    else
+    {
+        words[0] = output;
+        words[1] = (uint32_t) (cycles - PULSE_INSTRUCTION_OFFSET);
+    }
+}
+
+
+// Get pulse id from context and validate it, also while running.
 // If valid, change pulse_id to that value
-bool SCPI_check_pulse_id_and_append_error(
+static bool SCPI_pulse_id_get_and_append_error(
     scpi_t* context,
     uint32_t* pulse_id
 ) {
     // Allocate some variables
     int32_t numbers[1] = {0};
-    int32_t choice = 0;
     uint32_t pulse_id_res = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
-    if (SCPI_check_running_and_append_error(context))
-    {
-        return SCPI_RES_ERR;
-    }
-
     // Get clock sequencer ID
     SCPI_CommandNumbers(
         context,
@@ -92,6 +122,9 @@ bool SCPI_check_pulse_id_and_append_error(
         pulse_id_res = (uint32_t) numbers[0];
     }
 
+    // A channel list run overrides both
+    channel_list_id_get(&pulse_id_res);
+
     // Validate the ID
     if (!pulse_id_validate(pulse_id_res))
     {
@@ -109,6 +142,25 @@ bool SCPI_check_pulse_id_and_append_error(
 }
 
 
+// Get pulse id from context and validate it. 
+// If valid, change pulse_id to that value
+bool SCPI_check_pulse_id_and_append_error(
+    scpi_t* context,
+    uint32_t* pulse_id
+) {
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_pulse_id_get_and_append_error(
+        context,
+        pulse_id
+    );
+}
+
+
 // Set the stateful ID of a clock sequencer
 scpi_result_t SCPI_PulseIndex(
     scpi_t* context
@@ -345,17 +397,17 @@ scpi_result_t SCPI_PulsePinQ(
 }
 
 
-// Set clock divider at pulse sequencer N
-scpi_result_t SCPI_PulseClockDivider(
+// Set external trigger input at pulse sequencer N. The pulse sequence fires
+// directly on the external trigger, bypassing the clock sequencers.
+scpi_result_t SCPI_PulsePinExternal(
     scpi_t* context
 ) {
     // Allocate some variables
     int32_t numbers[1] = {0};
-    int32_t choice = 0;
     uint32_t pulse_id = 0;
-    uint32_t clock_divider = 1;
+    uint32_t param = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    /// If the system status is note (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
     {
         return SCPI_RES_ERR;
@@ -369,37 +421,15 @@ scpi_result_t SCPI_PulseClockDivider(
         return SCPI_RES_ERR;
     }
 
-    // Valid clock cycle resolution choices
-    const scpi_choice_def_t options[] = {
-        {"HIGH",                CLOCK_DIV_RES_HIGH},
-        {"HIGH_RES",            CLOCK_DIV_RES_HIGH},
-        {"MED",                 CLOCK_DIV_RES_MED},
-        {"MED_RES",             CLOCK_DIV_RES_MED},
-        {"LOW",                 CLOCK_DIV_RES_LOW},
-        {"LOW_RES",             CLOCK_DIV_RES_LOW},
-        {"VERY_LOW",            CLOCK_DIV_RES_VERY_LOW},
-        {"VERY_LOW_RES",        CLOCK_DIV_RES_VERY_LOW},
-        {"VERY_VERY_LOW",       CLOCK_DIV_RES_VERY_VERY_LOW},
-        {"VERY_VERY_LOW_RES",   CLOCK_DIV_RES_VERY_VERY_LOW},
-        SCPI_CHOICE_LIST_END
-    };
-
-    // Now get the clock divider if present
-    if (!SCPI_ParamChoice(
-        context,
-        options,
-        &choice,
-        TRUE
-    )) {
+    // Now get the trigger input if present
+    if (!SCPI_ParamUInt32(context, &param, TRUE))
+    {
         return SCPI_RES_ERR;
     }
 
-    // Cast choice into usable clock divider type
-    clock_divider = (uint32_t) choice;
-
-    bool success = pulse_divider_set(
+    bool success = pulse_pin_trigger_set(
         pulse_id,
-        clock_divider
+        param
     );
 
     // If for some wierd reason we failed, raise an error
@@ -417,8 +447,9 @@ scpi_result_t SCPI_PulseClockDivider(
 }
 
 
-// Query clock divider at pulse sequencer N
-scpi_result_t SCPI_PulseClockDividerQ(
+// Query the external trigger input pulse sequencer N listens to, -1 if it
+// listens to a clock sequencer
+scpi_result_t SCPI_PulsePinExternalQ(
     scpi_t* context
 ) {
     // Allocate some variables
@@ -436,30 +467,37 @@ scpi_result_t SCPI_PulseClockDividerQ(
     // Retrieve pulse sequencer container
     struct pulse_config* config_array = sequencer_pulse_config_get();
 
-    // Get the clock divider of the pulse sequencer at pulse_id
-    uint32_t clock_divider = config_array[pulse_id].clock_divider;
+    int32_t trigger_id = -1;
 
-    // Return as uint32
-    SCPI_ResultUInt32(
+    for (uint32_t i = 0; i < TRIGGERS_MAX; i++)
+    {
+        if ((config_array[pulse_id].input_source == PULSE_INPUT_EXTERNAL) &&
+            (config_array[pulse_id].clock_pin == EXTERNAL_TRIGGER_PINS[i]))
+        {
+            trigger_id = (int32_t) EXTERNAL_TRIGGER_IDS[i];
+        }
+    }
+
+    SCPI_ResultInt32(
         context,
-        clock_divider
+        trigger_id
     );
     
     return SCPI_RES_OK;
 }
 
 
-// Set pulse data at pulse sequencer N
-scpi_result_t SCPI_PulseUnits(
+// Set clock sequencer M as IRQ input of pulse sequencer N. The pulse sequence
+// fires on the PIO IRQ flag of the clock instead of its internal pin.
+scpi_result_t SCPI_PulsePinIrq(
     scpi_t* context
 ) {
     // Allocate some variables
     int32_t numbers[1] = {0};
-    int32_t choice = 0;
     uint32_t pulse_id = 0;
-    uint64_t unit_offset = 0;
+    uint32_t param = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    /// If the system status is note (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
     {
         return SCPI_RES_ERR;
@@ -473,55 +511,15 @@ scpi_result_t SCPI_PulseUnits(
         return SCPI_RES_ERR;
     }
 
-    // Valid clock cycle resolution choices
-    const scpi_choice_def_t options[] = {
-        {"NS",  NANOSECOND},
-        {"US",  MICROSECOND},
-        {"MS",  MILLISECOND},
-        {"S",   SECOND},
-        {"M",   MINUTE},
-        {"H",   HOUR},
-        SCPI_CHOICE_LIST_END
-    };
-
-    // Now get the clock divider if present
-    if (!SCPI_ParamChoice(
-        context,
-        options,
-        &choice,
-        TRUE
-    )) {
-        return SCPI_RES_ERR;
-    }
-
-    switch (choice)
+    // Now get the clock ID if present
+    if (!SCPI_ParamUInt32(context, &param, TRUE))
     {
-        case NANOSECOND:
-            unit_offset = OFFSET_NANOSECOND;
-            break;
-        case MICROSECOND:
-            unit_offset = OFFSET_MICROSECOND;
-            break;
-        case MILLISECOND:
-            unit_offset = OFFSET_MILLISECOND;
-            break;
-        case SECOND:
-            unit_offset = OFFSET_SECOND;
-            break;
-        case MINUTE:
-            unit_offset = OFFSET_MINUTE;
-            break;
-        case HOUR:
-            unit_offset = OFFSET_HOUR;
-            break;
-        default:
-            unit_offset = OFFSET_NANOSECOND;
+        return SCPI_RES_ERR;
     }
 
-    // Cast choice into usable clock divider type
-    bool success = pulse_unit_offset_set(
+    bool success = pulse_irq_clock_set(
         pulse_id,
-        unit_offset
+        param
     );
 
     // If for some wierd reason we failed, raise an error
@@ -539,8 +537,9 @@ scpi_result_t SCPI_PulseUnits(
 }
 
 
-// Query pulse data units offset at pulse sequencer N
-scpi_result_t SCPI_PulseUnitsQ(
+// Query the clock sequencer pulse sequencer N listens to through its IRQ
+// flag, -1 if it doesn't use an IRQ flag
+scpi_result_t SCPI_PulsePinIrqQ(
     scpi_t* context
 ) {
     // Allocate some variables
@@ -558,26 +557,35 @@ scpi_result_t SCPI_PulseUnitsQ(
     // Retrieve pulse sequencer container
     struct pulse_config* config_array = sequencer_pulse_config_get();
 
-    // Get the clock divider of the pulse sequencer at pulse_id
-    double unit_offset = config_array[pulse_id].unit_offset;
+    int32_t clock_id = -1;
 
-    // Return as uint32
-    SCPI_ResultDouble(
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        if ((config_array[pulse_id].input_source == PULSE_INPUT_CLOCK_IRQ) &&
+            (config_array[pulse_id].clock_pin == INTERNAL_CLOCK_PINS[i]))
+        {
+            clock_id = (int32_t) i;
+        }
+    }
+
+    SCPI_ResultInt32(
         context,
-        unit_offset
+        clock_id
     );
     
     return SCPI_RES_OK;
 }
 
 
-// Write pulse output instructions to cache
-scpi_result_t SCPI_PulseDataOutput(
+// Set clock divider at pulse sequencer N
+scpi_result_t SCPI_PulseClockDivider(
     scpi_t* context
 ) {
     // Allocate some variables
     int32_t numbers[1] = {0};
+    int32_t choice = 0;
     uint32_t pulse_id = 0;
+    uint32_t clock_divider = 1;
 
     // If the system status is note (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
@@ -585,7 +593,7 @@ scpi_result_t SCPI_PulseDataOutput(
         return SCPI_RES_ERR;
     }
 
-    // Get pulse sequencer ID (Not used right now)
+    // Get pulse sequencer ID
     if (SCPI_check_pulse_id_and_append_error(
         context,
         &pulse_id
@@ -593,73 +601,101 @@ scpi_result_t SCPI_PulseDataOutput(
         return SCPI_RES_ERR;
     }
 
-    // Reset the buffer
-    pulse_sequencer_cache_output_clear();
+    // Valid clock cycle resolution choices
+    const scpi_choice_def_t options[] = {
+        {"HIGH",                CLOCK_DIV_RES_HIGH},
+        {"HIGH_RES",            CLOCK_DIV_RES_HIGH},
+        {"MED",                 CLOCK_DIV_RES_MED},
+        {"MED_RES",             CLOCK_DIV_RES_MED},
+        {"LOW",                 CLOCK_DIV_RES_LOW},
+        {"LOW_RES",             CLOCK_DIV_RES_LOW},
+        {"VERY_LOW",            CLOCK_DIV_RES_VERY_LOW},
+        {"VERY_LOW_RES",        CLOCK_DIV_RES_VERY_LOW},
+        {"VERY_VERY_LOW",       CLOCK_DIV_RES_VERY_VERY_LOW},
+        {"VERY_VERY_LOW_RES",   CLOCK_DIV_RES_VERY_VERY_LOW},
+        SCPI_CHOICE_LIST_END
+    };
 
-    // Now get the instruction buffer, if present
-    if (!SCPI_ParamArrayUInt32(
+    // Now get the clock divider if present
+    if (!SCPI_ParamChoice(
         context,
-        pulse_sequence_buffer_output,
-        pulse_sequence_buffer_size,
-        &pulse_sequence_buffer_output_read,
-        0, // scpi array format type??
+        options,
+        &choice,
         TRUE
     )) {
         return SCPI_RES_ERR;
     }
 
+    // Cast choice into usable clock divider type
+    clock_divider = (uint32_t) choice;
+
+    bool success = pulse_divider_set(
+        pulse_id,
+        clock_divider
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
     return SCPI_RES_OK;
 }
 
 
-// Query pulse output instructions from cache
-scpi_result_t SCPI_PulseDataOutputQ(
+// Query clock divider at pulse sequencer N
+scpi_result_t SCPI_PulseClockDividerQ(
     scpi_t* context
 ) {
     // Allocate some variables
     int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
-    if (SCPI_check_running_and_append_error(context))
-    {
-        return SCPI_RES_ERR;
-    }
-
-    // Get pulse sequencer ID (Not currently used)
+    // Get pulse sequencer ID
     if (SCPI_check_pulse_id_and_append_error(
         context,
         &pulse_id
     )) {
         return SCPI_RES_ERR;
     }
-    
-    SCPI_ResultArrayUInt32(
+
+    // Retrieve pulse sequencer container
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    // Get the clock divider of the pulse sequencer at pulse_id
+    uint32_t clock_divider = config_array[pulse_id].clock_divider;
+
+    // Return as uint32
+    SCPI_ResultUInt32(
         context,
-        pulse_sequence_buffer_output,
-        pulse_sequence_buffer_size,
-        0 // what is scpi array format??
+        clock_divider
     );
-
+    
     return SCPI_RES_OK;
 }
 
 
-// Write pulse delay instructions to cache
-scpi_result_t SCPI_PulseDataDelay(
+// Set a fractional clock divider (8 fractional bits) at pulse sequencer N
+scpi_result_t SCPI_PulseClockDividerValue(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
+    uint64_t clock_divider_fixed = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
     {
         return SCPI_RES_ERR;
     }
 
-    // Get pulse sequencer ID (Not used right now)
+    // Get pulse sequencer ID
     if (SCPI_check_pulse_id_and_append_error(
         context,
         &pulse_id
@@ -667,24 +703,309 @@ scpi_result_t SCPI_PulseDataDelay(
         return SCPI_RES_ERR;
     }
 
-    // Clear delay cache
-    pulse_sequencer_cache_delay_clear();
-
-    // Now get the instruction buffer, if present
-    if (!SCPI_ParamArrayDouble(
+    // Round to the nearest divider the hardware can represent
+    if (!SCPI_ParamFixed(
         context,
-        pulse_sequence_buffer_delay,
-        pulse_sequence_buffer_size,
-        &pulse_sequence_buffer_delay_read,
-        0, // scpi array format type??
+        &clock_divider_fixed,
+        CLOCK_DIVIDER_FRAC_BITS,
+        UINT32_MAX,
         TRUE
     )) {
         return SCPI_RES_ERR;
     }
 
-    return SCPI_RES_OK;
-}
-
+    if (!clock_divider_fixed_validate((uint32_t) clock_divider_fixed))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    bool success = pulse_divider_fixed_set(
+        pulse_id,
+        (uint32_t) clock_divider_fixed
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the fractional clock divider at pulse sequencer N
+scpi_result_t SCPI_PulseClockDividerValueQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    SCPI_ResultDouble(
+        context,
+        config_array[pulse_id].clock_divider + (double) config_array[pulse_id].clock_divider_frac / (1u << CLOCK_DIVIDER_FRAC_BITS)
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Set pulse data at pulse sequencer N
+scpi_result_t SCPI_PulseUnits(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    int32_t choice = 0;
+    uint32_t pulse_id = 0;
+    uint64_t unit_offset = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Valid clock cycle resolution choices
+    const scpi_choice_def_t options[] = {
+        {"NS",  NANOSECOND},
+        {"US",  MICROSECOND},
+        {"MS",  MILLISECOND},
+        {"S",   SECOND},
+        {"M",   MINUTE},
+        {"H",   HOUR},
+        SCPI_CHOICE_LIST_END
+    };
+
+    // Now get the clock divider if present
+    if (!SCPI_ParamChoice(
+        context,
+        options,
+        &choice,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    switch (choice)
+    {
+        case NANOSECOND:
+            unit_offset = OFFSET_NANOSECOND;
+            break;
+        case MICROSECOND:
+            unit_offset = OFFSET_MICROSECOND;
+            break;
+        case MILLISECOND:
+            unit_offset = OFFSET_MILLISECOND;
+            break;
+        case SECOND:
+            unit_offset = OFFSET_SECOND;
+            break;
+        case MINUTE:
+            unit_offset = OFFSET_MINUTE;
+            break;
+        case HOUR:
+            unit_offset = OFFSET_HOUR;
+            break;
+        default:
+            unit_offset = OFFSET_NANOSECOND;
+    }
+
+    // Cast choice into usable clock divider type
+    bool success = pulse_unit_offset_set(
+        pulse_id,
+        unit_offset
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query pulse data units offset at pulse sequencer N
+scpi_result_t SCPI_PulseUnitsQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve pulse sequencer container
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    // Get the clock divider of the pulse sequencer at pulse_id
+    uint64_t unit_offset = config_array[pulse_id].unit_offset;
+
+    // Return as uint32
+    SCPI_ResultDouble(
+        context,
+        (double) unit_offset
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
+// Write pulse output instructions to cache
+scpi_result_t SCPI_PulseDataOutput(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not used right now)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Reset the buffer
+    pulse_sequencer_cache_output_clear();
+
+    // Now get the instruction buffer, if present
+    if (!SCPI_ParamArrayUInt32(
+        context,
+        pulse_sequence_buffer_output,
+        pulse_sequence_buffer_size,
+        &pulse_sequence_buffer_output_read,
+        0, // scpi array format type??
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query pulse output instructions from cache
+scpi_result_t SCPI_PulseDataOutputQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+    
+    SCPI_ResultArrayUInt32(
+        context,
+        pulse_sequence_buffer_output,
+        pulse_sequence_buffer_size,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Write pulse delay instructions to cache
+scpi_result_t SCPI_PulseDataDelay(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not used right now)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Clear delay cache
+    pulse_sequencer_cache_delay_clear();
+
+    // Now get the instruction buffer, if present. Values without a unit suffix
+    // take the units of the pulse sequencer they are applied to.
+    if (!SCPI_ParamArrayTimes(
+        context,
+        pulse_sequence_buffer_delay,
+        pulse_sequence_buffer_size,
+        &pulse_sequence_buffer_delay_read,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
 
 // Query pulse delay instructions from cache
 scpi_result_t SCPI_PulseDataDelayQ(
@@ -694,47 +1015,1270 @@ scpi_result_t SCPI_PulseDataDelayQ(
     int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
-    if (SCPI_check_running_and_append_error(context))
-    {
-        return SCPI_RES_ERR;
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+        config_array[pulse_id].clock_divider,
+        config_array[pulse_id].clock_divider_frac
+    );
+    const uint64_t picos_per_unit = config_array[pulse_id].unit_offset * PICOS_PER_NANOSECOND;
+
+    double delays[PULSE_PACKED_STATES_MAX] = {0.0};
+
+    // Report the cached delays in the current pulse units, cycle counts at the
+    // current divider. Delays are converted in integer picoseconds, plain
+    // numbers are echoed as entered.
+    for (uint32_t i = 0; i < pulse_sequence_buffer_size; i++)
+    {
+        struct numeric_value* delay = &pulse_sequence_buffer_delay[i];
+        uint64_t picoseconds = 0;
+        uint64_t cycles = 0;
+
+        switch (delay -> suffix)
+        {
+            case NUMERIC_SUFFIX_TIME:
+                numeric_value_picos_get(delay, config_array[pulse_id].unit_offset, &picoseconds);
+                break;
+
+            case NUMERIC_SUFFIX_CYCLES:
+                // Counts past the picosecond range of a delay are not reported
+                if (numeric_value_cycles_get(delay, clock_cycles_nearest_get(PICOS_MAX, cycle_nanos_fixed), &cycles))
+                {
+                    picoseconds = clock_cycles_picos_get(cycles, cycle_nanos_fixed);
+                }
+                break;
+
+            default:
+                delays[i] = numeric_value_double_get(delay);
+                continue;
+        }
+
+        delays[i] = (double) picoseconds / picos_per_unit;
+    }
+
+    SCPI_ResultArrayDouble(
+        context,
+        delays,
+        pulse_sequence_buffer_size,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Clear the instructions in cache
+scpi_result_t SCPI_PulseDataClear(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+    size_t instructions_read=0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Reset the buffer
+    pulse_sequencer_cache_output_clear();
+    pulse_sequencer_cache_delay_clear();
+    pulse_sequencer_cache_repeat_clear();
+
+    return SCPI_RES_OK;
+}
+
+
+// Write the repeat block to cache: the last N states run M times
+scpi_result_t SCPI_PulseDataRepeat(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &repeat_states,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &repeat_count,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Zero states disable the repeat block again
+    if ((repeat_states > pulse_sequence_buffer_size) ||
+        ((repeat_states > 0) && ((repeat_count == 0) || (repeat_count > PULSE_REPEAT_COUNT_MAX))))
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    pulse_sequence_repeat_states = repeat_states;
+    pulse_sequence_repeat_count = (repeat_states > 0) ? repeat_count : 0;
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the repeat block in cache
+scpi_result_t SCPI_PulseDataRepeatQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultUInt32(
+        context,
+        pulse_sequence_repeat_states
+    );
+
+    SCPI_ResultUInt32(
+        context,
+        pulse_sequence_repeat_count
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Keep the per state quantization errors of the last successful APPly
+void pulse_sequence_applied_error_set(
+    uint32_t pulse_id,
+    int32_t errors[PULSE_PACKED_STATES_MAX]
+) {
+    for (uint32_t i = 0; i < pulse_sequence_buffer_size; i++)
+    {
+        pulse_sequence_applied_error[pulse_id][i] = errors[i];
+    }
+}
+
+
+// Convert a cached delay to cycles at the units and divider of a pulse
+// sequencer. Cycle counts are taken as they are and report 0 picoseconds.
+static bool pulse_sequence_delay_cycles_get(
+    struct pulse_config* config,
+    struct numeric_value* delay,
+    uint64_t* picoseconds,
+    uint64_t* cycles
+) {
+    *picoseconds = 0;
+
+    if (delay -> suffix == NUMERIC_SUFFIX_CYCLES)
+    {
+        return numeric_value_cycles_get(
+            delay,
+            CLOCK_CYCLES_EXTENDED_MAX,
+            cycles
+        );
+    }
+
+    return numeric_value_picos_get(
+            delay,
+            config -> unit_offset,
+            picoseconds
+        ) &&
+        convert_picos_to_cycles_extended(
+            *picoseconds,
+            config -> clock_divider,
+            config -> clock_divider_frac,
+            cycles
+        );
+}
+
+
+// Apply currently cached instructions to pulse sequencer N
+scpi_result_t SCPI_PulseDataApply(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+    uint64_t delay_cycles = 0;
+    uint64_t state_cycles[PULSE_PACKED_STATES_MAX] = {0};
+    int32_t state_errors[PULSE_PACKED_STATES_MAX] = {0};
+    bool state_set[PULSE_PACKED_STATES_MAX] = {0};
+    uint64_t delay_picos = 0;
+    uint64_t first_cycles = 0;
+    uint32_t states_used = 0;
+    uint32_t states_max = PULSE_STANDARD_STATES_MAX;
+    uint32_t instruction_format = PULSE_FORMAT_STANDARD;
+    uint32_t instruction_words = PULSE_INSTRUCTIONS_MAX;
+    bool extended = false;
+    bool packed = true;
+    bool fast = false;
+
+    uint32_t local_buffer[PULSE_INSTRUCTIONS_MAX] = {};
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID (Not currently used)
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Make sure both instruction buffers have read same number of elements
+    if (pulse_sequence_buffer_output_read != pulse_sequence_buffer_delay_read)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_LISTS_NOT_SAME_LENGTH
+        );
+
+        return SCPI_RES_ERR;
+    }
+ 
+    // Now get unit conversion paramerters
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    const uint clock_divider = config_array[pulse_id].clock_divider;
+    const uint clock_divider_frac = config_array[pulse_id].clock_divider_frac;
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(clock_divider, clock_divider_frac);
+    const uint32_t input_latency = sequencer_latency_pulse_get(&config_array[pulse_id]);
+
+    // Now, check each value and convert to make sure it is sane
+    // Drunk me told me to refactor this, I'll see this message when no logney drunk me
+    for (uint32_t i = 0; i < pulse_sequence_buffer_size; i++)
+    {
+        uint32_t output = pulse_sequence_buffer_output[i];
+
+        // Convert the delay to the nearest cycle in the units of this
+        // sequencer, if possible
+        if (!pulse_sequence_delay_cycles_get(
+            &config_array[pulse_id],
+            &pulse_sequence_buffer_delay[i],
+            &delay_picos,
+            &delay_cycles
+        )) {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        state_set[i] = (delay_picos != 0) || (delay_cycles != 0);
+
+        // Trailing states that are not set stay unused in the extended and
+        // packed layouts. Cycle counts are exact.
+        if ((output != 0) || (delay_cycles != 0))
+        {
+            states_used = i + 1;
+
+            if (pulse_sequence_buffer_delay[i].suffix != NUMERIC_SUFFIX_CYCLES)
+            {
+                state_errors[i] = (int32_t) clock_cycles_error_picos_get(
+                    delay_picos,
+                    delay_cycles,
+                    cycle_nanos_fixed
+                );
+            }
+        }
+
+        // If the delay is 0, this means that it is not set and we need to set it to min cycles
+        if (delay_cycles == 0)
+        {
+            delay_cycles = PULSE_INSTRUCTION_OFFSET + 1;
+        }
+
+        // Steps shorter than a single delay loop need the fast pulser
+        if (delay_cycles < (PULSE_INSTRUCTION_OFFSET + 1))
+        {
+            fast = true;
+        }
+
+        // Validate delay cycles
+        if (delay_cycles < PULSE_FAST_INSTRUCTION_OFFSET)
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        // Validate output
+        if (output & ~OUT_MASK)
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        // Keep the uncompensated delays, the first state may also be part
+        // of a repeat block
+        state_cycles[i] = delay_cycles;
+
+        // Delays beyond a single delay loop need the hierarchical delay loops
+        if (delay_cycles > CLOCK_CYCLES_MAX)
+        {
+            extended = true;
+        }
+
+        // Packed states only hold 24 bit delays
+        if ((delay_cycles - PULSE_INSTRUCTION_OFFSET) > PULSE_PACKED_DELAY_MAX)
+        {
+            packed = false;
+        }
+    }
+
+    // Pick the densest format that can hold every delay. The packed pulser
+    // has no IRQ input, so IRQ listeners keep the standard format. Short steps
+    // need the fast pulser, which has neither IRQ input nor long delays.
+    if (fast)
+    {
+        if (extended || (config_array[pulse_id].input_source == PULSE_INPUT_CLOCK_IRQ))
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        instruction_format = PULSE_FORMAT_FAST;
+        states_max = PULSE_FAST_STATE_WORDS_MAX;
+    }
+    else if (extended)
+    {
+        instruction_format = PULSE_FORMAT_EXTENDED;
+        states_max = PULSE_EXTENDED_STATES_MAX;
+    }
+    else if (packed && (config_array[pulse_id].input_source != PULSE_INPUT_CLOCK_IRQ))
+    {
+        instruction_format = PULSE_FORMAT_PACKED;
+        states_max = PULSE_PACKED_STATES_MAX;
+    }
+
+    // Shortest state the selected format can run
+    const uint64_t state_cycles_min = fast
+        ? PULSE_FAST_INSTRUCTION_OFFSET
+        : (instruction_format == PULSE_FORMAT_EXTENDED)
+            ? PULSE_EXTENDED_INSTRUCTION_OFFSET + 1
+            : PULSE_INSTRUCTION_OFFSET + 1;
+
+    // The extended pulser needs more cycles per state than the standard one,
+    // so set states shorter than that can't be mixed with long delays
+    for (uint32_t i = 0; i < states_used; i++)
+    {
+        if (state_set[i] &&
+            (state_cycles[i] < state_cycles_min))
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+    }
+
+    // The first state also covers the input-to-output pipeline latency,
+    // so the following edges are measured from the input edge. A first
+    // state that is not set keeps the minimum delay.
+    const bool first_set = state_set[0];
+    const uint32_t first_latency = first_set ? input_latency : PULSE_LATENCY_NONE;
+
+    first_cycles = state_cycles[0];
+
+    if (first_set &&
+        !sequencer_latency_compensate(
+            state_cycles[0],
+            input_latency,
+            state_cycles_min,
+            &first_cycles
+        ))
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Repeat blocks run the last states of the sequence several times from the
+    // same words. They are set with the REPeat command, otherwise look for
+    // repeated states at the end of the sequence that save words.
+    const uint32_t STATE_WORDS = (instruction_format == PULSE_FORMAT_PACKED) ? 1 : 2;
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+    uint32_t prefix_states = 0;
+
+    if ((pulse_sequence_repeat_states > 0) && (pulse_sequence_repeat_count > 1))
+    {
+        repeat_states = pulse_sequence_repeat_states;
+        repeat_count = pulse_sequence_repeat_count;
+
+        // The repeat block is a DMA ring, so it needs a power of two states
+        if ((instruction_format == PULSE_FORMAT_EXTENDED) ||
+            (instruction_format == PULSE_FORMAT_FAST) ||
+            (repeat_states > states_used) ||
+            (repeat_states & (repeat_states - 1)))
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        prefix_states = states_used - repeat_states;
+
+        // The linear segment always keeps at least one state
+        if (prefix_states == 0)
+        {
+            prefix_states = repeat_states;
+            repeat_count--;
+        }
+
+        if (pulse_sequence_repeat_words_get(prefix_states, repeat_states, STATE_WORDS) > PULSE_INSTRUCTIONS_MAX)
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_DATA_OUT_OF_RANGE
+            );
+
+            return SCPI_RES_ERR;
+        }
+    }
+    else if ((pulse_sequence_repeat_states == 0) &&
+        (instruction_format != PULSE_FORMAT_EXTENDED) &&
+        (instruction_format != PULSE_FORMAT_FAST))
+    {
+        // Words of the plain layout, or more than the buffer if it does not fit
+        uint32_t plain_words = PULSE_INSTRUCTIONS_MAX + 1;
+
+        if (states_used <= states_max)
+        {
+            plain_words = (instruction_format == PULSE_FORMAT_PACKED)
+                ? pulse_sequence_repeat_words_get(states_used, 0, STATE_WORDS)
+                : PULSE_INSTRUCTIONS_MAX;
+        }
+
+        if (pulse_sequence_repeat_detect(
+            pulse_sequence_buffer_output,
+            state_cycles,
+            states_used,
+            STATE_WORDS,
+            plain_words,
+            &repeat_states,
+            &repeat_count
+        )) {
+            prefix_states = states_used - repeat_states * repeat_count;
+        }
+    }
+
+    if (repeat_states > 0)
+    {
+        const uint32_t repeat_words = repeat_states * STATE_WORDS;
+        const uint32_t linear_words = pulse_sequence_repeat_words_get(prefix_states, repeat_states, STATE_WORDS) - repeat_words;
+
+        // The larger ring goes first, which keeps both rings aligned
+        const uint32_t linear_offset = (linear_words >= repeat_words) ? 0 : repeat_words;
+        const uint32_t repeat_offset = (linear_words >= repeat_words) ? linear_words : 0;
+        const uint32_t pad_states = linear_words / STATE_WORDS - prefix_states - 1;
+
+        /*
+        The linear segment starts with idle pad states and the terminator, so
+        the sequence stops after the repeat block and the pulser waits for the
+        next input in front of the prefix states:
+        [pads][terminator][prefix states] -> [repeat block] x repeat_count
+        */
+        for (uint32_t i = 0; i < pad_states; i++)
+        {
+            pulse_state_encode(
+                &local_buffer[linear_offset + i * STATE_WORDS],
+                instruction_format,
+                0,
+                PULSE_INSTRUCTION_OFFSET + 1
+            );
+        }
+
+        for (uint32_t i = 0; i < prefix_states; i++)
+        {
+            pulse_state_encode(
+                &local_buffer[linear_offset + (pad_states + 1 + i) * STATE_WORDS],
+                instruction_format,
+                pulse_sequence_buffer_output[i],
+                (i == 0) ? first_cycles : state_cycles[i]
+            );
+        }
+
+        for (uint32_t i = 0; i < repeat_states; i++)
+        {
+            const uint32_t state = states_used - repeat_states + i;
+
+            pulse_state_encode(
+                &local_buffer[repeat_offset + i * STATE_WORDS],
+                instruction_format,
+                pulse_sequence_buffer_output[state],
+                state_cycles[state]
+            );
+        }
+
+        bool success = pulse_instructions_load(
+            pulse_id,
+            local_buffer,
+            instruction_format,
+            PULSE_INSTRUCTIONS_MAX
+        );
+
+        success = success && pulse_instructions_repeat_set(
+            pulse_id,
+            linear_offset,
+            linear_words,
+            repeat_offset,
+            repeat_words,
+            repeat_count
+        );
+
+        success = success && pulse_input_latency_set(
+            pulse_id,
+            first_latency
+        );
+
+        // If for some wierd reason we failed, raise an error
+        if (!success)
+        {
+            SCPI_ErrorPush(
+                context, 
+                SCPI_ERROR_PARAMETER_ERROR
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        pulse_sequence_applied_error_set(
+            pulse_id,
+            state_errors
+        );
+
+        return SCPI_RES_OK;
+    }
+
+    state_cycles[0] = first_cycles;
+
+    // Formats with more words per state fit fewer states into the ring buffer
+    if (states_used > states_max)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Configure default buffer pattern
+    /*
+    Important Note:
+    The pulse output instruction are broken up into two parts: the output
+    state and the delay duration to the next instruction. For instance,
+    every even instruction starting from zero (e.g., 0, 2, 4, 6, 8...) sets
+    the output state. Only the first 12 bits are used to set the output state
+    while the rest are discarded. The delay instructions are at every odd
+    instruction index (e.g., 1, 3, 5, 7, 9...) and are used in a delay loop.
+    The final two instruction at the end of the instruction buffer are used
+    to set the output state to idle and a terminating flag.
+
+    Extended sequences use three words per state instead: the output state,
+    the remainder delay and the number of delay blocks (see
+    sequencer_pio_pulse_sequencer_extended.pio).
+
+    Packed sequences use a single word per state: the output state in the low
+    8 bits and the delay in the upper 24 bits. The ring only covers the used
+    states (rounded up to a power of two) and ends with one zero word.
+
+    Fast sequences use a single word per step of up to 34 cycles: the output
+    state in the low 8 bits and a nop with the delay in its delay field. The
+    ring starts with two wait words and is padded with idle nops.
+
+    // DO NOT FORGET TO SET THE TERMINATING FLAGS (0) AND MAKE SURE ALL OTHER INSTRUCTIONS ARE NON-ZERO!!!!
+    */
+    if (instruction_format == PULSE_FORMAT_PACKED)
+    {
+        // Used states plus the terminating word
+        while ((instruction_words > 2) && ((instruction_words / 2) >= (states_used + 1)))
+        {
+            instruction_words /= 2;
+        }
+
+        for (uint32_t i = 0; i < instruction_words - 1; i++)
+        {
+            const uint32_t output = (i < states_used) ? pulse_sequence_buffer_output[i] : 0;
+            const uint64_t cycles = (i < states_used) ? state_cycles[i] : PULSE_INSTRUCTION_OFFSET + 1;
+
+            local_buffer[i] = output | ((uint32_t) (cycles - PULSE_INSTRUCTION_OFFSET) << PULSE_PACKED_STATE_BITS);
+        }
+
+        local_buffer[instruction_words - 1] = SEQUENCE_FLAG_END;
+    }
+    else if (instruction_format == PULSE_FORMAT_FAST)
+    {
+        const uint64_t STEP_CYCLES_MAX = PULSE_FAST_INSTRUCTION_OFFSET + PULSE_FAST_DELAY_MAX;
+        uint32_t words_used = PULSE_FAST_TERM_WORDS;
+
+        for (uint32_t i = 0; i < PULSE_FAST_TERM_WORDS; i++)
+        {
+            local_buffer[i] = sequencer_output_fast_term_get(i);
+        }
+
+        for (uint32_t i = 0; i < states_used; i++)
+        {
+            // Long steps are split into even words with the same output state
+            const uint64_t cycles = state_cycles[i];
+            const uint64_t words = (cycles + STEP_CYCLES_MAX - 1) / STEP_CYCLES_MAX;
+
+            if ((words_used + words) > PULSE_INSTRUCTIONS_MAX)
+            {
+                SCPI_ErrorPush(
+                    context, 
+                    SCPI_ERROR_DATA_OUT_OF_RANGE
+                );
+
+                return SCPI_RES_ERR;
+            }
+
+            for (uint32_t j = 0; j < words; j++)
+            {
+                const uint32_t word_cycles = (uint32_t) (cycles / words + ((j < (cycles % words)) ? 1 : 0));
+                const uint32_t instruction = pio_encode_nop() | pio_encode_delay(word_cycles - PULSE_FAST_INSTRUCTION_OFFSET);
+
+                local_buffer[words_used++] = pulse_sequence_buffer_output[i] | (instruction << PULSE_PACKED_STATE_BITS);
+            }
+        }
+
+        while ((instruction_words / 2) >= words_used)
+        {
+            instruction_words /= 2;
+        }
+
+        for (uint32_t i = words_used; i < instruction_words; i++)
+        {
+            local_buffer[i] = pio_encode_nop() << PULSE_PACKED_STATE_BITS;
+        }
+    }
+    else if (instruction_format == PULSE_FORMAT_STANDARD)
+    {
+        for (uint32_t i = 0, j = 0; i < PULSE_STANDARD_STATES_MAX; i++, j+=2)
+        {
+            // If all is good, go ahead and offset the delay
+            local_buffer[j] = pulse_sequence_buffer_output[i];
+            local_buffer[j+1] = (uint32_t) state_cycles[i] - PULSE_INSTRUCTION_OFFSET;
+        }
+    }
+    else
+    {
+        for (uint32_t i = 0, j = 0; i < PULSE_EXTENDED_STATES_MAX; i++, j+=PULSE_EXTENDED_WORDS)
+        {
+            uint64_t cycles = state_cycles[i];
+
+            // Unused states and states that are not set run the shortest
+            // extended state, set states were checked against it
+            if ((i >= states_used) || (cycles < (PULSE_EXTENDED_INSTRUCTION_OFFSET + 1)))
+            {
+                cycles = PULSE_EXTENDED_INSTRUCTION_OFFSET + 1;
+            }
+
+            // Split into full blocks and a non-zero remainder
+            const uint64_t blocks = (cycles - PULSE_EXTENDED_INSTRUCTION_OFFSET - 1) / PULSE_EXTENDED_BLOCK_CYCLES;
+
+            local_buffer[j] = (i < states_used) ? pulse_sequence_buffer_output[i] : 0;
+            local_buffer[j+1] = (uint32_t) (cycles - PULSE_EXTENDED_INSTRUCTION_OFFSET - blocks * PULSE_EXTENDED_BLOCK_CYCLES);
+            local_buffer[j+2] = (uint32_t) blocks;
+        }
+    }
+
+    // Make sure last two elements are zero
+    if ((instruction_format == PULSE_FORMAT_STANDARD) ||
+        (instruction_format == PULSE_FORMAT_EXTENDED))
+    {
+        local_buffer[PULSE_INSTRUCTIONS_OUTPUT_TERM] = SEQUENCE_FLAG_END;
+        local_buffer[PULSE_INSTRUCTIONS_DELAY_TERM] = SEQUENCE_FLAG_END;
+    }
+
+    bool success = pulse_instructions_load(
+        pulse_id,
+        local_buffer,
+        instruction_format,
+        instruction_words
+    );
+
+    success = success && pulse_input_latency_set(
+        pulse_id,
+        first_latency
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    pulse_sequence_applied_error_set(
+        pulse_id,
+        state_errors
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the quantization error (requested - achieved, in picoseconds) of
+// every state applied to pulse sequencer N
+scpi_result_t SCPI_PulseDataErrorQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultArrayInt32(
+        context,
+        pulse_sequence_applied_error[pulse_id],
+        pulse_sequence_buffer_size,
+        0 // what is scpi array format??
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query instructions at pulse sequencer N
+scpi_result_t SCPI_PulseDataQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Retrieve pulse sequencer container
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    // Get the instructions of the pulse sequencer at pulse_id
+    SCPI_ResultArrayUInt32(
+        context,
+        config_array[pulse_id].instructions,
+        PULSE_INSTRUCTIONS_MAX,
+        0 // what is array format??
+    );
+    
+    return SCPI_RES_OK;
+}
+
+
+// Overwrite single words of the instruction buffer at pulse sequencer N,
+// given as index and value pairs. The program is validated on commit.
+scpi_result_t SCPI_PulseDataPatch(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t indices[PULSE_INSTRUCTIONS_MAX] = {0};
+    uint32_t values[PULSE_INSTRUCTIONS_MAX] = {0};
+    uint32_t pairs = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamPatchPairs(
+        context,
+        indices,
+        values,
+        PULSE_INSTRUCTIONS_MAX,
+        &pairs
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    for (uint32_t i = 0; i < pairs; i++)
+    {
+        pulse_instruction_patch(
+            pulse_id,
+            indices[i],
+            values[i]
+        );
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Reset pulse sequencer N
+scpi_result_t SCPI_PulseReset(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t numbers[1] = {0};
+    uint32_t pulse_id = 0;
+
+    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    bool success = pulse_sequencer_state_reset(
+        pulse_id
+    );
+    
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context, 
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Store the loaded instructions of pulse sequencer N as a sequence table entry
+scpi_result_t SCPI_PulseSequenceStore(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t entry = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &entry,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (entry >= PULSE_SEQUENCES_MAX)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // Invalid sequences and repeat blocks can not be stored
+    if (!pulse_sequence_store(
+        pulse_id,
+        entry
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_SETTINGS_CONFLICT
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Drop all sequence table entries of pulse sequencer N
+scpi_result_t SCPI_PulseSequenceClear(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    pulse_sequence_clear(pulse_id);
+
+    return SCPI_RES_OK;
+}
+
+
+// Set how pulse sequencer N picks its sequence table entries
+scpi_result_t SCPI_PulseSequenceMode(
+    scpi_t* context
+) {
+    // Allocate some variables
+    int32_t choice = 0;
+    uint32_t pulse_id = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    // Valid sequence table modes
+    const scpi_choice_def_t options[] = {
+        {"OFF",      PULSE_SEQUENCE_OFF},
+        {"BUS",      PULSE_SEQUENCE_BUS},
+        {"EXTernal", PULSE_SEQUENCE_EXTERNAL},
+        {"LIST",     PULSE_SEQUENCE_LIST},
+        SCPI_CHOICE_LIST_END
+    };
+
+    if (!SCPI_ParamChoice(
+        context,
+        options,
+        &choice,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    bool success = pulse_sequence_mode_set(
+        pulse_id,
+        (uint32_t) choice
+    );
+
+    // If for some wierd reason we failed, raise an error
+    if (!success)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_PARAMETER_ERROR
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the sequence table mode of pulse sequencer N
+scpi_result_t SCPI_PulseSequenceModeQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[pulse_id].sequence_mode
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Select the sequence table entry of pulse sequencer N in bus mode. Allowed
+// while running, the entry is switched at the next sequence boundary.
+scpi_result_t SCPI_PulseSequenceSelect(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t entry = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_pulse_id_get_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &entry,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (entry >= PULSE_SEQUENCES_MAX)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    // While running only committed entries of a bus mode table can be picked
+    if (!pulse_sequence_select_set(
+        pulse_id,
+        entry
+    )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_SETTINGS_CONFLICT
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the selected sequence table entry of pulse sequencer N
+scpi_result_t SCPI_PulseSequenceSelectQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_pulse_id_get_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[pulse_id].sequence_select
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Set the step list pulse sequencer N loops over in list mode
+scpi_result_t SCPI_PulseSequenceList(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t steps[PULSE_SEQUENCE_STEPS_MAX] = {0};
+    uint32_t step_count = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    while (true)
+    {
+        uint32_t entry = 0;
+
+        if (!SCPI_ParamUInt32(context, &entry, step_count == 0))
+        {
+            if (SCPI_ParamErrorOccurred(context))
+            {
+                return SCPI_RES_ERR;
+            }
+
+            break;
+        }
+
+        if (step_count == PULSE_SEQUENCE_STEPS_MAX)
+        {
+            SCPI_ErrorPush(
+                context,
+                SCPI_ERROR_TOO_MUCH_DATA
+            );
+
+            return SCPI_RES_ERR;
+        }
+
+        steps[step_count++] = entry;
     }
 
-    // Get pulse sequencer ID (Not currently used)
-    if (SCPI_check_pulse_id_and_append_error(
-        context,
-        &pulse_id
+    // Entries out of range or a step count that is not a power of two
+    if (!pulse_sequence_steps_set(
+        pulse_id,
+        steps,
+        step_count
     )) {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
         return SCPI_RES_ERR;
     }
 
-    SCPI_ResultArrayDouble(
-        context,
-        pulse_sequence_buffer_delay,
-        pulse_sequence_buffer_size,
-        0 // what is scpi array format??
-    );
-
     return SCPI_RES_OK;
 }
 
 
-// Clear the instructions in cache
-scpi_result_t SCPI_PulseDataClear(
+// Query the step list of pulse sequencer N
+scpi_result_t SCPI_PulseSequenceListQ(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
-    size_t instructions_read=0;
-
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
-    if (SCPI_check_running_and_append_error(context))
-    {
-        return SCPI_RES_ERR;
-    }
 
-    // Get pulse sequencer ID (Not currently used)
+    // Get pulse sequencer ID
     if (SCPI_check_pulse_id_and_append_error(
         context,
         &pulse_id
@@ -742,33 +2286,42 @@ scpi_result_t SCPI_PulseDataClear(
         return SCPI_RES_ERR;
     }
 
-    // Reset the buffer
-    pulse_sequencer_cache_output_clear();
-    pulse_sequencer_cache_delay_clear();
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    SCPI_ResultArrayUInt32(
+        context,
+        config_array[pulse_id].sequence_steps,
+        config_array[pulse_id].sequence_step_count,
+        0
+    );
 
     return SCPI_RES_OK;
 }
 
 
-// Apply currently cached instructions to pulse sequencer N
-scpi_result_t SCPI_PulseDataApply(
+// Set the delay scan of pulse sequencer N. Takes the state whose delay is
+// swept, the start and step delay in the current pulse units, the number of
+// points and the triggers spent at every point.
+scpi_result_t SCPI_PulseScanDelay(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
-    uint32_t delay_cycles = 0;
-
-    uint32_t local_buffer[PULSE_INSTRUCTIONS_MAX] = {};
-    const uint32_t local_buffer_size = PULSE_INSTRUCTIONS_MAX;
-
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    uint32_t scan_state = 0;
+    uint64_t start_picos = 0;
+    uint64_t step_picos = 0;
+    uint32_t start_cycles = 0;
+    uint32_t step_cycles = 0;
+    uint32_t scan_points = 0;
+    uint32_t scan_triggers = 1;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
     {
         return SCPI_RES_ERR;
     }
 
-    // Get pulse sequencer ID (Not currently used)
+    // Get pulse sequencer ID
     if (SCPI_check_pulse_id_and_append_error(
         context,
         &pulse_id
@@ -776,116 +2329,79 @@ scpi_result_t SCPI_PulseDataApply(
         return SCPI_RES_ERR;
     }
 
-    // Make sure both instruction buffers have read same number of elements
-    if (pulse_sequence_buffer_output_read != pulse_sequence_buffer_delay_read)
-    {
-        SCPI_ErrorPush(
-            context, 
-            SCPI_ERROR_LISTS_NOT_SAME_LENGTH
-        );
+    struct pulse_config* config_array = sequencer_pulse_config_get();
 
+    if (!SCPI_ParamUInt32(context, &scan_state, TRUE) ||
+        !SCPI_ParamPicos(context, &start_picos, config_array[pulse_id].unit_offset, TRUE) ||
+        !SCPI_ParamPicos(context, &step_picos, config_array[pulse_id].unit_offset, TRUE) ||
+        !SCPI_ParamUInt32(context, &scan_points, TRUE))
+    {
         return SCPI_RES_ERR;
     }
- 
-    // Now get unit conversion paramerters
-    struct pulse_config* config_array = sequencer_pulse_config_get();
-
-    const double unit_offset = config_array[pulse_id].unit_offset;
-    const uint clock_divider = config_array[pulse_id].clock_divider;
-
-    // Configure default buffer pattern
-    /*
-    Important Note:
-    The pulse output instruction are broken up into two parts: the output
-    state and the delay duration to the next instruction. For instance,
-    every even instruction starting from zero (e.g., 0, 2, 4, 6, 8...) sets
-    the output state. Only the first 12 bits are used to set the output state
-    while the rest are discarded. The delay instructions are at every odd
-    instruction index (e.g., 1, 3, 5, 7, 9...) and are used in a delay loop.
-    The final two instruction at the end of the instruction buffer are used
-    to set the output state to idle and a terminating flag.
 
-    // DO NOT FORGET TO SET THE TERMINATING FLAGS (0) AND MAKE SURE ALL OTHER INSTRUCTIONS ARE NON-ZERO!!!!
-    */
-
-    // Set all delay instructions to 1 (they can't be zero)
-    for (uint32_t i = 1; i < local_buffer_size; i += 2)
+    // The trigger count is optional and defaults to one trigger per point
+    if (!SCPI_ParamUInt32(context, &scan_triggers, FALSE) &&
+        SCPI_ParamErrorOccurred(context))
     {
-        local_buffer[i] = PULSE_INSTRUCTION_OFFSET + 1; // 6 cycle delay whhich maps to 1 cycle delay after offset
+        return SCPI_RES_ERR;
     }
 
-    // Make sure last two elements are zero
-    local_buffer[PULSE_INSTRUCTIONS_OUTPUT_TERM] = SEQUENCE_FLAG_END;
-    local_buffer[PULSE_INSTRUCTIONS_DELAY_TERM] = SEQUENCE_FLAG_END;
-
-    // Now, check each value and convert to make sure it is sane
-    // Drunk me told me to refactor this, I'll see this message when no logney drunk me
-    for (uint32_t i = 0, j = 0; i < pulse_sequence_buffer_size; i++, j+=2)
+    if (!convert_picos_to_cycles(
+            start_picos,
+            config_array[pulse_id].clock_divider,
+            config_array[pulse_id].clock_divider_frac,
+            &start_cycles
+        ) ||
+        !convert_picos_to_cycles(
+            step_picos,
+            config_array[pulse_id].clock_divider,
+            config_array[pulse_id].clock_divider_frac,
+            &step_cycles
+        ))
     {
-        uint32_t output = pulse_sequence_buffer_output[i];
-        double delay = pulse_sequence_buffer_delay[i];
-
-        // Convert delay into nanoseconds
-        delay = delay * unit_offset;
-
-        // Convert nanoseconds to cycles, if possible
-        if (!convert_nanos_to_cycles(
-            (uint64_t) delay, // This truncates decimals similar to floor operation (e.g, 120.5 ns --> 120 ns)
-            clock_divider,
-            &delay_cycles
-        )) {
-            SCPI_ErrorPush(
-                context, 
-                SCPI_ERROR_DATA_OUT_OF_RANGE
-            );
-
-            return SCPI_RES_ERR;
-        }
-
-        // If the delay is 0, this means that it is not set and we need to set it to min cycles
-        if (delay_cycles == 0)
-        {
-            delay_cycles = PULSE_INSTRUCTION_OFFSET + 1;
-        }
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
 
-        // Validate delay cycles
-        if (delay_cycles < (PULSE_INSTRUCTION_OFFSET + 1))
-        {
-            SCPI_ErrorPush(
-                context, 
-                SCPI_ERROR_DATA_OUT_OF_RANGE
-            );
+        return SCPI_RES_ERR;
+    }
 
-            return SCPI_RES_ERR;
-        }
+    // Like the first state of a sequence, a sweep of the first state is
+    // measured from the input edge
+    if (scan_state == 0)
+    {
+        uint64_t start_compensated = 0;
 
-        // Validate output
-        if (output & ~OUT_MASK)
-        {
+        if (!sequencer_latency_compensate(
+            start_cycles,
+            sequencer_latency_pulse_get(&config_array[pulse_id]),
+            PULSE_INSTRUCTION_OFFSET + 1,
+            &start_compensated
+        )) {
             SCPI_ErrorPush(
-                context, 
+                context,
                 SCPI_ERROR_DATA_OUT_OF_RANGE
             );
 
             return SCPI_RES_ERR;
         }
 
-        // If all is good, go ahead and offset the delay
-        local_buffer[j] = output;
-        local_buffer[j+1] = delay_cycles - PULSE_INSTRUCTION_OFFSET;
+        start_cycles = (uint32_t) start_compensated;
     }
 
-    bool success = pulse_instructions_load(
+    // The points are checked against the instructions at commit
+    if (!pulse_scan_set(
         pulse_id,
-        local_buffer
-    );
-
-    // If for some wierd reason we failed, raise an error
-    if (!success)
-    {
+        scan_state,
+        start_cycles,
+        step_cycles,
+        scan_points,
+        scan_triggers
+    )) {
         SCPI_ErrorPush(
-            context, 
-            SCPI_ERROR_PARAMETER_ERROR
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
         );
 
         return SCPI_RES_ERR;
@@ -895,12 +2411,11 @@ scpi_result_t SCPI_PulseDataApply(
 }
 
 
-// Query instructions at pulse sequencer N
-scpi_result_t SCPI_PulseDataQ(
+// Query the delay scan of pulse sequencer N
+scpi_result_t SCPI_PulseScanDelayQ(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
 
     // Get pulse sequencer ID
@@ -911,30 +2426,58 @@ scpi_result_t SCPI_PulseDataQ(
         return SCPI_RES_ERR;
     }
 
-    // Retrieve pulse sequencer container
     struct pulse_config* config_array = sequencer_pulse_config_get();
 
-    // Get the instructions of the pulse sequencer at pulse_id
-    SCPI_ResultArrayUInt32(
+    const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+        config_array[pulse_id].clock_divider,
+        config_array[pulse_id].clock_divider_frac
+    );
+    const uint64_t picos_per_unit = config_array[pulse_id].unit_offset * PICOS_PER_NANOSECOND;
+
+    uint64_t start_cycles = config_array[pulse_id].scan_start;
+
+    if (config_array[pulse_id].scan_state == 0)
+    {
+        start_cycles += sequencer_latency_pulse_get(&config_array[pulse_id]);
+    }
+
+    SCPI_ResultUInt32(
         context,
-        config_array[pulse_id].instructions,
-        PULSE_INSTRUCTIONS_MAX,
-        0 // what is array format??
+        config_array[pulse_id].scan_state
     );
-    
+
+    SCPI_ResultDouble(
+        context,
+        (double) clock_cycles_picos_get(start_cycles, cycle_nanos_fixed) / picos_per_unit
+    );
+
+    SCPI_ResultDouble(
+        context,
+        (double) clock_cycles_picos_get(config_array[pulse_id].scan_step, cycle_nanos_fixed) / picos_per_unit
+    );
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[pulse_id].scan_points
+    );
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[pulse_id].scan_triggers
+    );
+
     return SCPI_RES_OK;
 }
 
 
-// Reset pulse sequencer N
-scpi_result_t SCPI_PulseReset(
+// Turn off the delay scan of pulse sequencer N
+scpi_result_t SCPI_PulseScanClear(
     scpi_t* context
 ) {
     // Allocate some variables
-    int32_t numbers[1] = {0};
     uint32_t pulse_id = 0;
 
-    // If the system status is note (IDLE) or 5 (ABORTED), return an error
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
     if (SCPI_check_running_and_append_error(context))
     {
         return SCPI_RES_ERR;
@@ -948,20 +2491,147 @@ scpi_result_t SCPI_PulseReset(
         return SCPI_RES_ERR;
     }
 
-    bool success = pulse_sequencer_state_reset(
-        pulse_id
+    pulse_scan_set(
+        pulse_id,
+        0,
+        0,
+        0,
+        0,
+        1
     );
-    
-    // If for some wierd reason we failed, raise an error
-    if (!success)
+
+    return SCPI_RES_OK;
+}
+
+
+// Set the outputs pulse sequencer N raises during the first sequence of
+// every scan point
+scpi_result_t SCPI_PulseScanMarker(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+    uint32_t marker = 0;
+
+    // !If the system status is not 0 (IDLE) or 5 (ABORTED), return an error
+    if (SCPI_check_running_and_append_error(context))
     {
+        return SCPI_RES_ERR;
+    }
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!SCPI_ParamUInt32(
+        context,
+        &marker,
+        TRUE
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!pulse_scan_marker_set(
+        pulse_id,
+        marker
+    )) {
         SCPI_ErrorPush(
-            context, 
-            SCPI_ERROR_PARAMETER_ERROR
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
         );
 
         return SCPI_RES_ERR;
     }
 
     return SCPI_RES_OK;
-}
\ No newline at end of file
+}
+
+
+// Query the scan marker outputs of pulse sequencer N
+scpi_result_t SCPI_PulseScanMarkerQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_check_pulse_id_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    struct pulse_config* config_array = sequencer_pulse_config_get();
+
+    SCPI_ResultUInt32(
+        context,
+        config_array[pulse_id].scan_marker
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Query the scan point pulse sequencer N is at, also while running
+scpi_result_t SCPI_PulseScanPointQ(
+    scpi_t* context
+) {
+    // Allocate some variables
+    uint32_t pulse_id = 0;
+
+    // Get pulse sequencer ID
+    if (SCPI_pulse_id_get_and_append_error(
+        context,
+        &pulse_id
+    )) {
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultUInt32(
+        context,
+        scan_point_get(pulse_id)
+    );
+
+    return SCPI_RES_OK;
+}
+
+
+// Channel list variants of the per pulse sequencer commands
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseStatus, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseStatusQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePin, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePinQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePinExternal, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePinExternalQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePinIrq, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulsePinIrqQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseClockDivider, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseClockDividerQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseClockDividerValue, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseClockDividerValueQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseUnits, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseUnitsQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseDataQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseDataPatch, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseReset, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseDataApply, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseDataErrorQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceStore, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceClear, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceMode, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceModeQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceSelect, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceSelectQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceList, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseSequenceListQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanDelay, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanDelayQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanClear, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanMarker, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanMarkerQ, pulse_id_validate)
+SCPI_CHANNEL_LIST_DEFINE(SCPI_PulseScanPointQ, pulse_id_validate)
@@ -2,26 +2,52 @@
 
 #include "scpi/scpi.h"
 
+#include "scpi_channel_list.h"
+
 
 #define INSTRUMENT_PULSE_COMMANDS \
     {.pattern = "SOURce:PULSe:SELect",    .callback = SCPI_PulseIndex,}, \
     {.pattern = "SOURce:PULSe:SELect?",   .callback = SCPI_PulseIndexQ,}, \
-    {.pattern = "SOURce:PULSe#:STATe",    .callback = SCPI_PulseStatus,}, \
-    {.pattern = "SOURce:PULSe#:STATe?",   .callback = SCPI_PulseStatusQ,}, \
-    {.pattern = "SOURce:PULSe#:INPut",    .callback = SCPI_PulsePin,}, \
-    {.pattern = "SOURce:PULSe#:INPut?",   .callback = SCPI_PulsePinQ,}, \
-    {.pattern = "SOURce:PULSe#:DIVider",  .callback = SCPI_PulseClockDivider,}, \
-    {.pattern = "SOURce:PULSe#:DIVider?", .callback = SCPI_PulseClockDividerQ,}, \
-    {.pattern = "SOURce:PULSe#:UNITs",    .callback = SCPI_PulseUnits,}, \
-    {.pattern = "SOURce:PULSe#:UNITs?",   .callback = SCPI_PulseUnitsQ,}, \
-    {.pattern = "SOURce:PULSe#:DATA?",    .callback = SCPI_PulseDataQ,}, \
-    {.pattern = "SOURce:PULSe#:RESet",    .callback = SCPI_PulseReset,}, \
+    {.pattern = "SOURce:PULSe#:STATe",    .callback = SCPI_PulseStatusChannels,}, \
+    {.pattern = "SOURce:PULSe#:STATe?",   .callback = SCPI_PulseStatusQChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut",    .callback = SCPI_PulsePinChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut?",   .callback = SCPI_PulsePinQChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut:EXTernal",   .callback = SCPI_PulsePinExternalChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut:EXTernal?",  .callback = SCPI_PulsePinExternalQChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut:IRQ",        .callback = SCPI_PulsePinIrqChannels,}, \
+    {.pattern = "SOURce:PULSe#:INPut:IRQ?",       .callback = SCPI_PulsePinIrqQChannels,}, \
+    {.pattern = "SOURce:PULSe#:DIVider",  .callback = SCPI_PulseClockDividerChannels,}, \
+    {.pattern = "SOURce:PULSe#:DIVider?", .callback = SCPI_PulseClockDividerQChannels,}, \
+    {.pattern = "SOURce:PULSe#:DIVider:VALue",  .callback = SCPI_PulseClockDividerValueChannels,}, \
+    {.pattern = "SOURce:PULSe#:DIVider:VALue?", .callback = SCPI_PulseClockDividerValueQChannels,}, \
+    {.pattern = "SOURce:PULSe#:UNITs",    .callback = SCPI_PulseUnitsChannels,}, \
+    {.pattern = "SOURce:PULSe#:UNITs?",   .callback = SCPI_PulseUnitsQChannels,}, \
+    {.pattern = "SOURce:PULSe#:DATA?",    .callback = SCPI_PulseDataQChannels,}, \
+    {.pattern = "SOURce:PULSe#:DATA:PATCh", .callback = SCPI_PulseDataPatchChannels,}, \
+    {.pattern = "SOURce:PULSe#:RESet",    .callback = SCPI_PulseResetChannels,}, \
     {.pattern = "SOURce:PULSe#:DATA:BUFFer:OUTPut",  .callback = SCPI_PulseDataOutput,}, \
     {.pattern = "SOURce:PULSe#:DATA:BUFFer:OUTPut?", .callback = SCPI_PulseDataOutputQ,}, \
     {.pattern = "SOURce:PULSe#:DATA:BUFFer:DELay",   .callback = SCPI_PulseDataDelay,}, \
     {.pattern = "SOURce:PULSe#:DATA:BUFFer:DELay?",  .callback = SCPI_PulseDataDelayQ,}, \
+    {.pattern = "SOURce:PULSe#:DATA:BUFFer:REPeat",  .callback = SCPI_PulseDataRepeat,}, \
+    {.pattern = "SOURce:PULSe#:DATA:BUFFer:REPeat?", .callback = SCPI_PulseDataRepeatQ,}, \
     {.pattern = "SOURce:PULSe#:DATA:BUFFer:CLEar",   .callback = SCPI_PulseDataClear,}, \
-    {.pattern = "SOURce:PULSe#:DATA:BUFFer:APPly",   .callback = SCPI_PulseDataApply,}, \
+    {.pattern = "SOURce:PULSe#:DATA:BUFFer:APPly",   .callback = SCPI_PulseDataApplyChannels,}, \
+    {.pattern = "SOURce:PULSe#:DATA:ERRor?",         .callback = SCPI_PulseDataErrorQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:STORe",   .callback = SCPI_PulseSequenceStoreChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:CLEar",   .callback = SCPI_PulseSequenceClearChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:MODE",    .callback = SCPI_PulseSequenceModeChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:MODE?",   .callback = SCPI_PulseSequenceModeQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:SELect",  .callback = SCPI_PulseSequenceSelectChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:SELect?", .callback = SCPI_PulseSequenceSelectQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:LIST",    .callback = SCPI_PulseSequenceListChannels,}, \
+    {.pattern = "SOURce:PULSe#:SEQuence:LIST?",   .callback = SCPI_PulseSequenceListQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:DELay",       .callback = SCPI_PulseScanDelayChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:DELay?",      .callback = SCPI_PulseScanDelayQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:CLEar",       .callback = SCPI_PulseScanClearChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:MARKer",      .callback = SCPI_PulseScanMarkerChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:MARKer?",     .callback = SCPI_PulseScanMarkerQChannels,}, \
+    {.pattern = "SOURce:PULSe#:SCAN:POINt?",      .callback = SCPI_PulseScanPointQChannels,}, \
 
 void pulse_sequencer_cache_clear();
 
@@ -49,6 +75,22 @@ scpi_result_t SCPI_PulsePinQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_PulsePinExternal(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulsePinExternalQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulsePinIrq(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulsePinIrqQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_PulseClockDivider(
     scpi_t* context
 );
@@ -57,6 +99,14 @@ scpi_result_t SCPI_PulseClockDividerQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_PulseClockDividerValue(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseClockDividerValueQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_PulseUnits(
     scpi_t* context
 );
@@ -85,14 +135,121 @@ scpi_result_t SCPI_PulseDataClear(
     scpi_t* context
 );
 
+scpi_result_t SCPI_PulseDataRepeat(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseDataRepeatQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_PulseDataApply(
     scpi_t* context
 );
 
+scpi_result_t SCPI_PulseDataErrorQ(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_PulseDataQ(
     scpi_t* context
 );
 
+scpi_result_t SCPI_PulseDataPatch(
+    scpi_t* context
+);
+
 scpi_result_t SCPI_PulseReset(
     scpi_t* context
-);
\ No newline at end of file
+);
+
+scpi_result_t SCPI_PulseSequenceStore(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceClear(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceMode(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceModeQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceSelect(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceSelectQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceList(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseSequenceListQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanDelay(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanDelayQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanClear(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanMarker(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanMarkerQ(
+    scpi_t* context
+);
+
+scpi_result_t SCPI_PulseScanPointQ(
+    scpi_t* context
+);
+
+// Per channel commands, also accept a trailing channel list
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseStatus);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseStatusQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePin);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePinQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePinExternal);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePinExternalQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePinIrq);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulsePinIrqQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseClockDivider);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseClockDividerQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseClockDividerValue);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseClockDividerValueQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseUnits);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseUnitsQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseDataQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseDataPatch);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseReset);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseDataApply);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseDataErrorQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceStore);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceClear);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceMode);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceModeQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceSelect);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceSelectQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceList);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseSequenceListQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanDelay);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanDelayQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanClear);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanMarker);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanMarkerQ);
+SCPI_CHANNEL_LIST_DECLARE(SCPI_PulseScanPointQ);
@@ -57,10 +57,15 @@ void serial_print_clock_configs(
         fast_serial_printf("Clock config is active: %i\r\n", config_array[i].active);
         fast_serial_printf("Clock config clock mode: %i\r\n", config_array[i].clock_mode);
         fast_serial_printf("Clock config clock divider: %i\r\n", config_array[i].clock_divider);
+        fast_serial_printf("Clock config clock divider frac: %i\r\n", config_array[i].clock_divider_frac);
         fast_serial_printf("Clock config sm: %i\r\n", config_array[i].sm);
         fast_serial_printf("Clock config dma channel: %i\r\n", config_array[i].dma_chan);
         fast_serial_printf("Clock config clock pin: %i\r\n", config_array[i].clock_pin);
+        fast_serial_printf("Clock config clock pin output: %i\r\n", config_array[i].clock_pin_output);
         fast_serial_printf("Clock config trigger pin: %i\r\n", config_array[i].trigger_pin);
+        fast_serial_printf("Clock config trigger aux pin: %i\r\n", config_array[i].trigger_pin_aux);
+        fast_serial_printf("Clock config trigger inputs: %i\r\n", config_array[i].trigger_inputs);
+        fast_serial_printf("Clock config trigger logic: %i\r\n", config_array[i].trigger_logic);
         fast_serial_printf("Clock config trigger mode: %i\r\n", config_array[i].trigger_source);
         fast_serial_printf("Clock config trigger edge: %i\r\n", config_array[i].trigger_edge);
         fast_serial_printf("Clock config trigger gate level: %i\r\n", config_array[i].trigger_level);
@@ -72,6 +77,13 @@ void serial_print_clock_configs(
         );
 
         fast_serial_printf("Trigger instruction reps: %i\r\n", config_array[i].trigger_reps);
+        fast_serial_printf("Trigger filter cycles: %i\r\n", config_array[i].trigger_filter);
+        fast_serial_printf("Trigger mask words: %i; bits per word: %i\r\n", config_array[i].trigger_mask_words, config_array[i].trigger_mask_bits);
+
+        for (uint32_t j = 0; j < config_array[i].trigger_mask_words; j++)
+        {
+            fast_serial_printf("Trigger mask word %i: %b\r\n", j, config_array[i].trigger_mask[j]);
+        }
     }
 }
 
@@ -101,9 +113,17 @@ void serial_print_pulse_configs(
         fast_serial_printf("Pulse config id: %i\r\n", i);
         fast_serial_printf("Pulse config is active: %i\r\n", config_array[i].active);
         fast_serial_printf("Pulse config clock divider: %i\r\n", config_array[i].clock_divider);
+        fast_serial_printf("Pulse config clock divider frac: %i\r\n", config_array[i].clock_divider_frac);
         fast_serial_printf("Pulse config sm: %i\r\n", config_array[i].sm);
         fast_serial_printf("Pulse config dma channel: %i\r\n", config_array[i].dma_chan);
         fast_serial_printf("Pulse config clock pin: %i\r\n", config_array[i].clock_pin);
+        fast_serial_printf("Pulse config input source: %i\r\n", config_array[i].input_source);
+        fast_serial_printf("Pulse config clock irq: %i\r\n", config_array[i].clock_irq);
+        fast_serial_printf("Pulse config instruction format: %i\r\n", config_array[i].instruction_format);
+        fast_serial_printf("Pulse config instruction words: %i\r\n", config_array[i].instruction_words);
+        fast_serial_printf("Pulse config repeat dma channel: %i\r\n", config_array[i].dma_chan_repeat);
+        fast_serial_printf("Pulse config linear offset: %i, words: %i\r\n", config_array[i].linear_offset, config_array[i].linear_words);
+        fast_serial_printf("Pulse config repeat offset: %i, words: %i, count: %i\r\n", config_array[i].repeat_offset, config_array[i].repeat_words, config_array[i].repeat_count);
         serial_print_pulse_instructions(
             &config_array[i]
         );
@@ -0,0 +1,89 @@
+#include "arm_status.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/mutex.h"
+
+
+// Arm results
+const uint32_t ARM_RESULT_PENDING = 0;
+const uint32_t ARM_RESULT_OK = 1;
+const uint32_t ARM_RESULT_DEBUG = 2;      // stopped by debug level 1
+const uint32_t ARM_RESULT_STOPPED = 3;    // stopped by DEVice:STOP while arming
+const uint32_t ARM_RESULT_CLOCK_MODE = 4; // clock mode without a program
+const uint32_t ARM_RESULT_PULSE = 5;      // pulse sequencer not configured
+
+
+// Mutex for status
+static mutex_t arm_mutex_status;
+uint32_t arm_result = ARM_RESULT_PENDING;
+uint32_t arm_channel = 0;
+bool arm_event = false;
+bool arm_request = false;
+
+// This must be called in main before anything else.
+void arm_status_register()
+{
+    mutex_init(&arm_mutex_status);
+}
+
+
+// Forget the result of the previous arm request, call before every request.
+// The request stays pending until the sequencer core reports its result.
+void arm_result_reset()
+{
+	mutex_enter_blocking(&arm_mutex_status);
+	arm_result = ARM_RESULT_PENDING;
+	arm_channel = 0;
+	arm_event = false;
+	arm_request = true;
+	mutex_exit(&arm_mutex_status);
+}
+
+
+// Record how an arm request ended and the channel that failed it. Also
+// latches an arm event for the SCPI core to pick up.
+void arm_result_set(uint32_t result, uint32_t channel)
+{
+	mutex_enter_blocking(&arm_mutex_status);
+	arm_result = result;
+	arm_channel = channel;
+	arm_event = true;
+	arm_request = false;
+	mutex_exit(&arm_mutex_status);
+}
+
+
+uint32_t arm_result_get(uint32_t* channel)
+{
+	mutex_enter_blocking(&arm_mutex_status);
+	uint32_t result_copy = arm_result;
+	*channel = arm_channel;
+	mutex_exit(&arm_mutex_status);
+
+	return result_copy;
+}
+
+
+// Return and clear the latched arm event
+bool arm_event_take()
+{
+	mutex_enter_blocking(&arm_mutex_status);
+	bool event_copy = arm_event;
+	arm_event = false;
+	mutex_exit(&arm_mutex_status);
+
+	return event_copy;
+}
+
+
+// Check if an arm request was handed to the sequencer core that has not
+// reported its result yet
+bool arm_request_pending()
+{
+	mutex_enter_blocking(&arm_mutex_status);
+	bool request_copy = arm_request;
+	mutex_exit(&arm_mutex_status);
+
+	return request_copy;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// Arm results, reported by the sequencer core for every arm request
+extern const uint32_t ARM_RESULT_PENDING;
+extern const uint32_t ARM_RESULT_OK;
+extern const uint32_t ARM_RESULT_DEBUG;
+extern const uint32_t ARM_RESULT_STOPPED;
+extern const uint32_t ARM_RESULT_CLOCK_MODE;
+extern const uint32_t ARM_RESULT_PULSE;
+
+void arm_status_register(void);
+
+void arm_result_reset(void);
+
+void arm_result_set(uint32_t result, uint32_t channel);
+
+uint32_t arm_result_get(uint32_t* channel);
+
+bool arm_event_take(void);
+
+bool arm_request_pending(void);
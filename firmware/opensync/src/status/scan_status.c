@@ -0,0 +1,62 @@
+#include "scan_status.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/mutex.h"
+
+
+// Mutex for status
+static mutex_t scan_mutex_status;
+uint32_t scan_point[PULSES_MAX] = {0}; // point each pulse sequencer scan is at
+bool scan_point_event = false;
+
+// This must be called in main before anything else.
+void scan_status_register()
+{
+    mutex_init(&scan_mutex_status);
+}
+
+
+// Start every scan at point 0 again, without raising an event
+void scan_point_reset()
+{
+	mutex_enter_blocking(&scan_mutex_status);
+	for (uint32_t i = 0; i < PULSES_MAX; i++)
+	{
+		scan_point[i] = 0;
+	}
+	mutex_exit(&scan_mutex_status);
+}
+
+
+// Record the point a scan moved to. This also latches a point event for the
+// SCPI core to pick up.
+void scan_point_set(uint32_t pulse_id, uint32_t point)
+{
+	mutex_enter_blocking(&scan_mutex_status);
+	scan_point[pulse_id] = point;
+	scan_point_event = true;
+	mutex_exit(&scan_mutex_status);
+}
+
+
+uint32_t scan_point_get(uint32_t pulse_id)
+{
+	mutex_enter_blocking(&scan_mutex_status);
+	uint32_t point_copy = scan_point[pulse_id];
+	mutex_exit(&scan_mutex_status);
+
+	return point_copy;
+}
+
+
+// Return and clear the latched point event
+bool scan_point_event_take()
+{
+	mutex_enter_blocking(&scan_mutex_status);
+	bool event_copy = scan_point_event;
+	scan_point_event = false;
+	mutex_exit(&scan_mutex_status);
+
+	return event_copy;
+}
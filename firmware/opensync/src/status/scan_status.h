@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "structs/pulse_config.h"
+
+
+void scan_status_register(void);
+
+void scan_point_reset(void);
+
+void scan_point_set(uint32_t pulse_id, uint32_t point);
+
+uint32_t scan_point_get(uint32_t pulse_id);
+
+bool scan_point_event_take(void);
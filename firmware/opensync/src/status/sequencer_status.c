@@ -15,9 +15,14 @@ const uint32_t DISARMING = 6;
 
 const uint32_t STAND_BY = 0;
 
+// Run events
+const uint32_t SEQUENCER_EVENT_COMPLETE = 1u << 0;
+const uint32_t SEQUENCER_EVENT_ABORTED = 1u << 1;
+
 // Mutex for status
 static mutex_t sequencer_mutex_status;
 uint32_t sequencer_status = IDLE;
+uint32_t sequencer_event = 0;
 
 // This must be called in main before anything else.
 void sequencer_status_register()
@@ -26,9 +31,21 @@ void sequencer_status_register()
 }
 
 
+// Set the status. A run that is cleaned up latches a complete event, one
+// that ends up aborted an abort event.
 void sequencer_status_set(uint32_t status_new)
 {
 	mutex_enter_blocking(&sequencer_mutex_status);
+	if ((status_new == IDLE) && (sequencer_status == DISARMING))
+	{
+		sequencer_event |= SEQUENCER_EVENT_COMPLETE;
+	}
+
+	else if ((status_new == ABORTED) && (sequencer_status != ABORTED))
+	{
+		sequencer_event |= SEQUENCER_EVENT_ABORTED;
+	}
+
 	sequencer_status = status_new;
 	mutex_exit(&sequencer_mutex_status);
 }
@@ -44,6 +61,18 @@ uint32_t sequencer_status_get()
 }
 
 
+// Return and clear the latched run events
+uint32_t sequencer_event_take()
+{
+	mutex_enter_blocking(&sequencer_mutex_status);
+	uint32_t event_copy = sequencer_event;
+	sequencer_event = 0;
+	mutex_exit(&sequencer_mutex_status);
+
+	return event_copy;
+}
+
+
 const char* sequencer_status_to_str(uint32_t status_copy)
 {
     switch (status_copy)
@@ -14,10 +14,16 @@ extern const uint32_t DISARMING;
 
 extern const uint32_t STAND_BY;
 
+// Run events, latched for the SCPI core
+extern const uint32_t SEQUENCER_EVENT_COMPLETE;
+extern const uint32_t SEQUENCER_EVENT_ABORTED;
+
 void sequencer_status_register(void);
 
 void sequencer_status_set(uint32_t status_new);
 
 uint32_t sequencer_status_get(void);
 
+uint32_t sequencer_event_take(void);
+
 const char* sequencer_status_to_str(uint32_t status_copy);
@@ -0,0 +1,77 @@
+#include "trigger_status.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/mutex.h"
+
+
+// Trigger timeout status
+const uint64_t TRIGGER_TIMEOUT_DISABLED = 0;
+
+
+// Mutex for status
+static mutex_t trigger_mutex_status;
+uint64_t trigger_timeout = TRIGGER_TIMEOUT_DISABLED; // microseconds
+uint32_t trigger_starved = 0; // bit N = clock N starved
+bool trigger_timeout_event = false;
+
+// This must be called in main before anything else.
+void trigger_status_register()
+{
+    mutex_init(&trigger_mutex_status);
+}
+
+
+void trigger_timeout_set(uint64_t timeout_us)
+{
+	mutex_enter_blocking(&trigger_mutex_status);
+	trigger_timeout = timeout_us;
+	mutex_exit(&trigger_mutex_status);
+}
+
+
+uint64_t trigger_timeout_get()
+{
+	mutex_enter_blocking(&trigger_mutex_status);
+	uint64_t timeout_copy = trigger_timeout;
+	mutex_exit(&trigger_mutex_status);
+
+	return timeout_copy;
+}
+
+
+// Record the clocks that starved. A non-zero mask also latches a timeout
+// event for the SCPI core to pick up.
+void trigger_starved_set(uint32_t clock_mask)
+{
+	mutex_enter_blocking(&trigger_mutex_status);
+	trigger_starved = clock_mask;
+
+	if (clock_mask != 0)
+	{
+		trigger_timeout_event = true;
+	}
+	mutex_exit(&trigger_mutex_status);
+}
+
+
+uint32_t trigger_starved_get()
+{
+	mutex_enter_blocking(&trigger_mutex_status);
+	uint32_t starved_copy = trigger_starved;
+	mutex_exit(&trigger_mutex_status);
+
+	return starved_copy;
+}
+
+
+// Return and clear the latched timeout event
+bool trigger_timeout_event_take()
+{
+	mutex_enter_blocking(&trigger_mutex_status);
+	bool event_copy = trigger_timeout_event;
+	trigger_timeout_event = false;
+	mutex_exit(&trigger_mutex_status);
+
+	return event_copy;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// Trigger timeout status
+extern const uint64_t TRIGGER_TIMEOUT_DISABLED;
+
+void trigger_status_register(void);
+
+void trigger_timeout_set(uint64_t timeout_us);
+
+uint64_t trigger_timeout_get(void);
+
+void trigger_starved_set(uint32_t clock_mask);
+
+uint32_t trigger_starved_get(void);
+
+bool trigger_timeout_event_take(void);
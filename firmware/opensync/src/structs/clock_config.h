@@ -7,7 +7,11 @@
 // TODO: Rename this
 #define CLOCK_TRIGGERS_MAX 2
 #define CLOCKS_MAX 3
-#define TRIGGERS_MAX 1
+#define TRIGGERS_MAX 2
+#define CLOCK_TRIGGER_INPUTS_MAX 2
+#define CLOCK_TRIGGER_MASK_WORDS 4
+#define CLOCK_TRIGGER_MASK_BITS_MAX (CLOCK_TRIGGER_MASK_WORDS * 32)
+#define CLOCK_LATENCY_NONE 0xFFFFFFFFu // trigger delay is not latency compensated
 
 typedef enum {
     CLOCK_FREERUN = 0,
@@ -16,7 +20,15 @@ typedef enum {
     CLOCK_TRIGGERED_HIGH,
     CLOCK_TRIGGERED_FALLING,
     CLOCK_TRIGGERED_LOW,
-    CLOCK_TRIGGERED_SNIFFER
+    CLOCK_TRIGGERED_SNIFFER,
+    CLOCK_TRIGGERED_MASK_RISING,
+    CLOCK_TRIGGERED_MASK_FALLING,
+    CLOCK_TRIGGERED_OR_RISING,
+    CLOCK_TRIGGERED_OR_FALLING,
+    CLOCK_TRIGGERED_AND_RISING,
+    CLOCK_TRIGGERED_AND_FALLING,
+    CLOCK_TRIGGERED_ARM_RISING,
+    CLOCK_TRIGGERED_ARM_FALLING
 } clock_pio_program_t;
 
 typedef enum {
@@ -28,6 +40,7 @@ typedef enum {
     CLOCK_TRIG_SOURCE_IMMEDIATE = 0,
     CLOCK_TRIG_SOURCE_EDGE,
     CLOCK_TRIG_SOURCE_GATE,
+    CLOCK_TRIG_SOURCE_MASK,
 } clock_scpi_trigger_source_t;
 
 typedef enum {
@@ -35,6 +48,13 @@ typedef enum {
     CLOCK_TRIG_EDGE_NEGATIVE
 } clock_scpi_trigger_edge_t;
 
+typedef enum {
+    CLOCK_TRIG_LOGIC_SINGLE = 0,
+    CLOCK_TRIG_LOGIC_OR,
+    CLOCK_TRIG_LOGIC_AND,
+    CLOCK_TRIG_LOGIC_ARM
+} clock_scpi_trigger_logic_t;
+
 typedef enum {
     CLOCK_GATE_LEVEL_HIGH = 0,
     CLOCK_GATE_LEVEL_LOW
@@ -55,16 +75,27 @@ struct clock_config
     int dma_chan;
     uint32_t clock_pin;
     uint32_t trigger_pin;
+    uint32_t trigger_pin_aux;
+    uint32_t trigger_inputs;
+    uint32_t trigger_logic;
     uint32_t clock_mode;
     uint32_t trigger_source;
     uint32_t trigger_edge;
     uint32_t trigger_level;
     uint32_t __attribute__((aligned(CLOCK_INSTRUCTIONS_MAX * sizeof(uint32_t)))) instructions[CLOCK_INSTRUCTIONS_MAX];
     uint32_t __attribute__((aligned(CLOCK_TRIGGERS_MAX     * sizeof(uint32_t)))) trigger_config[CLOCK_TRIGGERS_MAX];
+    uint32_t __attribute__((aligned(CLOCK_TRIGGER_MASK_WORDS * sizeof(uint32_t)))) trigger_mask[CLOCK_TRIGGER_MASK_WORDS];
+    uint32_t trigger_mask_words;
+    uint32_t trigger_mask_bits;
+    uint32_t trigger_filter;
+    uint32_t trigger_record;
     uint32_t trigger_reps;
+    uint32_t trigger_latency; // latency subtracted from the trigger delay
     uint32_t clock_divider;
-    double unit_offset;
-    double unit_offset_trigger;
+    uint32_t clock_divider_frac;
+    uint64_t unit_offset; // hertz per unit
+    uint64_t unit_offset_trigger; // nanoseconds per unit
+    bool clock_pin_output;
     bool active;
     bool configured;
 };
\ No newline at end of file
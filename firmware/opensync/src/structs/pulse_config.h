@@ -9,7 +9,48 @@
 #define PULSE_INSTRUCTIONS_OUTPUT_TERM PULSE_INSTRUCTIONS_MAX - 2
 #define PULSE_INSTRUCTIONS_DELAY_TERM PULSE_INSTRUCTIONS_MAX - 1
 #define PULSE_ITERATIONS_MAX 500000
+#define PULSE_STANDARD_STATES_MAX (PULSE_INSTRUCTIONS_MAX / 2 - 1)
+#define PULSE_EXTENDED_WORDS 3
+#define PULSE_EXTENDED_STATES_MAX ((PULSE_INSTRUCTIONS_MAX - 2) / PULSE_EXTENDED_WORDS)
+#define PULSE_PACKED_STATES_MAX (PULSE_INSTRUCTIONS_MAX - 1)
+#define PULSE_PACKED_STATE_BITS 8
+#define PULSE_FAST_TERM_WORDS 2
+#define PULSE_FAST_STATE_WORDS_MAX (PULSE_INSTRUCTIONS_MAX - PULSE_FAST_TERM_WORDS)
+#define PULSE_REPEAT_COUNT_MAX (1u << 23) // DMA transfer counts are limited to 28 bits
+#define PULSE_SEQUENCES_MAX 8
+#define PULSE_LATENCY_NONE 0xFFFFFFFFu // first state is not latency compensated
+#define PULSE_SEQUENCE_STEPS_MAX 8 // step list is a DMA ring, so a power of two
+#define PULSE_SEQUENCE_SELECT_BITS 2 // one bit per external trigger input
+#define PULSE_SCAN_POINTS_MAX 32
 
+typedef enum {
+    PULSE_INPUT_CLOCK = 0,
+    PULSE_INPUT_EXTERNAL,
+    PULSE_INPUT_CLOCK_IRQ
+} pulse_input_source_t;
+
+typedef enum {
+    PULSE_FORMAT_STANDARD = 0,
+    PULSE_FORMAT_EXTENDED,
+    PULSE_FORMAT_PACKED,
+    PULSE_FORMAT_FAST
+} pulse_instruction_format_t;
+
+typedef enum {
+    PULSE_SEQUENCE_OFF = 0,
+    PULSE_SEQUENCE_BUS,
+    PULSE_SEQUENCE_EXTERNAL,
+    PULSE_SEQUENCE_LIST
+} pulse_sequence_mode_t;
+
+// A stored entry of the sequence table, streamed in place of the loaded
+// instructions while the sequence table is in use
+struct pulse_sequence
+{
+    uint32_t instructions[PULSE_INSTRUCTIONS_MAX];
+    uint32_t instruction_format;
+    uint32_t instruction_words;
+};
 
 struct pulse_config
 {
@@ -18,11 +59,35 @@ struct pulse_config
     uint out_pins_base;
     uint out_pins_count;
     uint clock_pin;
+    uint32_t input_source;
+    uint32_t clock_irq;
     int dma_chan;
+    int dma_chan_repeat;
     uint program_offset;
     uint32_t __attribute__((aligned(PULSE_INSTRUCTIONS_MAX * sizeof(uint32_t)))) instructions[PULSE_INSTRUCTIONS_MAX];
     uint clock_divider;
-    double unit_offset;
+    uint clock_divider_frac;
+    uint64_t unit_offset; // nanoseconds per unit
+    uint32_t instruction_format;
+    uint32_t instruction_words;
+    uint32_t linear_offset;
+    uint32_t linear_words;
+    uint32_t repeat_offset;
+    uint32_t repeat_words;
+    uint32_t repeat_count;
+    uint32_t input_latency; // latency subtracted from the first state
+    struct pulse_sequence sequences[PULSE_SEQUENCES_MAX];
+    uint32_t sequences_stored; // bit mask of stored entries
+    uint32_t sequence_mode;
+    uint32_t sequence_select;
+    uint32_t sequence_steps[PULSE_SEQUENCE_STEPS_MAX];
+    uint32_t sequence_step_count;
+    uint32_t scan_state;    // state whose delay is swept
+    uint32_t scan_start;    // delay cycles of the first point
+    uint32_t scan_step;     // delay cycles added per point
+    uint32_t scan_points;   // 0 = no scan
+    uint32_t scan_triggers; // sequences per point
+    uint32_t scan_marker;   // outputs raised in the first sequence of a point
     bool active;
     bool configured;
 };
\ No newline at end of file
@@ -0,0 +1,536 @@
+#include "config_slots.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/time.h"
+
+#include "status/arm_status.h"
+#include "config_snapshot.h"
+
+#define CONFIG_SLOT_RECORD_MAGIC 0x544F4C53u   // "SLOT"
+#define CONFIG_SLOT_SETTINGS_MAGIC 0x4F545541u // "AUTO"
+#define CONFIG_SLOT_ERASED 0xFFFFFFFFu
+
+// Every record starts with its magic and a sequence number, the newest valid
+// record of a log wins
+struct config_slot_header
+{
+    uint32_t magic;
+    uint32_t sequence;
+};
+
+struct config_slot_record
+{
+    struct config_slot_header header;
+    struct config_snapshot snapshot;
+};
+
+struct config_slot_settings
+{
+    struct config_slot_header header;
+    uint32_t autostart;
+    uint32_t slot;
+    uint32_t clock_mhz; // boot clock profile, 0 for the build default
+    uint32_t crc; // CRC-32 of the words above
+};
+
+// Records are padded to whole flash pages so each one is a single program.
+// A bank holds at least CONFIG_SLOT_BANK_RECORDS_MIN records, so a slot is
+// erased once every that many saves.
+#define CONFIG_SLOT_BANKS 2
+#define CONFIG_SLOT_BANK_RECORDS_MIN 8
+#define CONFIG_SLOT_RECORD_SIZE \
+    (((sizeof(struct config_slot_record) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE) * FLASH_PAGE_SIZE)
+#define CONFIG_SLOT_BANK_SIZE \
+    (((CONFIG_SLOT_BANK_RECORDS_MIN * CONFIG_SLOT_RECORD_SIZE + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE) * FLASH_SECTOR_SIZE)
+#define CONFIG_SLOT_SETTINGS_BANK_SIZE FLASH_SECTOR_SIZE
+
+// The slot banks followed by the settings banks at the end of flash
+#define CONFIG_SLOT_SETTINGS_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - CONFIG_SLOT_BANKS * CONFIG_SLOT_SETTINGS_BANK_SIZE)
+#define CONFIG_SLOTS_FLASH_OFFSET \
+    (CONFIG_SLOT_SETTINGS_FLASH_OFFSET - CONFIG_SLOTS_MAX * CONFIG_SLOT_BANKS * CONFIG_SLOT_BANK_SIZE)
+
+_Static_assert(
+    sizeof(struct config_slot_settings) <= FLASH_PAGE_SIZE,
+    "A settings record does not fit into a flash page"
+);
+
+// A log of records in two banks. Records are appended to the bank of the
+// newest record. A full bank continues in the other one, which is erased
+// first, so the newest record is never erased before its successor is
+// written.
+struct config_slot_log
+{
+    uint32_t flash_offset; // first bank, the second one follows it
+    uint32_t bank_size;
+    uint32_t record_size;
+    bool (*record_validate)(const struct config_slot_header* header);
+};
+
+// Where the next record of a log goes
+struct config_slot_position
+{
+    const struct config_slot_header* newest; // NULL if the log is empty
+    uint32_t bank;
+    uint32_t position; // 0 erases the bank first
+    uint32_t sequence;
+};
+
+struct config_slot_write
+{
+    uint32_t offset;
+    const uint8_t* data;
+    size_t length;
+};
+
+// Programs are taken from RAM, flash is not readable while it is written
+static uint8_t __attribute__((aligned(4))) config_slot_page_buffer[CONFIG_SLOT_RECORD_SIZE];
+
+
+// Make sure the slot is within range
+bool config_slot_validate(
+    uint32_t slot
+) {
+    return slot < CONFIG_SLOTS_MAX;
+}
+
+
+// Get a pointer to flash contents through the XIP window
+static const uint8_t* config_slot_flash_get(
+    uint32_t offset
+) {
+    return (const uint8_t*) (uintptr_t) (XIP_BASE + offset);
+}
+
+
+// Runs with the other core parked and interrupts disabled
+static void config_slot_flash_erase(
+    void* param
+) {
+    const struct config_slot_write* write = (const struct config_slot_write*) param;
+
+    flash_range_erase(
+        write -> offset,
+        FLASH_SECTOR_SIZE
+    );
+}
+
+
+// Runs with the other core parked and interrupts disabled
+static void config_slot_flash_program(
+    void* param
+) {
+    const struct config_slot_write* write = (const struct config_slot_write*) param;
+
+    flash_range_program(
+        write -> offset,
+        write -> data,
+        write -> length
+    );
+}
+
+
+// Get the flash offset of a record position of a log
+static uint32_t config_slot_log_offset_get(
+    const struct config_slot_log* log,
+    uint32_t bank,
+    uint32_t position
+) {
+    return log -> flash_offset + bank * log -> bank_size + position * log -> record_size;
+}
+
+
+// Find the newest valid record of a log and where the next one goes. A torn
+// write leaves a record that fails validation, it is skipped.
+static void config_slot_log_find(
+    const struct config_slot_log* log,
+    struct config_slot_position* next
+) {
+    const uint32_t records = log -> bank_size / log -> record_size;
+    uint32_t erased[CONFIG_SLOT_BANKS] = {0};
+    uint32_t newest_bank = 0;
+
+    next -> newest = NULL;
+
+    for (uint32_t bank = 0; bank < CONFIG_SLOT_BANKS; bank++)
+    {
+        erased[bank] = records;
+
+        for (uint32_t i = 0; i < records; i++)
+        {
+            const struct config_slot_header* header = (const struct config_slot_header*) config_slot_flash_get(
+                config_slot_log_offset_get(log, bank, i)
+            );
+
+            // Records are appended in order, the first erased one ends the bank
+            if (header -> magic == CONFIG_SLOT_ERASED)
+            {
+                erased[bank] = i;
+                break;
+            }
+
+            if (log -> record_validate(header) &&
+                ((next -> newest == NULL) ||
+                 ((int32_t) (header -> sequence - next -> newest -> sequence) > 0)))
+            {
+                next -> newest = header;
+                newest_bank = bank;
+            }
+        }
+    }
+
+    next -> sequence = (next -> newest != NULL) ? next -> newest -> sequence + 1 : 0;
+    next -> bank = newest_bank;
+    next -> position = erased[newest_bank];
+
+    // Full bank, continue in the other one
+    if (next -> position == records)
+    {
+        next -> bank = (newest_bank + 1) % CONFIG_SLOT_BANKS;
+        next -> position = 0;
+    }
+}
+
+
+// Wait until the sequencer core has answered every arm request, so it has
+// taken the request off the inter-core FIFO. Where the SDK parks the core
+// for flash writes through the FIFO (RP2040 style lockout) its handler
+// drains the FIFO and would drop a request queued right before a save, e.g.
+// the autostart arm or *SAV right after DEVice:START.
+static bool config_slot_arm_wait()
+{
+    const absolute_time_t deadline = make_timeout_time_ms(CONFIG_SLOT_ARM_TIMEOUT_MS);
+
+    while (arm_request_pending())
+    {
+        if (time_reached(deadline))
+        {
+            return false;
+        }
+
+        sleep_us(10);
+    }
+
+    return true;
+}
+
+
+// Write a record at the next position of a log. The first record of a bank
+// erases the bank first, one sector at a time so interrupts are not held off
+// for the whole bank.
+static bool config_slot_log_write(
+    const struct config_slot_log* log,
+    const struct config_slot_position* next,
+    const uint8_t* data
+) {
+    struct config_slot_write write = {
+        .offset = config_slot_log_offset_get(log, next -> bank, 0),
+        .data = data,
+        .length = log -> record_size,
+    };
+
+    if (!config_slot_arm_wait())
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; (next -> position == 0) && (i < log -> bank_size / FLASH_SECTOR_SIZE); i++)
+    {
+        write.offset = config_slot_log_offset_get(log, next -> bank, 0) + i * FLASH_SECTOR_SIZE;
+
+        if (flash_safe_execute(
+            config_slot_flash_erase,
+            &write,
+            CONFIG_SLOT_LOCKOUT_TIMEOUT_MS
+        ) != PICO_OK) {
+            return false;
+        }
+    }
+
+    write.offset = config_slot_log_offset_get(log, next -> bank, next -> position);
+
+    return flash_safe_execute(
+        config_slot_flash_program,
+        &write,
+        CONFIG_SLOT_LOCKOUT_TIMEOUT_MS
+    ) == PICO_OK;
+}
+
+
+// A slot record is valid if its snapshot passes the checks
+static bool config_slot_record_validate(
+    const struct config_slot_header* header
+) {
+    const struct config_slot_record* record = (const struct config_slot_record*) header;
+
+    return (header -> magic == CONFIG_SLOT_RECORD_MAGIC) &&
+        (config_snapshot_verify(&record -> snapshot, CONFIG_SNAPSHOT_SIZE) == CONFIG_SNAPSHOT_OK);
+}
+
+
+// Get the log of a slot
+static struct config_slot_log config_slot_log_get(
+    uint32_t slot
+) {
+    return (struct config_slot_log) {
+        .flash_offset = CONFIG_SLOTS_FLASH_OFFSET + slot * CONFIG_SLOT_BANKS * CONFIG_SLOT_BANK_SIZE,
+        .bank_size = CONFIG_SLOT_BANK_SIZE,
+        .record_size = CONFIG_SLOT_RECORD_SIZE,
+        .record_validate = config_slot_record_validate,
+    };
+}
+
+
+// Save the staged configs to a slot. Saving a configuration identical to the
+// stored one does not touch flash.
+uint32_t config_slot_save(
+    uint32_t slot
+) {
+    struct config_slot_record* record = (struct config_slot_record*) config_slot_page_buffer;
+    struct config_slot_position next;
+
+    if (!config_slot_validate(slot))
+    {
+        return CONFIG_SLOT_INVALID;
+    }
+
+    const struct config_slot_log log = config_slot_log_get(slot);
+
+    config_slot_log_find(
+        &log,
+        &next
+    );
+
+    const struct config_slot_record* newest = (const struct config_slot_record*) next.newest;
+
+    memset(config_slot_page_buffer, 0xFF, sizeof(config_slot_page_buffer));
+
+    config_snapshot_save(&record -> snapshot);
+
+    if ((newest != NULL) &&
+        (memcmp(&newest -> snapshot, &record -> snapshot, CONFIG_SNAPSHOT_SIZE) == 0))
+    {
+        return CONFIG_SLOT_OK;
+    }
+
+    record -> header.magic = CONFIG_SLOT_RECORD_MAGIC;
+    record -> header.sequence = next.sequence;
+
+    if (!config_slot_log_write(
+        &log,
+        &next,
+        config_slot_page_buffer
+    )) {
+        return CONFIG_SLOT_FLASH_ERROR;
+    }
+
+    return CONFIG_SLOT_OK;
+}
+
+
+// Load the newest record of a slot into the staged configs, see
+// config_snapshot_load
+uint32_t config_slot_recall(
+    uint32_t slot
+) {
+    struct config_slot_record* record = (struct config_slot_record*) config_slot_page_buffer;
+    struct config_slot_position next;
+
+    if (!config_slot_validate(slot))
+    {
+        return CONFIG_SLOT_INVALID;
+    }
+
+    const struct config_slot_log log = config_slot_log_get(slot);
+
+    config_slot_log_find(
+        &log,
+        &next
+    );
+
+    if (next.newest == NULL)
+    {
+        return CONFIG_SLOT_EMPTY;
+    }
+
+    // Copy out of flash so the records are aligned
+    memcpy(record, next.newest, sizeof(*record));
+
+    if (config_snapshot_load(
+        &record -> snapshot,
+        CONFIG_SNAPSHOT_SIZE
+    ) != CONFIG_SNAPSHOT_OK) {
+        return CONFIG_SLOT_INVALID;
+    }
+
+    return CONFIG_SLOT_OK;
+}
+
+
+// Get the CRC-32 of an autostart settings record
+static uint32_t config_slot_settings_crc_get(
+    const struct config_slot_settings* settings
+) {
+    return config_snapshot_crc32(
+        (const uint8_t*) settings,
+        offsetof(struct config_slot_settings, crc),
+        0
+    );
+}
+
+
+// A settings record is valid if its CRC matches
+static bool config_slot_settings_validate(
+    const struct config_slot_header* header
+) {
+    const struct config_slot_settings* settings = (const struct config_slot_settings*) header;
+
+    return (header -> magic == CONFIG_SLOT_SETTINGS_MAGIC) &&
+        (settings -> crc == config_slot_settings_crc_get(settings));
+}
+
+
+static const struct config_slot_log config_slot_settings_log = {
+    .flash_offset = CONFIG_SLOT_SETTINGS_FLASH_OFFSET,
+    .bank_size = CONFIG_SLOT_SETTINGS_BANK_SIZE,
+    .record_size = FLASH_PAGE_SIZE,
+    .record_validate = config_slot_settings_validate,
+};
+
+
+// Find the newest valid settings and where the next record goes
+static const struct config_slot_settings* config_slot_settings_find(
+    struct config_slot_position* next
+) {
+    config_slot_log_find(
+        &config_slot_settings_log,
+        next
+    );
+
+    return (const struct config_slot_settings*) next -> newest;
+}
+
+
+// Append a settings record with the values of the newest record changed by
+// the autostart or the clock profile setting. Writes nothing if the values
+// are stored already.
+static uint32_t config_slot_settings_write(
+    const struct config_slot_position* next,
+    uint32_t autostart,
+    uint32_t slot,
+    uint32_t clock_mhz
+) {
+    struct config_slot_settings* settings = (struct config_slot_settings*) config_slot_page_buffer;
+    const struct config_slot_settings* newest = (const struct config_slot_settings*) next -> newest;
+
+    if ((newest != NULL) &&
+        (newest -> autostart == autostart) &&
+        (newest -> slot == slot) &&
+        (newest -> clock_mhz == clock_mhz))
+    {
+        return CONFIG_SLOT_OK;
+    }
+
+    memset(config_slot_page_buffer, 0xFF, FLASH_PAGE_SIZE);
+
+    settings -> header.magic = CONFIG_SLOT_SETTINGS_MAGIC;
+    settings -> header.sequence = next -> sequence;
+    settings -> autostart = autostart;
+    settings -> slot = slot;
+    settings -> clock_mhz = clock_mhz;
+    settings -> crc = config_slot_settings_crc_get(settings);
+
+    if (!config_slot_log_write(
+        &config_slot_settings_log,
+        next,
+        config_slot_page_buffer
+    )) {
+        return CONFIG_SLOT_FLASH_ERROR;
+    }
+
+    return CONFIG_SLOT_OK;
+}
+
+
+// Get the autostart slot, returns whether autostart is enabled
+bool config_slot_autostart_get(
+    uint32_t* slot
+) {
+    struct config_slot_position next;
+
+    const struct config_slot_settings* settings = config_slot_settings_find(&next);
+
+    *slot = 0;
+
+    if ((settings == NULL) ||
+        !config_slot_validate(settings -> slot))
+    {
+        return false;
+    }
+
+    *slot = settings -> slot;
+
+    return settings -> autostart != 0;
+}
+
+
+// Store the autostart settings, the clock profile is kept
+uint32_t config_slot_autostart_set(
+    bool enabled,
+    uint32_t slot
+) {
+    struct config_slot_position next;
+
+    if (!config_slot_validate(slot))
+    {
+        return CONFIG_SLOT_INVALID;
+    }
+
+    const struct config_slot_settings* newest = config_slot_settings_find(&next);
+
+    return config_slot_settings_write(
+        &next,
+        enabled ? 1 : 0,
+        slot,
+        (newest != NULL) ? newest -> clock_mhz : 0
+    );
+}
+
+
+// Get the clock profile in MHz to boot with, 0 if none is stored
+uint32_t config_slot_clock_profile_get()
+{
+    struct config_slot_position next;
+
+    const struct config_slot_settings* settings = config_slot_settings_find(&next);
+
+    if (settings == NULL)
+    {
+        return 0;
+    }
+
+    return settings -> clock_mhz;
+}
+
+
+// Store the clock profile in MHz to boot with, the autostart settings are
+// kept. 0 selects the build default.
+uint32_t config_slot_clock_profile_set(
+    uint32_t clock_mhz
+) {
+    struct config_slot_position next;
+
+    const struct config_slot_settings* newest = config_slot_settings_find(&next);
+
+    return config_slot_settings_write(
+        &next,
+        (newest != NULL) ? newest -> autostart : 0,
+        (newest != NULL) ? newest -> slot : 0,
+        clock_mhz
+    );
+}
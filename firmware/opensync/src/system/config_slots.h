@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config_snapshot.h"
+
+
+// Configuration slots for *SAV and *RCL, kept in the last flash sectors. Every
+// slot owns two banks and appends page aligned records to them. A bank is
+// only erased once the other one is full, so the newest record survives a
+// power loss during a save. Two sectors after the slots hold the autostart
+// and boot clock profile settings the same way.
+#define CONFIG_SLOTS_MAX 4
+#define CONFIG_SLOT_LOCKOUT_TIMEOUT_MS 100
+#define CONFIG_SLOT_ARM_TIMEOUT_MS 1000
+
+typedef enum {
+    CONFIG_SLOT_OK = 0,
+    CONFIG_SLOT_EMPTY,
+    CONFIG_SLOT_INVALID,
+    CONFIG_SLOT_FLASH_ERROR
+} config_slot_result_t;
+
+bool config_slot_validate(
+    uint32_t slot
+);
+
+uint32_t config_slot_save(
+    uint32_t slot
+);
+
+uint32_t config_slot_recall(
+    uint32_t slot
+);
+
+bool config_slot_autostart_get(
+    uint32_t* slot
+);
+
+uint32_t config_slot_autostart_set(
+    bool enabled,
+    uint32_t slot
+);
+
+uint32_t config_slot_clock_profile_get();
+
+uint32_t config_slot_clock_profile_set(
+    uint32_t clock_mhz
+);
@@ -0,0 +1,604 @@
+#include "config_snapshot.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "core_1.h"
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+#include "sequencer/sequencer_common.h"
+#include "sequencer/sequencer_clock.h"
+
+// Staged configs from before the last load, put back by a restore
+static struct clock_config snapshot_clock_backup[CLOCKS_MAX];
+static struct pulse_config snapshot_pulse_backup[PULSES_MAX];
+
+
+// Bitwise CRC-32 (IEEE 802.3, reflected), pass 0 as crc to start a new one
+uint32_t config_snapshot_crc32(
+    const uint8_t* data,
+    size_t length,
+    uint32_t crc
+) {
+    const uint32_t POLYNOMIAL = 0xEDB88320u;
+
+    crc = ~crc;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (POLYNOMIAL & -(crc & 1u));
+        }
+    }
+
+    return ~crc;
+}
+
+
+// Check whether a GPIO is one of the pins in a pin table
+static bool config_snapshot_pin_validate(
+    uint32_t pin,
+    const uint32_t* pins,
+    uint32_t pins_count
+) {
+    for (uint32_t i = 0; i < pins_count; i++)
+    {
+        if (pins[i] == pin)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+// Check a 16.8 fixed point clock divider given as integer and fraction
+static bool config_snapshot_divider_validate(
+    uint32_t clock_divider,
+    uint32_t clock_divider_frac
+) {
+    if ((clock_divider > CLOCK_DIVIDER_MAX) ||
+        (clock_divider_frac >= (1u << CLOCK_DIVIDER_FRAC_BITS)))
+    {
+        return 0;
+    }
+
+    return clock_divider_fixed_validate(
+        (clock_divider << CLOCK_DIVIDER_FRAC_BITS) | clock_divider_frac
+    );
+}
+
+
+// Apply the same limits as the clock setters
+static bool config_snapshot_clock_validate(
+    const struct config_snapshot_clock* record
+) {
+    uint32_t mask_words = 0;
+
+    if (!validate_clock_mode(record -> clock_mode) ||
+        !validate_trigger_mode(record -> trigger_source) ||
+        !validate_trigger_edge(record -> trigger_edge) ||
+        !validate_trigger_level(record -> trigger_level) ||
+        !validate_trigger_logic(record -> trigger_logic))
+    {
+        return 0;
+    }
+
+    if ((record -> trigger_inputs == 0) ||
+        (record -> trigger_inputs > CLOCK_TRIGGER_INPUTS_MAX) ||
+        !config_snapshot_pin_validate(record -> trigger_pin, EXTERNAL_TRIGGER_PINS, TRIGGERS_MAX) ||
+        !config_snapshot_pin_validate(record -> trigger_pin_aux, EXTERNAL_TRIGGER_PINS, TRIGGERS_MAX))
+    {
+        return 0;
+    }
+
+    // The same input can not be combined with itself
+    if ((record -> trigger_inputs == CLOCK_TRIGGER_INPUTS_MAX) &&
+        (record -> trigger_pin == record -> trigger_pin_aux))
+    {
+        return 0;
+    }
+
+    // The mask split must be the one the mask setter would have picked
+    if ((record -> trigger_mask_bits == 0) ||
+        (record -> trigger_mask_bits > 32) ||
+        (record -> trigger_mask_words > CLOCK_TRIGGER_MASK_WORDS) ||
+        !sequencer_clock_trigger_mask_words_get(
+            record -> trigger_mask_words * record -> trigger_mask_bits,
+            &mask_words
+        ) ||
+        (mask_words != record -> trigger_mask_words))
+    {
+        return 0;
+    }
+
+    if ((record -> trigger_config[0] > TRIGGER_SKIPS_MAX) ||
+        (record -> trigger_filter > TRIGGER_FILTER_MAX) ||
+        (record -> trigger_reps > ITERATIONS_MAX))
+    {
+        return 0;
+    }
+
+    if (!config_snapshot_divider_validate(
+        record -> clock_divider,
+        record -> clock_divider_frac
+    )) {
+        return 0;
+    }
+
+    if ((record -> unit_offset == 0) ||
+        (record -> unit_offset_trigger == 0))
+    {
+        return 0;
+    }
+
+    return record -> active <= 1;
+}
+
+
+// Check the format and length of loaded or stored instructions. The DMA ring
+// needs a power of two amount of words.
+static bool config_snapshot_instructions_validate(
+    uint32_t instruction_format,
+    uint32_t instruction_words
+) {
+    return (instruction_format <= PULSE_FORMAT_FAST) &&
+        (instruction_words >= 2) &&
+        (instruction_words <= PULSE_INSTRUCTIONS_MAX) &&
+        !(instruction_words & (instruction_words - 1));
+}
+
+
+// Apply the same limits as the sequence table setters, whether the entries
+// match the loaded instructions is checked when the configuration is
+// committed
+static bool config_snapshot_sequence_validate(
+    const struct config_snapshot_pulse* record
+) {
+    if ((record -> sequences_stored >= (1u << PULSE_SEQUENCES_MAX)) ||
+        (record -> sequence_mode > PULSE_SEQUENCE_LIST) ||
+        (record -> sequence_select >= PULSE_SEQUENCES_MAX))
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < PULSE_SEQUENCES_MAX; i++)
+    {
+        if ((record -> sequences_stored & (1u << i)) &&
+            !config_snapshot_instructions_validate(
+                record -> sequences[i].instruction_format,
+                record -> sequences[i].instruction_words
+            ))
+        {
+            return 0;
+        }
+    }
+
+    // The step list is a DMA ring as well
+    if ((record -> sequence_step_count == 0) ||
+        (record -> sequence_step_count > PULSE_SEQUENCE_STEPS_MAX) ||
+        (record -> sequence_step_count & (record -> sequence_step_count - 1)))
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < record -> sequence_step_count; i++)
+    {
+        if (record -> sequence_steps[i] >= PULSE_SEQUENCES_MAX)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+// Apply the same limits as the pulse setters, the program itself is checked
+// when the configuration is committed
+static bool config_snapshot_pulse_validate(
+    const struct config_snapshot_pulse* record
+) {
+    switch (record -> input_source)
+    {
+        case PULSE_INPUT_CLOCK:
+        case PULSE_INPUT_CLOCK_IRQ:
+            if (!config_snapshot_pin_validate(record -> clock_pin, INTERNAL_CLOCK_PINS, CLOCKS_MAX))
+            {
+                return 0;
+            }
+            break;
+
+        case PULSE_INPUT_EXTERNAL:
+            if (!config_snapshot_pin_validate(record -> clock_pin, EXTERNAL_TRIGGER_PINS, TRIGGERS_MAX))
+            {
+                return 0;
+            }
+            break;
+
+        default:
+            return 0;
+    }
+
+    if (!config_snapshot_divider_validate(
+        record -> clock_divider,
+        record -> clock_divider_frac
+    )) {
+        return 0;
+    }
+
+    if (record -> unit_offset == 0)
+    {
+        return 0;
+    }
+
+    if (!config_snapshot_instructions_validate(
+        record -> instruction_format,
+        record -> instruction_words
+    )) {
+        return 0;
+    }
+
+    // Repeat rings are only used with a repeat count
+    if (record -> repeat_count > 0)
+    {
+        const uint32_t offsets[] = {record -> linear_offset, record -> repeat_offset};
+        const uint32_t words[] = {record -> linear_words, record -> repeat_words};
+
+        if (record -> repeat_count > PULSE_REPEAT_COUNT_MAX)
+        {
+            return 0;
+        }
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if ((words[i] == 0) ||
+                (words[i] & (words[i] - 1)) ||
+                (offsets[i] % words[i]) ||
+                ((offsets[i] + words[i]) > PULSE_INSTRUCTIONS_MAX))
+            {
+                return 0;
+            }
+        }
+    }
+
+    if (!config_snapshot_sequence_validate(record))
+    {
+        return 0;
+    }
+
+    // Whether every scan point can be encoded is checked at commit
+    if ((record -> scan_points > PULSE_SCAN_POINTS_MAX) ||
+        (record -> scan_triggers == 0) ||
+        (record -> scan_marker & ~OUT_MASK))
+    {
+        return 0;
+    }
+
+    return record -> active <= 1;
+}
+
+
+// Fill the snapshot record of a clock config
+static void config_snapshot_clock_record_get(
+    const struct clock_config* config,
+    struct config_snapshot_clock* record
+) {
+    memset(record, 0, sizeof(*record));
+
+    record -> trigger_pin = config -> trigger_pin;
+    record -> trigger_pin_aux = config -> trigger_pin_aux;
+    record -> trigger_inputs = config -> trigger_inputs;
+    record -> trigger_logic = config -> trigger_logic;
+    record -> clock_mode = config -> clock_mode;
+    record -> trigger_source = config -> trigger_source;
+    record -> trigger_edge = config -> trigger_edge;
+    record -> trigger_level = config -> trigger_level;
+    memcpy(record -> instructions, config -> instructions, sizeof(record -> instructions));
+    memcpy(record -> trigger_config, config -> trigger_config, sizeof(record -> trigger_config));
+    memcpy(record -> trigger_mask, config -> trigger_mask, sizeof(record -> trigger_mask));
+    record -> trigger_mask_words = config -> trigger_mask_words;
+    record -> trigger_mask_bits = config -> trigger_mask_bits;
+    record -> trigger_filter = config -> trigger_filter;
+    record -> trigger_reps = config -> trigger_reps;
+    record -> clock_divider = config -> clock_divider;
+    record -> clock_divider_frac = config -> clock_divider_frac;
+    record -> unit_offset = config -> unit_offset;
+    record -> unit_offset_trigger = config -> unit_offset_trigger;
+    record -> active = config -> active;
+}
+
+
+// Fill the snapshot record of a pulse config
+static void config_snapshot_pulse_record_get(
+    const struct pulse_config* config,
+    struct config_snapshot_pulse* record
+) {
+    memset(record, 0, sizeof(*record));
+
+    record -> clock_pin = config -> clock_pin;
+    record -> input_source = config -> input_source;
+    record -> clock_divider = config -> clock_divider;
+    record -> clock_divider_frac = config -> clock_divider_frac;
+    record -> unit_offset = config -> unit_offset;
+    memcpy(record -> instructions, config -> instructions, sizeof(record -> instructions));
+    record -> instruction_format = config -> instruction_format;
+    record -> instruction_words = config -> instruction_words;
+    record -> linear_offset = config -> linear_offset;
+    record -> linear_words = config -> linear_words;
+    record -> repeat_offset = config -> repeat_offset;
+    record -> repeat_words = config -> repeat_words;
+    record -> repeat_count = config -> repeat_count;
+
+    // Entries that are not stored are left zero, so they don't change the hash
+    for (uint32_t i = 0; i < PULSE_SEQUENCES_MAX; i++)
+    {
+        if (config -> sequences_stored & (1u << i))
+        {
+            memcpy(record -> sequences[i].instructions, config -> sequences[i].instructions, sizeof(record -> sequences[i].instructions));
+            record -> sequences[i].instruction_format = config -> sequences[i].instruction_format;
+            record -> sequences[i].instruction_words = config -> sequences[i].instruction_words;
+        }
+    }
+
+    record -> sequences_stored = config -> sequences_stored;
+    record -> sequence_mode = config -> sequence_mode;
+    record -> sequence_select = config -> sequence_select;
+    memcpy(record -> sequence_steps, config -> sequence_steps, config -> sequence_step_count * sizeof(uint32_t));
+    record -> sequence_step_count = config -> sequence_step_count;
+    record -> scan_state = config -> scan_state;
+    record -> scan_start = config -> scan_start;
+    record -> scan_step = config -> scan_step;
+    record -> scan_points = config -> scan_points;
+    record -> scan_triggers = config -> scan_triggers;
+    record -> scan_marker = config -> scan_marker;
+    record -> active = config -> active;
+}
+
+
+// Serialize the staged clock and pulse configs
+void config_snapshot_save(
+    struct config_snapshot* snapshot
+) {
+    struct clock_config* clock_array = sequencer_clock_config_get();
+    struct pulse_config* pulse_array = sequencer_pulse_config_get();
+
+    memset(&snapshot -> header, 0, sizeof(snapshot -> header));
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        config_snapshot_clock_record_get(
+            &clock_array[i],
+            &snapshot -> clocks[i]
+        );
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        config_snapshot_pulse_record_get(
+            &pulse_array[i],
+            &snapshot -> pulses[i]
+        );
+    }
+
+    snapshot -> header.magic = CONFIG_SNAPSHOT_MAGIC;
+    snapshot -> header.version = CONFIG_SNAPSHOT_VERSION;
+    snapshot -> header.clocks = CLOCKS_MAX;
+    snapshot -> header.pulses = PULSES_MAX;
+    snapshot -> header.length = CONFIG_SNAPSHOT_SIZE - sizeof(snapshot -> header);
+    snapshot -> header.crc = config_snapshot_crc32(
+        (const uint8_t*) snapshot + sizeof(snapshot -> header),
+        snapshot -> header.length,
+        0
+    );
+}
+
+
+// Get the CRC-32 of the snapshot record of every published clock config,
+// followed by every published pulse config. A host can compare them with the
+// CRC-32 of the matching records of its own snapshot.
+void config_snapshot_hash_get(
+    uint32_t hashes[CLOCKS_MAX + PULSES_MAX]
+) {
+    const struct clock_config* clock_array = sequencer_clock_config_published_get();
+    const struct pulse_config* pulse_array = sequencer_pulse_config_published_get();
+
+    struct config_snapshot_clock clock_record;
+    struct config_snapshot_pulse pulse_record;
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        config_snapshot_clock_record_get(
+            &clock_array[i],
+            &clock_record
+        );
+
+        hashes[i] = config_snapshot_crc32(
+            (const uint8_t*) &clock_record,
+            sizeof(clock_record),
+            0
+        );
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        config_snapshot_pulse_record_get(
+            &pulse_array[i],
+            &pulse_record
+        );
+
+        hashes[CLOCKS_MAX + i] = config_snapshot_crc32(
+            (const uint8_t*) &pulse_record,
+            sizeof(pulse_record),
+            0
+        );
+    }
+}
+
+
+// Check the length, header and CRC of a snapshot
+uint32_t config_snapshot_verify(
+    const struct config_snapshot* snapshot,
+    size_t length
+) {
+    if (length != CONFIG_SNAPSHOT_SIZE)
+    {
+        return CONFIG_SNAPSHOT_LENGTH_MISMATCH;
+    }
+
+    if ((snapshot -> header.magic != CONFIG_SNAPSHOT_MAGIC) ||
+        (snapshot -> header.version != CONFIG_SNAPSHOT_VERSION) ||
+        (snapshot -> header.clocks != CLOCKS_MAX) ||
+        (snapshot -> header.pulses != PULSES_MAX) ||
+        (snapshot -> header.length != CONFIG_SNAPSHOT_SIZE - sizeof(snapshot -> header)))
+    {
+        return CONFIG_SNAPSHOT_HEADER_MISMATCH;
+    }
+
+    if (snapshot -> header.crc != config_snapshot_crc32(
+        (const uint8_t*) snapshot + sizeof(snapshot -> header),
+        snapshot -> header.length,
+        0
+    )) {
+        return CONFIG_SNAPSHOT_CRC_MISMATCH;
+    }
+
+    return CONFIG_SNAPSHOT_OK;
+}
+
+
+// Check a snapshot and write it to the staged configs. Nothing is written
+// unless every record passes, the previous staged configs are kept for
+// config_snapshot_restore.
+uint32_t config_snapshot_load(
+    const struct config_snapshot* snapshot,
+    size_t length
+) {
+    struct clock_config* clock_array = sequencer_clock_config_get();
+    struct pulse_config* pulse_array = sequencer_pulse_config_get();
+
+    const uint32_t result = config_snapshot_verify(
+        snapshot,
+        length
+    );
+
+    if (result != CONFIG_SNAPSHOT_OK)
+    {
+        return result;
+    }
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        if (!config_snapshot_clock_validate(&snapshot -> clocks[i]))
+        {
+            return CONFIG_SNAPSHOT_OUT_OF_RANGE;
+        }
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if (!config_snapshot_pulse_validate(&snapshot -> pulses[i]))
+        {
+            return CONFIG_SNAPSHOT_OUT_OF_RANGE;
+        }
+    }
+
+    memcpy(snapshot_clock_backup, clock_array, sizeof(snapshot_clock_backup));
+    memcpy(snapshot_pulse_backup, pulse_array, sizeof(snapshot_pulse_backup));
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        const struct config_snapshot_clock* record = &snapshot -> clocks[i];
+        struct clock_config* config = &clock_array[i];
+
+        config -> trigger_pin = record -> trigger_pin;
+        config -> trigger_pin_aux = record -> trigger_pin_aux;
+        config -> trigger_inputs = record -> trigger_inputs;
+        config -> trigger_logic = record -> trigger_logic;
+        config -> clock_mode = record -> clock_mode;
+        config -> trigger_source = record -> trigger_source;
+        config -> trigger_edge = record -> trigger_edge;
+        config -> trigger_level = record -> trigger_level;
+        memcpy(config -> instructions, record -> instructions, sizeof(config -> instructions));
+        memcpy(config -> trigger_config, record -> trigger_config, sizeof(config -> trigger_config));
+        memcpy(config -> trigger_mask, record -> trigger_mask, sizeof(config -> trigger_mask));
+        config -> trigger_mask_words = record -> trigger_mask_words;
+        config -> trigger_mask_bits = record -> trigger_mask_bits;
+        config -> trigger_filter = record -> trigger_filter;
+        config -> trigger_reps = record -> trigger_reps;
+        config -> trigger_latency = CLOCK_LATENCY_NONE; // delays are loaded as they were committed
+        config -> clock_divider = record -> clock_divider;
+        config -> clock_divider_frac = record -> clock_divider_frac;
+        config -> unit_offset = record -> unit_offset;
+        config -> unit_offset_trigger = record -> unit_offset_trigger;
+        config -> active = record -> active;
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        const struct config_snapshot_pulse* record = &snapshot -> pulses[i];
+        struct pulse_config* config = &pulse_array[i];
+
+        config -> clock_pin = record -> clock_pin;
+        config -> input_source = record -> input_source;
+        config -> clock_divider = record -> clock_divider;
+        config -> clock_divider_frac = record -> clock_divider_frac;
+        config -> unit_offset = record -> unit_offset;
+        memcpy(config -> instructions, record -> instructions, sizeof(config -> instructions));
+        config -> instruction_format = record -> instruction_format;
+        config -> instruction_words = record -> instruction_words;
+        config -> linear_offset = record -> linear_offset;
+        config -> linear_words = record -> linear_words;
+        config -> repeat_offset = record -> repeat_offset;
+        config -> repeat_words = record -> repeat_words;
+        config -> repeat_count = record -> repeat_count;
+        config -> input_latency = PULSE_LATENCY_NONE;
+
+        for (uint32_t j = 0; j < PULSE_SEQUENCES_MAX; j++)
+        {
+            memcpy(config -> sequences[j].instructions, record -> sequences[j].instructions, sizeof(config -> sequences[j].instructions));
+            config -> sequences[j].instruction_format = record -> sequences[j].instruction_format;
+            config -> sequences[j].instruction_words = record -> sequences[j].instruction_words;
+        }
+
+        config -> sequences_stored = record -> sequences_stored;
+        config -> sequence_mode = record -> sequence_mode;
+        config -> sequence_select = record -> sequence_select;
+        memcpy(config -> sequence_steps, record -> sequence_steps, sizeof(config -> sequence_steps));
+        config -> sequence_step_count = record -> sequence_step_count;
+        config -> scan_state = record -> scan_state;
+        config -> scan_start = record -> scan_start;
+        config -> scan_step = record -> scan_step;
+        config -> scan_points = record -> scan_points;
+        config -> scan_triggers = record -> scan_triggers;
+        config -> scan_marker = record -> scan_marker;
+        config -> active = record -> active;
+
+        // The IRQ flag belongs to the state machine of the listened clock
+        if (config -> input_source == PULSE_INPUT_CLOCK_IRQ)
+        {
+            for (uint32_t clock_id = 0; clock_id < CLOCKS_MAX; clock_id++)
+            {
+                if (INTERNAL_CLOCK_PINS[clock_id] == config -> clock_pin)
+                {
+                    config -> clock_irq = clock_array[clock_id].sm;
+                }
+            }
+        }
+    }
+
+    return CONFIG_SNAPSHOT_OK;
+}
+
+
+// Put back the staged configs from before the last load
+void config_snapshot_restore()
+{
+    memcpy(sequencer_clock_config_get(), snapshot_clock_backup, sizeof(snapshot_clock_backup));
+    memcpy(sequencer_pulse_config_get(), snapshot_pulse_backup, sizeof(snapshot_pulse_backup));
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+
+
+// Snapshot blob layout: a header followed by one record per clock and pulse
+// sequencer. Runtime handles (PIO, state machine, DMA channels, program
+// offsets) and the hardwired output pins are not part of a snapshot. Bump the
+// version whenever a record changes.
+#define CONFIG_SNAPSHOT_MAGIC 0x434E534Fu // "OSNC"
+#define CONFIG_SNAPSHOT_VERSION 4
+
+typedef enum {
+    CONFIG_SNAPSHOT_OK = 0,
+    CONFIG_SNAPSHOT_LENGTH_MISMATCH,
+    CONFIG_SNAPSHOT_HEADER_MISMATCH,
+    CONFIG_SNAPSHOT_CRC_MISMATCH,
+    CONFIG_SNAPSHOT_OUT_OF_RANGE
+} config_snapshot_result_t;
+
+struct __attribute__((packed)) config_snapshot_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t clocks;
+    uint8_t pulses;
+    uint32_t length; // bytes after the header
+    uint32_t crc;    // CRC-32 of the bytes after the header
+};
+
+struct __attribute__((packed)) config_snapshot_clock
+{
+    uint32_t trigger_pin;
+    uint32_t trigger_pin_aux;
+    uint32_t trigger_inputs;
+    uint32_t trigger_logic;
+    uint32_t clock_mode;
+    uint32_t trigger_source;
+    uint32_t trigger_edge;
+    uint32_t trigger_level;
+    uint32_t instructions[CLOCK_INSTRUCTIONS_MAX];
+    uint32_t trigger_config[CLOCK_TRIGGERS_MAX];
+    uint32_t trigger_mask[CLOCK_TRIGGER_MASK_WORDS];
+    uint32_t trigger_mask_words;
+    uint32_t trigger_mask_bits;
+    uint32_t trigger_filter;
+    uint32_t trigger_reps;
+    uint32_t clock_divider;
+    uint32_t clock_divider_frac;
+    uint64_t unit_offset;
+    uint64_t unit_offset_trigger;
+    uint32_t active;
+};
+
+struct __attribute__((packed)) config_snapshot_sequence
+{
+    uint32_t instructions[PULSE_INSTRUCTIONS_MAX];
+    uint32_t instruction_format;
+    uint32_t instruction_words;
+};
+
+struct __attribute__((packed)) config_snapshot_pulse
+{
+    uint32_t clock_pin;
+    uint32_t input_source;
+    uint32_t clock_divider;
+    uint32_t clock_divider_frac;
+    uint64_t unit_offset;
+    uint32_t instructions[PULSE_INSTRUCTIONS_MAX];
+    uint32_t instruction_format;
+    uint32_t instruction_words;
+    uint32_t linear_offset;
+    uint32_t linear_words;
+    uint32_t repeat_offset;
+    uint32_t repeat_words;
+    uint32_t repeat_count;
+    struct config_snapshot_sequence sequences[PULSE_SEQUENCES_MAX]; // zero unless stored
+    uint32_t sequences_stored;
+    uint32_t sequence_mode;
+    uint32_t sequence_select;
+    uint32_t sequence_steps[PULSE_SEQUENCE_STEPS_MAX]; // zero past the step count
+    uint32_t sequence_step_count;
+    uint32_t scan_state;
+    uint32_t scan_start;
+    uint32_t scan_step;
+    uint32_t scan_points;
+    uint32_t scan_triggers;
+    uint32_t scan_marker;
+    uint32_t active;
+};
+
+struct __attribute__((packed)) config_snapshot
+{
+    struct config_snapshot_header header;
+    struct config_snapshot_clock clocks[CLOCKS_MAX];
+    struct config_snapshot_pulse pulses[PULSES_MAX];
+};
+
+#define CONFIG_SNAPSHOT_SIZE (sizeof(struct config_snapshot))
+
+uint32_t config_snapshot_crc32(
+    const uint8_t* data,
+    size_t length,
+    uint32_t crc
+);
+
+void config_snapshot_save(
+    struct config_snapshot* snapshot
+);
+
+void config_snapshot_hash_get(
+    uint32_t hashes[CLOCKS_MAX + PULSES_MAX]
+);
+
+uint32_t config_snapshot_verify(
+    const struct config_snapshot* snapshot,
+    size_t length
+);
+
+uint32_t config_snapshot_load(
+    const struct config_snapshot* snapshot,
+    size_t length
+);
+
+void config_snapshot_restore();
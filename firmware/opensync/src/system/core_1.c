@@ -1,7 +1,10 @@
 #include "core_1.h"
 
 #include <stdint.h>
+#include <string.h>
+#include "pico/flash.h"
 #include "pico/multicore.h"
+#include "hardware/timer.h"
 #include "hardware/pio.h"
 #include "hardware/dma.h"
 
@@ -12,20 +15,39 @@
 #include "sequencer/sequencer_common.h"
 #include "sequencer/sequencer_clock.h"
 #include "sequencer/sequencer_output.h"
+#include "sequencer/sequencer_latency.h"
 #include "status/sequencer_status.h"
 #include "status/debug_status.h"
+#include "status/trigger_status.h"
+#include "status/scan_status.h"
+#include "status/arm_status.h"
 #include "serial/serial_int_output.h"
 
+// Published configs, only read by the sequencer core when arming
 static struct clock_config sequencer_clock_config[CLOCKS_MAX];
 static struct pulse_config sequencer_pulse_config[CLOCKS_MAX];
 
+// Staged configs, edited by all setters and published by a commit
+static struct clock_config staged_clock_config[CLOCKS_MAX];
+static struct pulse_config staged_pulse_config[CLOCKS_MAX];
+
+// Staged configs from before a command that edits several channels
+static struct clock_config checkpoint_clock_config[CLOCKS_MAX];
+static struct pulse_config checkpoint_pulse_config[CLOCKS_MAX];
+
 PIO pio_clocks = pio0;
 PIO pio_output = pio1;
 
 const uint32_t ARM_SEQUENCER = 1;
 
+// Microseconds from boot to the first started sequence, 0 until then
+static volatile uint32_t sequencer_boot_armed_us = 0;
+
 void core_1_init()
 {
+    // Let the serial core park this core while it writes flash
+    flash_safe_execute_core_init();
+
     sequencer_clocks_init(
         sequencer_clock_config,
         pio_clocks
@@ -36,6 +58,9 @@ void core_1_init()
         pio_output
     );
 
+    // Start staging from the initialised configs
+    sequencer_config_revert();
+
     multicore_fifo_push_blocking(0);
 
     while(true)
@@ -51,6 +76,10 @@ void core_1_init()
         
         sequencer_status_set(ARMING);
 
+        // Forget the starved clocks and scan points of the previous run
+        trigger_starved_set(0);
+        scan_point_reset();
+
         if (debug_status_local != SEQUENCER_DNDEBUG)
         {
             // Print clock and pulse configs
@@ -63,6 +92,7 @@ void core_1_init()
             fast_serial_printf("Internal Message: Aborting arming sequence due to debugging level 1\r\n");
 
             sequencer_status_set(ABORTED);
+            arm_result_set(ARM_RESULT_DEBUG, 0);
 
             // Break current arming sequence and abort
             continue;
@@ -83,11 +113,33 @@ void core_1_init()
 
         sequencer_output_sm_config_active();
 
+        // A channel that could not be configured fails the arm request
+        // instead of running without it
+        uint32_t arm_channel = 0;
+        const uint32_t arm_result = sequencer_sm_arm_check(&arm_channel);
+
+        if ((arm_result != ARM_RESULT_OK) &&
+            (arm_result != ARM_RESULT_STOPPED))
+        {
+            debug_message_print_i(
+                debug_status_local,
+                "Internal Message: Arming failed for channel %i\r\n",
+                arm_channel
+            );
+
+            sequencer_status_set(ABORT_REQUESTED);
+        }
+
         // Start the state machines if everything configured properly
-        if (sequencer_status_get() != ABORT_REQUESTED)
+        if (arm_result == ARM_RESULT_OK)
         {
             sequencer_status_set(RUNNING);
 
+            if (sequencer_boot_armed_us == 0)
+            {
+                sequencer_boot_armed_us = time_us_32();
+            }
+
             // Get masks for all active state mahcines
             uint pio_clocks_sm_mask = sequencer_clock_sm_mask_get();
             uint pio_output_sm_mask = sequencer_output_sm_mask_get();
@@ -104,6 +156,9 @@ void core_1_init()
                 pio_output_sm_mask
             );
 
+            // The state machines run, this completes the arm request
+            arm_result_set(ARM_RESULT_OK, 0);
+
 //            debug_message_print(
 //                debug_status_local,
 //                "Internal Message: Starting outputs state machines\r\n"
@@ -160,10 +215,24 @@ void core_1_init()
         {
             sequencer_status_set(ABORTED);
         }
+
+        // Failed arm requests complete once the channels are freed, so the
+        // device can be started again right away
+        if (arm_result != ARM_RESULT_OK)
+        {
+            arm_result_set(arm_result, arm_channel);
+        }
     }
 }
 
 
+// Get the microseconds from boot to the first started sequence
+uint32_t sequencer_boot_armed_us_get()
+{
+    return sequencer_boot_armed_us;
+}
+
+
 // NOTE: This is defined in core_1.c
 void debug_message_print(
     uint32_t debug_status_local,
@@ -189,20 +258,143 @@ void debug_message_print_i(
 }
 
 
-// return all three clock configs
+// return all three staged clock configs
 struct clock_config* sequencer_clock_config_get()
 {
-    return sequencer_clock_config;
+    return staged_clock_config;
 }
 
 
-// return all three pulse configs
+// return all three staged pulse configs
 struct pulse_config* sequencer_pulse_config_get()
+{
+    return staged_pulse_config;
+}
+
+
+// return all three published clock configs
+const struct clock_config* sequencer_clock_config_published_get()
+{
+    return sequencer_clock_config;
+}
+
+
+// return all three published pulse configs
+const struct pulse_config* sequencer_pulse_config_published_get()
 {
     return sequencer_pulse_config;
 }
 
 
+// Validate the staged configs and publish them to the sequencer core. Only
+// call this while the sequencer is idle, the published configs are read
+// when arming. Nothing is published if any check fails.
+uint32_t sequencer_config_commit()
+{
+    if (!sequencer_pulse_conflict_check())
+    {
+        return CONFIG_COMMIT_PULSE_CONFLICT;
+    }
+
+    if (!sequencer_pulse_irq_conflict_check())
+    {
+        return CONFIG_COMMIT_IRQ_CONFLICT;
+    }
+
+    if (!sequencer_pulse_select_conflict_check())
+    {
+        return CONFIG_COMMIT_INPUT_CONFLICT;
+    }
+
+    // Clock modes that no program supports would only fail when arming
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        uint32_t clock_type = 0;
+
+        if ((staged_clock_config[i].active == true) &&
+            !clock_sequencer_map_mode(&staged_clock_config[i], &clock_type))
+        {
+            return CONFIG_COMMIT_CLOCK_MODE;
+        }
+
+        // Mask mode runs whole mask passes
+        if ((staged_clock_config[i].active == true) &&
+            !sequencer_clock_trigger_count_validate(&staged_clock_config[i]))
+        {
+            return CONFIG_COMMIT_TRIGGER_COUNT;
+        }
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if ((staged_pulse_config[i].active == true) &&
+            (!sequencer_pulse_validate(&staged_pulse_config[i]) ||
+             !sequencer_pulse_sequence_validate(&staged_pulse_config[i]) ||
+             !sequencer_pulse_scan_validate(&staged_pulse_config[i])))
+        {
+            return CONFIG_COMMIT_PULSE_INVALID;
+        }
+    }
+
+    // The programs are loaded when arming, where running out of PIO memory
+    // can't be reported
+    if (!sequencer_clock_programs_validate(staged_clock_config) ||
+        !sequencer_output_programs_validate(staged_pulse_config))
+    {
+        return CONFIG_COMMIT_PROGRAM_SPACE;
+    }
+
+    // First states compensated for another input have to be applied again
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if ((staged_pulse_config[i].active == true) &&
+            !sequencer_latency_pulse_validate(&staged_pulse_config[i]))
+        {
+            return CONFIG_COMMIT_DATA_STALE;
+        }
+    }
+
+    // Trigger delays follow trigger mode and filter changes made after them
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        if (!sequencer_latency_trigger_update(&staged_clock_config[i]))
+        {
+            return CONFIG_COMMIT_DELAY_RANGE;
+        }
+    }
+
+    memcpy(sequencer_clock_config, staged_clock_config, sizeof(sequencer_clock_config));
+    memcpy(sequencer_pulse_config, staged_pulse_config, sizeof(sequencer_pulse_config));
+
+    return CONFIG_COMMIT_OK;
+}
+
+
+// Drop all staged changes since the last commit
+void sequencer_config_revert()
+{
+    memcpy(staged_clock_config, sequencer_clock_config, sizeof(staged_clock_config));
+    memcpy(staged_pulse_config, sequencer_pulse_config, sizeof(staged_pulse_config));
+}
+
+
+// Keep a copy of the staged configs, so a command that edits several
+// channels can drop its changes if one of them fails
+void sequencer_config_checkpoint()
+{
+    memcpy(checkpoint_clock_config, staged_clock_config, sizeof(checkpoint_clock_config));
+    memcpy(checkpoint_pulse_config, staged_pulse_config, sizeof(checkpoint_pulse_config));
+}
+
+
+// Put back the staged configs of the last checkpoint
+void sequencer_config_rollback()
+{
+    memcpy(staged_clock_config, checkpoint_clock_config, sizeof(staged_clock_config));
+    memcpy(staged_pulse_config, checkpoint_pulse_config, sizeof(staged_pulse_config));
+}
+
+
 // NOTE: Has debug messages incl.
 // Configure all active state machines based on static array of clock
 // configs.
@@ -220,6 +412,8 @@ void sequencer_clock_sm_config_active()
                 i
             );
 
+            sequencer_clock_config[i].clock_pin_output = sequencer_clock_pin_output_check(i);
+
             sequencer_clock_sm_config(
                 &sequencer_clock_config[i]
             );
@@ -236,38 +430,15 @@ void sequencer_clock_sm_config_active()
 
 // NOTE: Has debug messages incl.
 // Configure all active state machines based on static array of pulse
-// configs.
+// configs. The configs were validated when they were committed.
 void sequencer_output_sm_config_active()
 {
     uint32_t debug_status_local_func = debug_status_get();
 
-    if (!sequencer_pulse_conflict_check())
-    {
-        debug_message_print(
-            debug_status_local_func,
-            "Internal Message: Invalid pulse sequencer configuration (channel conflicts)\r\n"
-        );
-
-        sequencer_status_set(ABORT_REQUESTED);
-        return;
-    }
-
     for (uint32_t i = 0; i < CLOCKS_MAX; i++)
     {
         if (sequencer_pulse_config[i].active == true)
         {
-            if(!sequencer_pulse_validate(&sequencer_pulse_config[i]))
-            {
-                debug_message_print_i(
-                    debug_status_local_func,
-                    "Internal Message: Invalid pulse sequencer configuration for channel %i\r\n",
-                    i
-                );
-
-                sequencer_status_set(ABORT_REQUESTED);
-                return;
-            }
-
             debug_message_print_i(
                 debug_status_local_func,
                 "Internal Message: Starting to configure output state machine for channel %i\r\n",
@@ -288,6 +459,44 @@ void sequencer_output_sm_config_active()
 }
 
 
+// Check that every active channel was configured for an arm request. Returns
+// the arm result and the first channel that failed.
+uint32_t sequencer_sm_arm_check(
+    uint32_t* channel
+) {
+    *channel = 0;
+
+    if (sequencer_status_get() == ABORT_REQUESTED)
+    {
+        return ARM_RESULT_STOPPED;
+    }
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        // Commit rejects clock modes without a program and programs that
+        // don't fit the PIO memory, so this only catches a failed setup
+        if ((sequencer_clock_config[i].active == true) &&
+            (sequencer_clock_config[i].configured == false))
+        {
+            *channel = i;
+            return ARM_RESULT_CLOCK_MODE;
+        }
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if ((sequencer_pulse_config[i].active == true) &&
+            (sequencer_pulse_config[i].configured == false))
+        {
+            *channel = i;
+            return ARM_RESULT_PULSE;
+        }
+    }
+
+    return ARM_RESULT_OK;
+}
+
+
 // Get bit mask of all active state machiens for clock programs
 uint sequencer_clock_sm_mask_get()
 {
@@ -328,12 +537,22 @@ uint sequencer_output_sm_mask_get()
 // This is accomplished by stalling the program on the dma channel for
 // the clock programs when software  triggers are used, or pulse
 // configs when using external trigger.
+// If a trigger timeout is set, every externally triggered clock has to
+// see a trigger within the timeout (the deadline is re-armed on every
+// accepted trigger, and on every trigger edge in mask mode, including
+// rejected ones), otherwise the run is aborted and the starved clocks are
+// recorded.
 // TODO: Validate that the stall of external triggers actually works
 // as indented.
 void sequencer_clock_sm_stall()
 {
     uint32_t debug_status_local_func = debug_status_get();
 
+    const uint64_t trigger_timeout = trigger_timeout_get();
+    uint32_t trigger_remaining[CLOCKS_MAX] = {0};
+    uint64_t trigger_deadline[CLOCKS_MAX] = {0};
+    uint32_t trigger_starved = 0;
+
     for (uint32_t i = 0; i < CLOCKS_MAX; ++i)
     {
         // If a clock is not configured, then do not stall
@@ -347,20 +566,172 @@ void sequencer_clock_sm_stall()
             "Internal Message: Entering stall for clock id: %i\r\n",
             i
         );
-        
-        // Check if a dma channel is busy or if transmit fifo is empty.
-        // If dma channel is not busy and transmit fifo is empty, we can
-        // assume that the clock program is finished and undo the stall.
-        while(
-            (dma_channel_is_busy(sequencer_clock_config[i].dma_chan) ||
+
+        trigger_remaining[i] = sequencer_clock_trigger_remaining(
+            &sequencer_clock_config[i]
+        );
+
+        trigger_deadline[i] = time_us_64() + trigger_timeout;
+    }
+
+    bool clocks_busy = true;
+
+    while (clocks_busy &&
+        (sequencer_status_get() != ABORT_REQUESTED)
+    ) {
+        // Pulse channels listening to external triggers directly have no
+        // clock channel to stall on, so stall on their own dma channel.
+        clocks_busy = sequencer_output_sm_external_busy();
+
+        for (uint32_t i = 0; i < CLOCKS_MAX; ++i)
+        {
+            if (sequencer_clock_config[i].configured != true)
+            {
+                continue;
+            }
+
+            // Check if a dma channel is busy or if transmit fifo is empty.
+            // If dma channel is not busy and transmit fifo is empty, we can
+            // assume that the clock program is finished.
+            if (!dma_channel_is_busy(sequencer_clock_config[i].dma_chan) &&
+                pio_sm_is_tx_fifo_empty(
+                    sequencer_clock_config[i].pio,
+                    sequencer_clock_config[i].sm
+                )
+            ) {
+                continue;
+            }
+
+            clocks_busy = true;
+
+            if ((trigger_timeout == TRIGGER_TIMEOUT_DISABLED) ||
+                !sequencer_clock_externally_triggered(&sequencer_clock_config[i]))
+            {
+                continue;
+            }
+
+            const uint32_t remaining = sequencer_clock_trigger_remaining(
+                &sequencer_clock_config[i]
+            );
+
+            const bool trigger_edge = sequencer_clock_trigger_edge_take(
+                &sequencer_clock_config[i]
+            );
+
+            // A trigger was accepted (or seen by a mask program), so re-arm
+            // the deadline
+            if ((remaining != trigger_remaining[i]) || trigger_edge)
+            {
+                trigger_remaining[i] = remaining;
+                trigger_deadline[i] = time_us_64() + trigger_timeout;
+            }
+
+            else if (time_us_64() > trigger_deadline[i])
+            {
+                trigger_starved |= 1u << i;
+            }
+        }
+
+        if (trigger_starved != 0)
+        {
+            for (uint32_t i = 0; i < CLOCKS_MAX; ++i)
+            {
+                if (trigger_starved & (1u << i))
+                {
+                    debug_message_print_i(
+                        debug_status_local_func,
+                        "Internal Message: Trigger timeout for clock id: %i\r\n",
+                        i
+                    );
+                }
+            }
+
+            trigger_starved_set(trigger_starved);
+            sequencer_status_set(ABORT_REQUESTED);
+            break;
+        }
+
+        sequencer_output_sequence_poll();
+        sequencer_output_scan_poll();
+
+        // Check status every 100 microseconds / 10 kHz
+        sleep_us(100);
+    }
+}
+
+
+// Check if any pulse channel listening to an external trigger is still busy
+bool sequencer_output_sm_external_busy()
+{
+    for (uint32_t i = 0; i < PULSES_MAX; ++i)
+    {
+        if ((sequencer_pulse_config[i].configured != true) ||
+            (sequencer_pulse_config[i].input_source != PULSE_INPUT_EXTERNAL))
+        {
+            continue;
+        }
+
+        if (dma_channel_is_busy(sequencer_pulse_config[i].dma_chan) ||
             !pio_sm_is_tx_fifo_empty(
-                sequencer_clock_config[i].pio,
-                sequencer_clock_config[i].sm
-            )) &&
-            (sequencer_status_get() != ABORT_REQUESTED)
+                sequencer_pulse_config[i].pio,
+                sequencer_pulse_config[i].sm
+            )
         ) {
-            // Check status every 100 microseconds / 10 kHz
-            sleep_us(100);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+// Hand the entry selected by the external trigger inputs to every running
+// sequence table in external mode. Codes of entries that are not stored keep
+// the current entry.
+void sequencer_output_sequence_poll()
+{
+    const uint32_t entry = sequencer_output_sequence_external_get();
+
+    for (uint32_t i = 0; i < PULSES_MAX; ++i)
+    {
+        struct pulse_config* config = &sequencer_pulse_config[i];
+
+        if ((config -> configured != true) ||
+            (config -> sequence_mode != PULSE_SEQUENCE_EXTERNAL) ||
+            (config -> sequence_select == entry) ||
+            !(config -> sequences_stored & (1u << entry)))
+        {
+            continue;
+        }
+
+        config -> sequence_select = entry;
+
+        sequencer_output_sequence_select(
+            config,
+            entry
+        );
+    }
+}
+
+
+// Record the point every running scan is at, a change latches a point event
+void sequencer_output_scan_poll()
+{
+    for (uint32_t i = 0; i < PULSES_MAX; ++i)
+    {
+        struct pulse_config* config = &sequencer_pulse_config[i];
+
+        if ((config -> configured != true) ||
+            (config -> scan_points == 0))
+        {
+            continue;
+        }
+
+        const uint32_t point = sequencer_output_scan_point_get(config);
+
+        if (point != scan_point_get(i))
+        {
+            scan_point_set(i, point);
         }
     }
 }
@@ -401,74 +772,372 @@ void sequencer_sm_active_free()
 // and excess jitter. To prevent this, no pulse channels can cross over at all.
 bool sequencer_pulse_conflict_check()
 {
-    #define NUM_BITS 32
-    const uint32_t MAX_BITS = 1;
+    uint32_t outputs_used = 0;
 
-    uint32_t channel_state[CLOCKS_MAX][NUM_BITS] = {0};
-
-    // Accumulate all the bit information into a 2D array
     for (uint32_t chan_id = 0; chan_id < CLOCKS_MAX; chan_id++)
     {
-        for (uint32_t i = 0; i < PULSE_INSTRUCTIONS_MAX; i++)
-        {
-            uint32_t state = sequencer_pulse_config[chan_id].instructions[i];
-
-            // The binary array is backwards, but this doesn't matter since we are only looking for nums > 1
-            uint32_t j = 0;
-            while (state > 0)
-            {
-                channel_state[chan_id][j] = state % 2;
-                state /= 2;
+        // Only output states count, the delay words depend on the format
+        const uint32_t outputs = sequencer_output_state_mask_get(
+            &staged_pulse_config[chan_id]
+        );
 
-                j++;
-            }
+        if (outputs_used & outputs)
+        {
+            return 0;
         }
+
+        outputs_used |= outputs;
     }
 
-    // Check the array sums for values > 1 which indicates that there is a channel conflict
-    for (uint32_t i = 0; i < NUM_BITS; i++)
-    {
-        uint32_t channel_sum = 0;
+    return 1;
+}
 
-        for (uint32_t chan_id = 0; chan_id < CLOCKS_MAX; chan_id++)
+
+// A waiting IRQ pulse channel clears the clock flag it consumed, so every
+// clock channel can only be listened to by a single IRQ pulse channel.
+bool sequencer_pulse_irq_conflict_check()
+{
+    uint32_t clock_irq_mask = 0;
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if ((staged_pulse_config[i].active != true) ||
+            (staged_pulse_config[i].input_source != PULSE_INPUT_CLOCK_IRQ))
         {
-            channel_sum += channel_state[chan_id][i];
+            continue;
         }
 
-        if (channel_sum > MAX_BITS)
+        if (clock_irq_mask & (1u << staged_pulse_config[i].clock_irq))
         {
             return 0;
         }
+
+        clock_irq_mask |= 1u << staged_pulse_config[i].clock_irq;
     }
 
     return 1;
 }
 
 
-// Check that pulse instructions are valid
-bool sequencer_pulse_validate(
-    struct pulse_config* config
-) {
-    const uint32_t FLAG_OFFSET = 2;
-     const uint32_t TERM_FLAG = 0;
+// The external sequence select inputs pick the entry of every sequence
+// boundary, so they can't also be trigger inputs of a clock channel or the
+// input of an external pulse channel.
+bool sequencer_pulse_select_conflict_check()
+{
+    uint32_t select_pins = 0;
+    uint32_t input_pins = 0;
 
-    // Check to see if all delay instructions are non-zero
-    for (uint32_t i = 1; i < PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET; i = i + 2)
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
     {
-        if (config -> instructions[i] == TERM_FLAG)
+        if ((staged_pulse_config[i].active != true) ||
+            (staged_pulse_config[i].sequence_mode != PULSE_SEQUENCE_EXTERNAL))
         {
-            return 0;
+            continue;
+        }
+
+        for (uint32_t j = 0; j < PULSE_SEQUENCE_SELECT_BITS; j++)
+        {
+            select_pins |= 1u << EXTERNAL_TRIGGER_PINS[j];
         }
     }
 
-    // Validate terminator flags
-    if ((config -> instructions[PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET] != TERM_FLAG) ||
-        (config -> instructions[PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET + 1] != TERM_FLAG))
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
     {
-        return 0;
+        if (staged_clock_config[i].active == true)
+        {
+            input_pins |= sequencer_clock_trigger_pins_get(&staged_clock_config[i]);
+        }
     }
 
-    return 1;
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if ((staged_pulse_config[i].active == true) &&
+            (staged_pulse_config[i].input_source == PULSE_INPUT_EXTERNAL))
+        {
+            input_pins |= 1u << staged_pulse_config[i].clock_pin;
+        }
+    }
+
+    return (select_pins & input_pins) == 0;
+}
+
+
+// Check if the clock channel pin has to be driven. The pin is only released
+// if at least one active pulse channel listens through the IRQ flag and none
+// through the pin itself.
+bool sequencer_clock_pin_output_check(
+    uint32_t clock_id
+) {
+    bool irq_listener = false;
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        if (sequencer_pulse_config[i].active != true)
+        {
+            continue;
+        }
+
+        if ((sequencer_pulse_config[i].input_source == PULSE_INPUT_CLOCK) &&
+            (sequencer_pulse_config[i].clock_pin == sequencer_clock_config[clock_id].clock_pin))
+        {
+            return 1;
+        }
+
+        if ((sequencer_pulse_config[i].input_source == PULSE_INPUT_CLOCK_IRQ) &&
+            (sequencer_pulse_config[i].clock_irq == clock_id))
+        {
+            irq_listener = true;
+        }
+    }
+
+    return !irq_listener;
+}
+
+
+// Check that the instructions of a sequence with a repeat block are valid.
+// The linear segment holds the pads, a single terminator and at least one
+// prefix state, the repeat block may not hold any terminator.
+bool sequencer_pulse_repeat_validate(
+    struct pulse_config* config
+) {
+    const bool packed = (config -> instruction_format == PULSE_FORMAT_PACKED);
+    const uint32_t STATE_WORDS = packed ? 1 : 2;
+    const uint32_t TERM_FLAG = 0;
+
+    if ((config -> instruction_format == PULSE_FORMAT_EXTENDED) ||
+        (config -> instruction_format == PULSE_FORMAT_FAST))
+    {
+        return 0;
+    }
+
+    const uint32_t offsets[] = {config -> linear_offset, config -> repeat_offset};
+    const uint32_t words[] = {config -> linear_words, config -> repeat_words};
+    const uint32_t terms_expected[] = {1, 0};
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        uint32_t terms = 0;
+
+        for (uint32_t j = offsets[i]; j < offsets[i] + words[i]; j += STATE_WORDS)
+        {
+            const uint32_t delay = packed
+                ? config -> instructions[j] >> PULSE_PACKED_STATE_BITS
+                : config -> instructions[j + 1];
+
+            if (delay != TERM_FLAG)
+            {
+                continue;
+            }
+
+            // The terminator can not be the last state of the linear segment
+            if (j == (offsets[i] + words[i] - STATE_WORDS))
+            {
+                return 0;
+            }
+
+            terms++;
+        }
+
+        if (terms != terms_expected[i])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+// Check that the instructions of a fast sequence are valid. The pulser
+// executes the upper bits of every word, so only the two terminating wait
+// instructions and nops with a delay are allowed.
+bool sequencer_pulse_fast_validate(
+    struct pulse_config* config
+) {
+    const uint32_t NOP_MASK = ~(pio_encode_delay(PULSE_FAST_DELAY_MAX) << PULSE_PACKED_STATE_BITS);
+    const uint32_t NOP_WORD = pio_encode_nop() << PULSE_PACKED_STATE_BITS;
+    const uint32_t OUTPUT_MASK = (1u << PULSE_PACKED_STATE_BITS) - 1;
+
+    for (uint32_t i = 0; i < PULSE_FAST_TERM_WORDS; i++)
+    {
+        if (config -> instructions[i] != sequencer_output_fast_term_get(i))
+        {
+            return 0;
+        }
+    }
+
+    for (uint32_t i = PULSE_FAST_TERM_WORDS; i < config -> instruction_words; i++)
+    {
+        if (((config -> instructions[i] & ~OUTPUT_MASK) & NOP_MASK) != NOP_WORD)
+        {
+            return 0;
+        }
+    }
+
+    return config -> instruction_words > PULSE_FAST_TERM_WORDS;
+}
+
+
+// Check that pulse instructions are valid
+bool sequencer_pulse_validate(
+    struct pulse_config* config
+) {
+    const uint32_t FLAG_OFFSET = 2;
+     const uint32_t TERM_FLAG = 0;
+
+    // Extended delays use three words per state (output, remainder, blocks)
+    const uint32_t STATE_WORDS = (config -> instruction_format == PULSE_FORMAT_EXTENDED) ? PULSE_EXTENDED_WORDS : 2;
+
+    // The extended and packed pulsers only listen to clock and trigger pins
+    if ((config -> instruction_format != PULSE_FORMAT_STANDARD) &&
+        (config -> input_source == PULSE_INPUT_CLOCK_IRQ))
+    {
+        return 0;
+    }
+
+    // Repeat blocks have their own layout
+    if (config -> repeat_count > 0)
+    {
+        return sequencer_pulse_repeat_validate(config);
+    }
+
+    if (config -> instruction_format == PULSE_FORMAT_FAST)
+    {
+        return sequencer_pulse_fast_validate(config);
+    }
+
+    // Packed states are single words with the delay in the upper bits and a
+    // single terminating word at the end of the used ring
+    if (config -> instruction_format == PULSE_FORMAT_PACKED)
+    {
+        for (uint32_t i = 0; i < config -> instruction_words - 1; i++)
+        {
+            if ((config -> instructions[i] >> PULSE_PACKED_STATE_BITS) == TERM_FLAG)
+            {
+                return 0;
+            }
+        }
+
+        return config -> instructions[config -> instruction_words - 1] == TERM_FLAG;
+    }
+
+    // Check to see if all delay instructions are non-zero
+    for (uint32_t i = 1; i < PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET; i = i + STATE_WORDS)
+    {
+        if (config -> instructions[i] == TERM_FLAG)
+        {
+            return 0;
+        }
+    }
+
+    // Validate terminator flags
+    if ((config -> instructions[PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET] != TERM_FLAG) ||
+        (config -> instructions[PULSE_INSTRUCTIONS_MAX - FLAG_OFFSET + 1] != TERM_FLAG))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+// Check that the sequence table can stand in for the loaded instructions.
+// Every entry that can be streamed has to be stored with the format and
+// length the state machine and DMA are configured for.
+bool sequencer_pulse_sequence_validate(
+    struct pulse_config* config
+) {
+    if (config -> sequence_mode == PULSE_SEQUENCE_OFF)
+    {
+        return 1;
+    }
+
+    // The repeat block already chains its own DMA channels
+    if (config -> repeat_count > 0)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < PULSE_SEQUENCES_MAX; i++)
+    {
+        if (!(config -> sequences_stored & (1u << i)))
+        {
+            continue;
+        }
+
+        if ((config -> sequences[i].instruction_format != config -> instruction_format) ||
+            (config -> sequences[i].instruction_words != config -> instruction_words))
+        {
+            return 0;
+        }
+    }
+
+    if (config -> sequence_mode != PULSE_SEQUENCE_LIST)
+    {
+        return (config -> sequences_stored & (1u << config -> sequence_select)) != 0;
+    }
+
+    for (uint32_t i = 0; i < config -> sequence_step_count; i++)
+    {
+        if (!(config -> sequences_stored & (1u << config -> sequence_steps[i])))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+// Check that every point of a scan can be encoded. Scans sweep the delay of a
+// single standard or packed state and stream their own instruction variants,
+// so they can not be combined with a repeat block or the sequence table.
+bool sequencer_pulse_scan_validate(
+    struct pulse_config* config
+) {
+    const uint32_t DMA_TRANSFERS_MAX = (1u << 28) - 1;
+
+    if (config -> scan_points == 0)
+    {
+        return 1;
+    }
+
+    if ((config -> repeat_count > 0) ||
+        (config -> sequence_mode != PULSE_SEQUENCE_OFF))
+    {
+        return 0;
+    }
+
+    const bool packed = (config -> instruction_format == PULSE_FORMAT_PACKED);
+
+    if (!packed && (config -> instruction_format != PULSE_FORMAT_STANDARD))
+    {
+        return 0;
+    }
+
+    // The terminator is not a state
+    const uint32_t states = packed ? config -> instruction_words - 1 : PULSE_STANDARD_STATES_MAX;
+
+    if (config -> scan_state >= states)
+    {
+        return 0;
+    }
+
+    if ((config -> scan_marker & ~OUT_MASK) ||
+        (config -> scan_triggers == 0) ||
+        (((uint64_t) config -> instruction_words * config -> scan_triggers) > DMA_TRANSFERS_MAX))
+    {
+        return 0;
+    }
+
+    // A zero delay word is the terminator
+    const uint64_t cycles_min = PULSE_INSTRUCTION_OFFSET + 1;
+    const uint64_t cycles_max = packed
+        ? (uint64_t) PULSE_PACKED_DELAY_MAX + PULSE_INSTRUCTION_OFFSET
+        : UINT32_MAX;
+    const uint64_t cycles_last = config -> scan_start + (uint64_t) (config -> scan_points - 1) * config -> scan_step;
+
+    return (config -> scan_start >= cycles_min) && (cycles_last <= cycles_max);
 }
 
 
@@ -549,7 +1218,8 @@ bool validate_trigger_mode(
 ) {
     if (trigger_mode == CLOCK_TRIG_SOURCE_IMMEDIATE ||
         trigger_mode == CLOCK_TRIG_SOURCE_EDGE ||
-        trigger_mode == CLOCK_TRIG_SOURCE_GATE
+        trigger_mode == CLOCK_TRIG_SOURCE_GATE ||
+        trigger_mode == CLOCK_TRIG_SOURCE_MASK
     ) {
         return 1;
     }
@@ -586,6 +1256,22 @@ bool validate_trigger_level(
 }
 
 
+// Make sure trigger logic is supported
+bool validate_trigger_logic(
+    uint32_t trigger_logic
+) {
+    if (trigger_logic == CLOCK_TRIG_LOGIC_SINGLE ||
+        trigger_logic == CLOCK_TRIG_LOGIC_OR ||
+        trigger_logic == CLOCK_TRIG_LOGIC_AND ||
+        trigger_logic == CLOCK_TRIG_LOGIC_ARM
+    ) {
+        return 1;
+    }
+
+    return 0;
+}
+
+
 // Set the clock type of a clock channel
 bool sequencer_clock_mode_set(
     uint32_t clock_id,
@@ -604,7 +1290,7 @@ bool sequencer_clock_mode_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].clock_mode = requested_mode;
+    staged_clock_config[clock_id].clock_mode = requested_mode;
 
     return 1;
 }
@@ -628,7 +1314,7 @@ bool sequencer_trigger_mode_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].trigger_source = requested_mode;
+    staged_clock_config[clock_id].trigger_source = requested_mode;
 
     return 1;
 }
@@ -652,7 +1338,7 @@ bool sequencer_trigger_edge_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].trigger_edge = requested_edge;
+    staged_clock_config[clock_id].trigger_edge = requested_edge;
 
     return 1;
 }
@@ -676,7 +1362,31 @@ bool sequencer_trigger_level_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].trigger_level = requested_level;
+    staged_clock_config[clock_id].trigger_level = requested_level;
+
+    return 1;
+}
+
+
+// Set the logic used to combine the trigger inputs of a clock channel
+bool sequencer_trigger_logic_set(
+    uint32_t clock_id,
+    uint32_t requested_logic
+) {
+
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    // Check trigger logic is valid and supported
+    if (!validate_trigger_logic(requested_logic))
+    {
+        return 0;
+    }
+
+    staged_clock_config[clock_id].trigger_logic = requested_logic;
 
     return 1;
 }
@@ -700,7 +1410,43 @@ bool clock_divider_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].clock_divider = (uint) clock_divider_copy;
+    staged_clock_config[clock_id].clock_divider = (uint) clock_divider_copy;
+    staged_clock_config[clock_id].clock_divider_frac = 0;
+
+    return 1;
+}
+
+
+// Validate a 16.8 fixed point clock divider
+bool clock_divider_fixed_validate(
+    uint32_t clock_divider_fixed
+) {
+    const uint32_t DIVIDER_MIN = 1u << CLOCK_DIVIDER_FRAC_BITS;
+    const uint32_t DIVIDER_MAX = CLOCK_DIVIDER_MAX << CLOCK_DIVIDER_FRAC_BITS;
+
+    return (clock_divider_fixed >= DIVIDER_MIN) &&
+        (clock_divider_fixed <= DIVIDER_MAX);
+}
+
+
+// Set the clock divider of a clock channel as 16.8 fixed point value
+bool clock_divider_fixed_set(
+    uint32_t clock_id,
+    uint32_t clock_divider_fixed
+) {
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    if (!clock_divider_fixed_validate(clock_divider_fixed))
+    {
+        return 0;
+    }
+
+    staged_clock_config[clock_id].clock_divider = clock_divider_fixed >> CLOCK_DIVIDER_FRAC_BITS;
+    staged_clock_config[clock_id].clock_divider_frac = clock_divider_fixed & ((1u << CLOCK_DIVIDER_FRAC_BITS) - 1);
 
     return 1;
 }
@@ -724,7 +1470,31 @@ bool pulse_divider_set(
         return 0;
     }
 
-    sequencer_pulse_config[pulse_id].clock_divider = (uint) clock_divider_copy;
+    staged_pulse_config[pulse_id].clock_divider = (uint) clock_divider_copy;
+    staged_pulse_config[pulse_id].clock_divider_frac = 0;
+
+    return 1;
+}
+
+
+// Set the clock divider of a pulse channel as 16.8 fixed point value
+bool pulse_divider_fixed_set(
+    uint32_t pulse_id,
+    uint32_t clock_divider_fixed
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (!clock_divider_fixed_validate(clock_divider_fixed))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].clock_divider = clock_divider_fixed >> CLOCK_DIVIDER_FRAC_BITS;
+    staged_pulse_config[pulse_id].clock_divider_frac = clock_divider_fixed & ((1u << CLOCK_DIVIDER_FRAC_BITS) - 1);
 
     return 1;
 }
@@ -741,16 +1511,19 @@ bool clock_sequencer_state_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].active = clock_state;
+    staged_clock_config[clock_id].active = clock_state;
 
     return 1;
 }
 
 
-// Set the external trigger pin based on pin ID for a clock channel
-bool trigger_pin_set(
+// Set the external trigger pins based on pin IDs for a clock channel.
+// The first input is input A (arms the clock for ARM logic) and the second
+// input is input B (fires the clock for ARM logic).
+bool trigger_pins_set(
     uint32_t clock_id,
-    uint32_t trigger_pin_id
+    uint32_t trigger_pin_ids[CLOCK_TRIGGER_INPUTS_MAX],
+    uint32_t trigger_inputs
 ) {
 
     // Validate clock ID
@@ -759,19 +1532,45 @@ bool trigger_pin_set(
         return 0;
     }
 
-    // Validate trigger ID
-    if(!trigger_id_validate(trigger_pin_id))
+    // Validate input count
+    if ((trigger_inputs == 0) ||
+        (trigger_inputs > CLOCK_TRIGGER_INPUTS_MAX))
+    {
+        return 0;
+    }
+
+    // Validate trigger IDs
+    for (uint32_t i = 0; i < trigger_inputs; i++)
+    {
+        if(!trigger_id_validate(trigger_pin_ids[i]))
+        {
+            return 0;
+        }
+    }
+
+    // The same input can not be combined with itself
+    if ((trigger_inputs == CLOCK_TRIGGER_INPUTS_MAX) &&
+        (trigger_pin_ids[0] == trigger_pin_ids[1]))
     {
         return 0;
     }
 
-    sequencer_clock_config[clock_id].trigger_pin = EXTERNAL_TRIGGER_PINS[trigger_pin_id];
+    staged_clock_config[clock_id].trigger_pin = EXTERNAL_TRIGGER_PINS[trigger_pin_ids[0]];
+
+    if (trigger_inputs == CLOCK_TRIGGER_INPUTS_MAX)
+    {
+        staged_clock_config[clock_id].trigger_pin_aux = EXTERNAL_TRIGGER_PINS[trigger_pin_ids[1]];
+    }
+
+    staged_clock_config[clock_id].trigger_inputs = trigger_inputs;
 
     return 1;
 }
 
 
-// Sets the amount of accepted external triggers for a clock channel
+// Sets the amount of accepted external triggers for a clock channel. In mask
+// mode it has to be a whole number of mask passes, which is checked at
+// commit since the mask may be set afterwards.
 bool trigger_count_set(
     uint32_t clock_id,
     uint32_t trigger_reps
@@ -789,7 +1588,7 @@ bool trigger_count_set(
         return 0;
     }
 
-    sequencer_clock_config[clock_id].trigger_reps = trigger_reps;
+    staged_clock_config[clock_id].trigger_reps = trigger_reps;
 
     return 1;
 }
@@ -814,7 +1613,7 @@ bool trigger_skip_set(
     }
 
     sequencer_clock_insert_instructions_triggered_skip(
-        &sequencer_clock_config[clock_id],
+        &staged_clock_config[clock_id],
         trigger_skips
     );
 
@@ -822,10 +1621,38 @@ bool trigger_skip_set(
 }
 
 
-// Set trigger delay between clock signal and pulse sequence fire signal
+// Set the glitch filter length (trigger level hold time in cycles)
+bool trigger_filter_set(
+    uint32_t clock_id,
+    uint32_t trigger_filter
+) {
+
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    // Validate filter length
+    if (trigger_filter > TRIGGER_FILTER_MAX)
+    {
+        return 0;
+    }
+
+    sequencer_clock_insert_instructions_triggered_filter(
+        &staged_clock_config[clock_id],
+        trigger_filter
+    );
+
+    return 1;
+}
+
+
+// Set trigger delay between clock signal and pulse sequence fire signal
 bool trigger_delay_set(
     uint32_t clock_id,
-    uint32_t trigger_delay
+    uint32_t trigger_delay,
+    uint32_t trigger_latency
 ) {
 
     // Validate clock ID
@@ -835,10 +1662,52 @@ bool trigger_delay_set(
     }
 
     sequencer_clock_insert_instructions_triggered_delay(
-        &sequencer_clock_config[clock_id],
+        &staged_clock_config[clock_id],
         trigger_delay
     );
 
+    // Kept to compensate the delay again at commit
+    staged_clock_config[clock_id].trigger_latency = trigger_latency;
+
+    return 1;
+}
+
+
+// Set trigger accept mask (bit i = trigger i) of a clock channel
+bool trigger_mask_set(
+    uint32_t clock_id,
+    uint32_t trigger_mask[CLOCK_TRIGGER_MASK_WORDS],
+    uint32_t trigger_mask_length
+) {
+    uint32_t mask_words = 0;
+
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    // Validate mask length
+    if ((trigger_mask_length == 0) ||
+        (trigger_mask_length > CLOCK_TRIGGER_MASK_BITS_MAX))
+    {
+        return 0;
+    }
+
+    // Make sure the mask can be split into equally sized mask words
+    if (!sequencer_clock_trigger_mask_words_get(
+        trigger_mask_length,
+        &mask_words
+    )) {
+        return 0;
+    }
+
+    sequencer_clock_insert_instructions_triggered_mask(
+        &staged_clock_config[clock_id],
+        trigger_mask,
+        trigger_mask_length
+    );
+
     return 1;
 }
 
@@ -856,7 +1725,7 @@ bool clock_instructions_load(
     }
 
     sequencer_clock_insert_instructions_internal(
-        &sequencer_clock_config[clock_id],
+        &staged_clock_config[clock_id],
         instructions
     );
 
@@ -864,10 +1733,42 @@ bool clock_instructions_load(
 }
 
 
+// Overwrite a single instruction word of a clock channel. Cycle words are
+// either 0 or at least the minimum loop length of the clock programs.
+bool clock_instruction_patch(
+    uint32_t clock_id,
+    uint32_t index,
+    uint32_t value
+) {
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    if (index >= CLOCK_INSTRUCTIONS_MAX)
+    {
+        return 0;
+    }
+
+    // Instructions are (repetitions, cycles) pairs
+    if ((index % 2 == 1) &&
+        (value != 0) &&
+        (value < CLOCK_INSTRUCTION_MIN))
+    {
+        return 0;
+    }
+
+    staged_clock_config[clock_id].instructions[index] = value;
+
+    return 1;
+}
+
+
 // Set unit offset (scaling factor) for a clock channel
 bool clock_unit_offset_set(
     uint32_t clock_id,
-    double units_offset
+    uint64_t units_offset
 ) {
     // Validate clock ID
     if(!clock_id_validate(clock_id))
@@ -876,12 +1777,12 @@ bool clock_unit_offset_set(
     }
 
     // Make sure the offset is never 0
-    if(units_offset < SEQUENCER_DOUBLE_EPS)
+    if(units_offset == 0)
     {
         return 0;
     }
 
-    sequencer_clock_config[clock_id].unit_offset = units_offset;
+    staged_clock_config[clock_id].unit_offset = units_offset;
 
     return 1;
 }
@@ -890,7 +1791,7 @@ bool clock_unit_offset_set(
 // Set trigger unit offset (scaling factor) for a clock channel
 bool clock_trigger_unit_offset_set(
     uint32_t clock_id,
-    double units_offset
+    uint64_t units_offset
 ) {
     // Validate clock ID
     if(!clock_id_validate(clock_id))
@@ -899,12 +1800,12 @@ bool clock_trigger_unit_offset_set(
     }
 
     // Make sure the offset is never 0
-    if(units_offset < SEQUENCER_DOUBLE_EPS)
+    if(units_offset == 0)
     {
         return 0;
     }
 
-    sequencer_clock_config[clock_id].unit_offset_trigger = units_offset;
+    staged_clock_config[clock_id].unit_offset_trigger = units_offset;
 
     return 1;
 }
@@ -921,7 +1822,7 @@ bool clock_sequencer_state_reset(
     }
 
     sequencer_clock_config_reset(
-        &sequencer_clock_config[clock_id]
+        &staged_clock_config[clock_id]
     );
 
     return 1;
@@ -939,7 +1840,7 @@ bool pulse_sequencer_state_set(
         return 0;
     }
 
-    sequencer_pulse_config[pulse_id].active = pulse_state;
+    staged_pulse_config[pulse_id].active = pulse_state;
 
     return 1;
 }
@@ -963,7 +1864,61 @@ bool pulse_pin_clock_set(
         return 0;
     }
 
-    sequencer_pulse_config[pulse_id].clock_pin = INTERNAL_CLOCK_PINS[clock_id];
+    staged_pulse_config[pulse_id].clock_pin = INTERNAL_CLOCK_PINS[clock_id];
+    staged_pulse_config[pulse_id].input_source = PULSE_INPUT_CLOCK;
+
+    return 1;
+}
+
+
+// Set an external trigger pin as the input of a pulse channel. The pulse
+// sequence then fires directly on the trigger edge without a clock channel.
+bool pulse_pin_trigger_set(
+    uint32_t pulse_id,
+    uint32_t trigger_id
+) {
+
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    // Validate trigger ID
+    if(!trigger_id_validate(trigger_id))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].clock_pin = EXTERNAL_TRIGGER_PINS[trigger_id];
+    staged_pulse_config[pulse_id].input_source = PULSE_INPUT_EXTERNAL;
+
+    return 1;
+}
+
+
+// Let a pulse channel listen to a clock channel through its PIO IRQ flag
+// instead of the internal clock pin.
+bool pulse_irq_clock_set(
+    uint32_t pulse_id,
+    uint32_t clock_id
+) {
+
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    // Validate clock ID
+    if(!clock_id_validate(clock_id))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].clock_pin = INTERNAL_CLOCK_PINS[clock_id];
+    staged_pulse_config[pulse_id].clock_irq = staged_clock_config[clock_id].sm;
+    staged_pulse_config[pulse_id].input_source = PULSE_INPUT_CLOCK_IRQ;
 
     return 1;
 }
@@ -972,10 +1927,8 @@ bool pulse_pin_clock_set(
 // Set unit offset (scaling factor) for pulse channel delay instructions
 bool pulse_unit_offset_set(
     uint32_t pulse_id,
-    double units_offset
+    uint64_t units_offset
 ) {
-    const double eps = 0.000001;
-
     // Validate pulse ID
     if(!pulse_id_validate(pulse_id))
     {
@@ -983,12 +1936,12 @@ bool pulse_unit_offset_set(
     }
 
     // Make sure the offset is never 0
-    if(units_offset < eps)
+    if(units_offset == 0)
     {
         return 0;
     }
 
-    sequencer_pulse_config[pulse_id].unit_offset = units_offset;
+    staged_pulse_config[pulse_id].unit_offset = units_offset;
 
     return 1;
 }
@@ -997,7 +1950,9 @@ bool pulse_unit_offset_set(
 // Load state and delay instructions to pulse channel
 bool pulse_instructions_load(
     uint32_t pulse_id,
-    uint32_t instructions[PULSE_INSTRUCTIONS_MAX]
+    uint32_t instructions[PULSE_INSTRUCTIONS_MAX],
+    uint32_t instruction_format,
+    uint32_t instruction_words
 ) {
 
     // Validate pulse ID
@@ -1006,11 +1961,115 @@ bool pulse_instructions_load(
         return 0;
     }
 
+    // The DMA ring needs a power of two amount of words
+    if ((instruction_words < 2) ||
+        (instruction_words > PULSE_INSTRUCTIONS_MAX) ||
+        (instruction_words & (instruction_words - 1)))
+    {
+        return 0;
+    }
+
     sequencer_output_insert_instructions(
-        &sequencer_pulse_config[pulse_id],
+        &staged_pulse_config[pulse_id],
         instructions
     );
 
+    staged_pulse_config[pulse_id].instruction_format = instruction_format;
+    staged_pulse_config[pulse_id].instruction_words = instruction_words;
+    staged_pulse_config[pulse_id].repeat_count = 0;
+
+    return 1;
+}
+
+
+// Overwrite a single instruction word of a pulse channel, the program is
+// validated when the configuration is committed
+bool pulse_instruction_patch(
+    uint32_t pulse_id,
+    uint32_t index,
+    uint32_t value
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (index >= PULSE_INSTRUCTIONS_MAX)
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].instructions[index] = value;
+
+    return 1;
+}
+
+
+// Set the input latency the first state of the loaded instructions was
+// compensated for, it is checked against the input at commit
+bool pulse_input_latency_set(
+    uint32_t pulse_id,
+    uint32_t input_latency
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].input_latency = input_latency;
+
+    return 1;
+}
+
+
+// Set the repeat block layout of the loaded instructions. The linear segment
+// (pads, terminator, prefix) and the repeat block are DMA rings, so both need
+// a power of two amount of words and an aligned offset.
+bool pulse_instructions_repeat_set(
+    uint32_t pulse_id,
+    uint32_t linear_offset,
+    uint32_t linear_words,
+    uint32_t repeat_offset,
+    uint32_t repeat_words,
+    uint32_t repeat_count
+) {
+
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    // Validate the repeat count
+    if ((repeat_count == 0) ||
+        (repeat_count > PULSE_REPEAT_COUNT_MAX))
+    {
+        return 0;
+    }
+
+    // Validate both rings
+    const uint32_t offsets[] = {linear_offset, repeat_offset};
+    const uint32_t words[] = {linear_words, repeat_words};
+
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        if ((words[i] == 0) ||
+            (words[i] & (words[i] - 1)) ||
+            (offsets[i] % words[i]) ||
+            ((offsets[i] + words[i]) > PULSE_INSTRUCTIONS_MAX))
+        {
+            return 0;
+        }
+    }
+
+    staged_pulse_config[pulse_id].linear_offset = linear_offset;
+    staged_pulse_config[pulse_id].linear_words = linear_words;
+    staged_pulse_config[pulse_id].repeat_offset = repeat_offset;
+    staged_pulse_config[pulse_id].repeat_words = repeat_words;
+    staged_pulse_config[pulse_id].repeat_count = repeat_count;
+
     return 1;
 }
 
@@ -1026,8 +2085,224 @@ bool pulse_sequencer_state_reset(
     }
 
     sequencer_output_config_reset(
-        &sequencer_pulse_config[pulse_id]
+        &staged_pulse_config[pulse_id]
     );
 
     return 1;
-}
\ No newline at end of file
+}
+
+
+// Store the loaded instructions as entry N of the sequence table. Only valid
+// sequences without a repeat block can be stored.
+bool pulse_sequence_store(
+    uint32_t pulse_id,
+    uint32_t entry
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (entry >= PULSE_SEQUENCES_MAX)
+    {
+        return 0;
+    }
+
+    struct pulse_config* config = &staged_pulse_config[pulse_id];
+
+    if ((config -> repeat_count > 0) ||
+        !sequencer_pulse_validate(config))
+    {
+        return 0;
+    }
+
+    memcpy(
+        config -> sequences[entry].instructions,
+        config -> instructions,
+        sizeof(config -> instructions)
+    );
+
+    config -> sequences[entry].instruction_format = config -> instruction_format;
+    config -> sequences[entry].instruction_words = config -> instruction_words;
+    config -> sequences_stored |= 1u << entry;
+
+    return 1;
+}
+
+
+// Drop all entries of the sequence table and stop using it
+bool pulse_sequence_clear(
+    uint32_t pulse_id
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].sequences_stored = 0;
+    staged_pulse_config[pulse_id].sequence_mode = PULSE_SEQUENCE_OFF;
+
+    return 1;
+}
+
+
+bool pulse_sequence_mode_set(
+    uint32_t pulse_id,
+    uint32_t sequence_mode
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (sequence_mode > PULSE_SEQUENCE_LIST)
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].sequence_mode = sequence_mode;
+
+    return 1;
+}
+
+
+// Select the entry streamed in bus mode. Unlike the other setters this one
+// also works while running: the selection is written to the published config
+// and handed to the DMA, so it takes effect at the next sequence boundary.
+bool pulse_sequence_select_set(
+    uint32_t pulse_id,
+    uint32_t entry
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (entry >= PULSE_SEQUENCES_MAX)
+    {
+        return 0;
+    }
+
+    struct pulse_config* running_config = &sequencer_pulse_config[pulse_id];
+
+    if (running_config -> configured != true)
+    {
+        staged_pulse_config[pulse_id].sequence_select = entry;
+
+        return 1;
+    }
+
+    // Only entries that were committed can be streamed
+    if ((running_config -> sequence_mode != PULSE_SEQUENCE_BUS) ||
+        !(running_config -> sequences_stored & (1u << entry)))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].sequence_select = entry;
+    running_config -> sequence_select = entry;
+
+    sequencer_output_sequence_select(
+        running_config,
+        entry
+    );
+
+    return 1;
+}
+
+
+// Set the step list of the list mode. The control DMA channel walks the list
+// as a ring, so the amount of steps has to be a power of two.
+bool pulse_sequence_steps_set(
+    uint32_t pulse_id,
+    uint32_t steps[PULSE_SEQUENCE_STEPS_MAX],
+    uint32_t step_count
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if ((step_count == 0) ||
+        (step_count > PULSE_SEQUENCE_STEPS_MAX) ||
+        (step_count & (step_count - 1)))
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < step_count; i++)
+    {
+        if (steps[i] >= PULSE_SEQUENCES_MAX)
+        {
+            return 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < step_count; i++)
+    {
+        staged_pulse_config[pulse_id].sequence_steps[i] = steps[i];
+    }
+
+    staged_pulse_config[pulse_id].sequence_step_count = step_count;
+
+    return 1;
+}
+
+
+// Set the delay sweep of a scan. Delays are in clock cycles of the pulse
+// sequencer, zero points turn the scan off.
+bool pulse_scan_set(
+    uint32_t pulse_id,
+    uint32_t scan_state,
+    uint32_t scan_start,
+    uint32_t scan_step,
+    uint32_t scan_points,
+    uint32_t scan_triggers
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if ((scan_points > PULSE_SCAN_POINTS_MAX) ||
+        (scan_triggers == 0))
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].scan_state = scan_state;
+    staged_pulse_config[pulse_id].scan_start = scan_start;
+    staged_pulse_config[pulse_id].scan_step = scan_step;
+    staged_pulse_config[pulse_id].scan_points = scan_points;
+    staged_pulse_config[pulse_id].scan_triggers = scan_triggers;
+
+    return 1;
+}
+
+
+// Set the outputs raised during the first sequence of every scan point
+bool pulse_scan_marker_set(
+    uint32_t pulse_id,
+    uint32_t scan_marker
+) {
+    // Validate pulse ID
+    if(!pulse_id_validate(pulse_id))
+    {
+        return 0;
+    }
+
+    if (scan_marker & ~OUT_MASK)
+    {
+        return 0;
+    }
+
+    staged_pulse_config[pulse_id].scan_marker = scan_marker;
+
+    return 1;
+}
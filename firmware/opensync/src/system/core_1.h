@@ -8,12 +8,39 @@
 
 extern const uint32_t ARM_SEQUENCER;
 
+typedef enum {
+    CONFIG_COMMIT_OK = 0,
+    CONFIG_COMMIT_PULSE_CONFLICT,
+    CONFIG_COMMIT_IRQ_CONFLICT,
+    CONFIG_COMMIT_INPUT_CONFLICT,
+    CONFIG_COMMIT_CLOCK_MODE,
+    CONFIG_COMMIT_TRIGGER_COUNT,
+    CONFIG_COMMIT_PULSE_INVALID,
+    CONFIG_COMMIT_PROGRAM_SPACE,
+    CONFIG_COMMIT_DELAY_RANGE,
+    CONFIG_COMMIT_DATA_STALE
+} config_commit_result_t;
+
 void core_1_init();
 
+uint32_t sequencer_boot_armed_us_get();
+
 struct clock_config* sequencer_clock_config_get();
 
 struct pulse_config* sequencer_pulse_config_get();
 
+const struct clock_config* sequencer_clock_config_published_get();
+
+const struct pulse_config* sequencer_pulse_config_published_get();
+
+uint32_t sequencer_config_commit();
+
+void sequencer_config_revert();
+
+void sequencer_config_checkpoint();
+
+void sequencer_config_rollback();
+
 void debug_message_print(
     uint32_t debug_status_local,
     char* message
@@ -29,20 +56,54 @@ void sequencer_clock_sm_config_active();
 
 void sequencer_output_sm_config_active();
 
+uint32_t sequencer_sm_arm_check(
+    uint32_t* channel
+);
+
 uint sequencer_clock_sm_mask_get();
 
 uint sequencer_output_sm_mask_get();
 
 void sequencer_clock_sm_stall();
 
+bool sequencer_output_sm_external_busy();
+
+void sequencer_output_sequence_poll();
+
+void sequencer_output_scan_poll();
+
 void sequencer_sm_active_free();
 
 bool sequencer_pulse_conflict_check();
 
+bool sequencer_pulse_irq_conflict_check();
+
+bool sequencer_pulse_select_conflict_check();
+
+bool sequencer_clock_pin_output_check(
+    uint32_t clock_id
+);
+
+bool sequencer_pulse_repeat_validate(
+    struct pulse_config* config
+);
+
+bool sequencer_pulse_fast_validate(
+    struct pulse_config* config
+);
+
 bool sequencer_pulse_validate(
     struct pulse_config* config
 );
 
+bool sequencer_pulse_sequence_validate(
+    struct pulse_config* config
+);
+
+bool sequencer_pulse_scan_validate(
+    struct pulse_config* config
+);
+
 bool sequencer_clock_mode_set(
     uint32_t clock_id,
     uint32_t requested_mode
@@ -63,10 +124,35 @@ bool sequencer_trigger_level_set(
     uint32_t requested_level
 );
 
+bool sequencer_trigger_logic_set(
+    uint32_t clock_id,
+    uint32_t requested_logic
+);
+
 bool clock_id_validate(
     uint32_t clock_id
 );
 
+bool validate_clock_mode(
+    uint32_t clock_mode
+);
+
+bool validate_trigger_mode(
+    uint32_t trigger_mode
+);
+
+bool validate_trigger_edge(
+    uint32_t trigger_edge
+);
+
+bool validate_trigger_level(
+    uint32_t trigger_level
+);
+
+bool validate_trigger_logic(
+    uint32_t trigger_logic
+);
+
 bool trigger_id_validate(
     uint32_t pulse_id
 );
@@ -85,14 +171,29 @@ bool pulse_divider_set(
     uint32_t clock_divider_copy
 );
 
+bool clock_divider_fixed_validate(
+    uint32_t clock_divider_fixed
+);
+
+bool clock_divider_fixed_set(
+    uint32_t clock_id,
+    uint32_t clock_divider_fixed
+);
+
+bool pulse_divider_fixed_set(
+    uint32_t pulse_id,
+    uint32_t clock_divider_fixed
+);
+
 bool clock_sequencer_state_set(
     uint32_t clock_id,
     bool clock_state
 );
 
-bool trigger_pin_set(
+bool trigger_pins_set(
     uint32_t clock_id,
-    uint32_t trigger_pin_id
+    uint32_t trigger_pin_ids[CLOCK_TRIGGER_INPUTS_MAX],
+    uint32_t trigger_inputs
 );
 
 bool trigger_count_set(
@@ -105,9 +206,21 @@ bool trigger_skip_set(
     uint32_t trigger_skips
 );
 
+bool trigger_filter_set(
+    uint32_t clock_id,
+    uint32_t trigger_filter
+);
+
 bool trigger_delay_set(
     uint32_t clock_id,
-    uint32_t trigger_delay
+    uint32_t trigger_delay,
+    uint32_t trigger_latency
+);
+
+bool trigger_mask_set(
+    uint32_t clock_id,
+    uint32_t trigger_mask[CLOCK_TRIGGER_MASK_WORDS],
+    uint32_t trigger_mask_length
 );
 
 bool clock_instructions_load(
@@ -115,14 +228,20 @@ bool clock_instructions_load(
     uint32_t instructions[CLOCK_INSTRUCTIONS_MAX]
 );
 
+bool clock_instruction_patch(
+    uint32_t clock_id,
+    uint32_t index,
+    uint32_t value
+);
+
 bool clock_unit_offset_set(
     uint32_t clock_id,
-    double units_offset
+    uint64_t units_offset
 );
 
 bool clock_trigger_unit_offset_set(
     uint32_t clock_id,
-    double units_offset
+    uint64_t units_offset
 );
 
 
@@ -140,16 +259,87 @@ bool pulse_pin_clock_set(
     uint32_t clock_id
 );
 
+bool pulse_pin_trigger_set(
+    uint32_t pulse_id,
+    uint32_t trigger_id
+);
+
+bool pulse_irq_clock_set(
+    uint32_t pulse_id,
+    uint32_t clock_id
+);
+
 bool pulse_unit_offset_set(
     uint32_t pulse_id,
-    double units_offset
+    uint64_t units_offset
 );
 
 bool pulse_instructions_load(
     uint32_t pulse_id,
-    uint32_t instructions[PULSE_INSTRUCTIONS_MAX]
+    uint32_t instructions[PULSE_INSTRUCTIONS_MAX],
+    uint32_t instruction_format,
+    uint32_t instruction_words
+);
+
+bool pulse_instruction_patch(
+    uint32_t pulse_id,
+    uint32_t index,
+    uint32_t value
+);
+
+bool pulse_input_latency_set(
+    uint32_t pulse_id,
+    uint32_t input_latency
+);
+
+bool pulse_instructions_repeat_set(
+    uint32_t pulse_id,
+    uint32_t linear_offset,
+    uint32_t linear_words,
+    uint32_t repeat_offset,
+    uint32_t repeat_words,
+    uint32_t repeat_count
 );
 
 bool pulse_sequencer_state_reset(
     uint32_t pulse_id
-);
\ No newline at end of file
+);
+
+bool pulse_sequence_store(
+    uint32_t pulse_id,
+    uint32_t entry
+);
+
+bool pulse_sequence_clear(
+    uint32_t pulse_id
+);
+
+bool pulse_sequence_mode_set(
+    uint32_t pulse_id,
+    uint32_t sequence_mode
+);
+
+bool pulse_sequence_select_set(
+    uint32_t pulse_id,
+    uint32_t entry
+);
+
+bool pulse_sequence_steps_set(
+    uint32_t pulse_id,
+    uint32_t steps[PULSE_SEQUENCE_STEPS_MAX],
+    uint32_t step_count
+);
+
+bool pulse_scan_set(
+    uint32_t pulse_id,
+    uint32_t scan_state,
+    uint32_t scan_start,
+    uint32_t scan_step,
+    uint32_t scan_points,
+    uint32_t scan_triggers
+);
+
+bool pulse_scan_marker_set(
+    uint32_t pulse_id,
+    uint32_t scan_marker
+);
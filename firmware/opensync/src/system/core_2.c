@@ -1,5 +1,6 @@
 #include "core_2.h"
 
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,29 +13,189 @@
 #include "hardware/dma.h"
 
 #include "core_1.h"
+#include "config_slots.h"
+#include "config_snapshot.h"
 #include "overclock/overclock.h"
 #include "structs/clock_config.h"
 #include "structs/pulse_config.h"
 #include "status/sequencer_status.h"
 #include "status/debug_status.h"
+#include "status/trigger_status.h"
+#include "status/scan_status.h"
+#include "status/arm_status.h"
 #include "sequencer/sequencer_clock.h"
 #include "serial/scpi-def.h"
+#include "serial/scpi_device.h"
+#include "serial/scpi_dispatch.h"
+#include "serial/scpi_macro.h"
 
 #include "fast_serial.h"
 
-// Serial buffer//
-#define SERIAL_BUFFER_SIZE 64
+// Serial buffer, large enough for a full program message incl. blocks
+#define SERIAL_BUFFER_SIZE SCPI_INPUT_BUFFER_LENGTH
 char serial_buf[SERIAL_BUFFER_SIZE];
 
+// Status update interval while waiting for a command
+#define SERIAL_STATUS_UPDATE_US 1000
+
+
+// Get the amount of definite length block bytes ("#<digits><length><data>")
+// still missing at the end of the received message
+static uint32_t serial_block_pending_get(
+    const char* buffer,
+    uint32_t length
+) {
+    char quote = 0;
+
+    for (uint32_t i = 0; i < length; i++)
+    {
+        // Skip string parameters, they may hold any character
+        if (quote != 0)
+        {
+            if (buffer[i] == quote)
+            {
+                quote = 0;
+            }
+
+            continue;
+        }
+
+        if ((buffer[i] == '"') || (buffer[i] == '\''))
+        {
+            quote = buffer[i];
+            continue;
+        }
+
+        if ((buffer[i] != '#') ||
+            (i + 1 >= length) ||
+            (buffer[i + 1] < '1') ||
+            (buffer[i + 1] > '9'))
+        {
+            continue;
+        }
+
+        const uint32_t digits = buffer[i + 1] - '0';
+        uint32_t block_length = 0;
+
+        // The length digits themselves are still in transit
+        if (i + 2 + digits > length)
+        {
+            return 0;
+        }
+
+        for (uint32_t j = i + 2; j < i + 2 + digits; j++)
+        {
+            block_length = 10 * block_length + (buffer[j] - '0');
+        }
+
+        const uint32_t block_start = i + 2 + digits;
+
+        if (block_start + block_length > length)
+        {
+            return block_start + block_length - length;
+        }
+
+        i = block_start + block_length - 1;
+    }
+
+    return 0;
+}
+
+
+// Read one program message up to its terminator. Block data may hold the
+// terminator byte, so blocks are read by their length instead.
+static uint32_t serial_message_read(
+    char* buffer,
+    uint32_t buffer_size
+) {
+    uint32_t length = 0;
+
+    while (length < buffer_size - 1)
+    {
+        length += fast_serial_read_until(
+            buffer + length,
+            buffer_size - length,
+            '\n'
+        );
+
+        uint32_t pending = serial_block_pending_get(
+            buffer,
+            length
+        );
+
+        if (pending == 0)
+        {
+            break;
+        }
+
+        // Keep one byte for the null terminator
+        if (pending > buffer_size - 1 - length)
+        {
+            pending = buffer_size - 1 - length;
+        }
+
+        length += fast_serial_read(
+            buffer + length,
+            pending
+        );
+
+        buffer[length] = '\0';
+    }
+
+    return length;
+}
+
+
+// Recall the autostart slot, if enabled, and arm the sequencer with it. A
+// slot that does not pass the commit checks leaves the defaults staged.
+static void core_2_autostart()
+{
+    uint32_t slot = 0;
+
+    if (!config_slot_autostart_get(&slot))
+    {
+        return;
+    }
+
+    if (config_slot_recall(slot) != CONFIG_SLOT_OK)
+    {
+        return;
+    }
+
+    if (sequencer_config_commit() != CONFIG_COMMIT_OK)
+    {
+        config_snapshot_restore();
+
+        return;
+    }
+
+    arm_result_reset();
+    multicore_fifo_push_blocking(ARM_SEQUENCER);
+}
+
 
 void core_2_init()
 {
-	// Set system clock speed
-	overclock_system_set();
+	// Set system clock speed of the stored clock profile, flash is readable
+	// before the clock is raised
+	overclock_system_set(config_slot_clock_profile_get());
 
 	// Register sequencer status mutexes
     sequencer_status_register();
 	debug_status_register();
+	trigger_status_register();
+	scan_status_register();
+	arm_status_register();
+
+	// Intialize sequencer cores
+	multicore_launch_core1(core_1_init);
+    multicore_fifo_pop_blocking();
+
+	// Set system status to idle
+	sequencer_status_set(IDLE);
+
+	// Arm the autostart slot before USB enumeration
+	core_2_autostart();
 
     // Initialize serial interface
 	stdio_init_all();
@@ -43,26 +204,43 @@ void core_2_init()
 	// Initialize device SCPI interface
     scpi_instrument_init();
 
-	// Intialize sequencer cores
-	multicore_launch_core1(core_1_init);
-    multicore_fifo_pop_blocking();
-
-	// Set system status to idle
-	sequencer_status_set(IDLE);
+    absolute_time_t status_update_next = get_absolute_time();
 
     while(1)
     {  
-        uint32_t buf_len = fast_serial_read_until(
-            serial_buf, 
-            SERIAL_BUFFER_SIZE, 
-            '\n'
-        );
+		// Keep reporting events while no command comes in, so service
+		// requests reach hosts that wait for them instead of polling
+		while (fast_serial_read_available() == 0)
+		{
+			fast_serial_task();
 
-		// Parse scpi command and hope for the best
-		SCPI_Input(
-            &scpi_context, 
-            serial_buf, 
-            strlen(serial_buf)
+			if (time_reached(status_update_next))
+			{
+				scpi_device_status_update(&scpi_context);
+				status_update_next = make_timeout_time_us(SERIAL_STATUS_UPDATE_US);
+			}
+		}
+
+        uint32_t buf_len = serial_message_read(
+            serial_buf,
+            SERIAL_BUFFER_SIZE
         );
+
+		// Report events raised by the sequencer core since the last command
+		scpi_device_status_update(&scpi_context);
+
+		// Run a user macro in place of its label, everything else goes to
+		// the parser
+		if (!scpi_macro_input(
+			&scpi_context,
+			serial_buf,
+			buf_len
+		)) {
+			scpi_dispatch_input(
+				&scpi_context,
+				serial_buf,
+				buf_len
+			);
+		}
     }
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+// Host stand-in for the Pico SDK header, only the types the config structs
+// and sequencer headers use and the standard headers the SDK brings along.
+// The host tests never touch a state machine.
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t* PIO;
+typedef struct pio_program pio_program_t;
+
+enum pio_src_dest {
+    pio_pins = 0u,
+    pio_x = 1u,
+    pio_y = 2u,
+};
@@ -0,0 +1,218 @@
+// Host benchmark of SCPI header dispatch, linear scpi-parser search against
+// the generated dispatch table. Build with the CMakeLists.txt next to this
+// file, see there for the commands.
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "scpi/scpi.h"
+
+#include "serial/scpi_dispatch.h"
+
+#define SCPI_DISPATCH_WITH_PATTERNS
+#include "scpi_dispatch_table.h"
+
+
+#define BENCH_REPEATS 20000
+#define BENCH_HEADER_LENGTH 96
+#define BENCH_INPUT_BUFFER_LENGTH 256
+#define BENCH_ERROR_QUEUE_SIZE 17
+
+static scpi_command_t bench_commands[SCPI_DISPATCH_COMMANDS + 1];
+static char bench_input_buffer[BENCH_INPUT_BUFFER_LENGTH];
+static scpi_error_t bench_error_queue_data[BENCH_ERROR_QUEUE_SIZE];
+static scpi_t bench_context;
+
+static int32_t bench_command_called = -1;
+static uint32_t bench_errors = 0;
+
+
+static scpi_result_t bench_callback(
+    scpi_t* context
+) {
+    bench_command_called = (int32_t) (context->param_list.cmd - bench_commands);
+
+    return SCPI_RES_OK;
+}
+
+
+static size_t bench_write(
+    scpi_t* context,
+    const char* data,
+    size_t len
+) {
+    (void) context;
+    (void) data;
+
+    return len;
+}
+
+
+static int bench_error(
+    scpi_t* context,
+    int_fast16_t err
+) {
+    (void) context;
+    (void) err;
+
+    bench_errors++;
+    return 0;
+}
+
+
+static scpi_interface_t bench_interface = {
+    .write = bench_write,
+    .error = bench_error,
+    .reset = NULL,
+    .control = NULL,
+    .flush = NULL,
+};
+
+
+// Spell a pattern out as a header, either in long form with optional
+// keywords or in short form without them. Numeric suffixes get a 1.
+static void bench_header_get(
+    const char* pattern,
+    bool long_form,
+    char* header
+) {
+    bool optional = false;
+    bool lower = false;
+
+    for (const char* c = pattern; *c != '\0'; c++)
+    {
+        if ((*c == '[') || (*c == ']'))
+        {
+            optional = (*c == '[');
+            continue;
+        }
+
+        if (optional && !long_form)
+        {
+            continue;
+        }
+
+        if (*c == ':')
+        {
+            lower = false;
+        }
+        else if ((*c >= 'a') && (*c <= 'z'))
+        {
+            lower = true;
+        }
+
+        if (*c == '#')
+        {
+            *header++ = '1';
+        }
+        else if (long_form || !lower || (*c == '?'))
+        {
+            *header++ = *c;
+        }
+    }
+
+    *header++ = '\n';
+    *header = '\0';
+}
+
+
+// Run a header through the parser, returns the mean time in ns and the
+// index of the command that was called
+static double bench_input_time(
+    const char* header,
+    bool dispatch,
+    int32_t* command
+) {
+    struct timespec start, stop;
+    const size_t length = strlen(header);
+
+    bench_command_called = -1;
+    bench_errors = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (uint32_t i = 0; i < BENCH_REPEATS; i++)
+    {
+        if (dispatch)
+        {
+            scpi_dispatch_input(&bench_context, header, length);
+        }
+        else
+        {
+            SCPI_Input(&bench_context, header, length);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    *command = (bench_errors == 0) ? bench_command_called : -1;
+
+    return ((stop.tv_sec - start.tv_sec) * 1e9 + (stop.tv_nsec - start.tv_nsec)) / BENCH_REPEATS;
+}
+
+
+int main(void)
+{
+    char header[BENCH_HEADER_LENGTH];
+    double linear_total = 0.0;
+    double dispatch_total = 0.0;
+    uint32_t samples = 0;
+    uint32_t mismatches = 0;
+
+    for (uint32_t i = 0; i < SCPI_DISPATCH_COMMANDS; i++)
+    {
+        bench_commands[i].pattern = scpi_dispatch_patterns[i];
+        bench_commands[i].callback = bench_callback;
+    }
+
+    SCPI_Init(
+        &bench_context,
+        bench_commands,
+        &bench_interface,
+        scpi_units_def,
+        "OpenPIV", "OpenSync", "bench", "0",
+        bench_input_buffer, BENCH_INPUT_BUFFER_LENGTH,
+        bench_error_queue_data, BENCH_ERROR_QUEUE_SIZE
+    );
+
+    if (!scpi_dispatch_init(bench_commands))
+    {
+        fprintf(stderr, "Dispatch table does not match the command list\n");
+        return 1;
+    }
+
+    printf("%-48s %12s %12s\n", "header", "linear (ns)", "table (ns)");
+
+    for (uint32_t i = 0; i < SCPI_DISPATCH_COMMANDS; i++)
+    {
+        for (uint32_t form = 0; form < 2; form++)
+        {
+            int32_t linear_command = -1;
+            int32_t dispatch_command = -1;
+
+            bench_header_get(scpi_dispatch_patterns[i], form == 1, header);
+
+            const double linear = bench_input_time(header, false, &linear_command);
+            const double dispatch = bench_input_time(header, true, &dispatch_command);
+
+            if ((linear_command < 0) || (linear_command != dispatch_command))
+            {
+                mismatches++;
+            }
+
+            header[strlen(header) - 1] = '\0';
+            printf("%-48s %12.1f %12.1f%s\n", header, linear, dispatch,
+                (linear_command != dispatch_command) ? "  MISMATCH" : "");
+
+            linear_total += linear;
+            dispatch_total += dispatch;
+            samples++;
+        }
+    }
+
+    printf("\n%u headers, %u states, %u edges\n", samples, SCPI_DISPATCH_STATES, SCPI_DISPATCH_EDGES);
+    printf("mean per command: linear %.1f ns, table %.1f ns\n", linear_total / samples, dispatch_total / samples);
+
+    return mismatches != 0;
+}
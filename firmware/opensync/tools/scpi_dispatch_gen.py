@@ -0,0 +1,324 @@
+"""Generate the SCPI header dispatch table from the firmware command list.
+
+The patterns of ``scpi_commands[]`` (including the ``INSTRUMENT_*_COMMANDS``
+macros it pulls in) are expanded into every header spelling scpi-parser
+accepts: short or long form per mnemonic, with and without optional
+``[...]`` keywords. Numeric suffixes (``#``) are dropped from the key, the
+firmware skips digits while walking the table. The expanded keys are
+folded into a minimal acyclic state machine, so a header is resolved to
+the first command that can match it in a single pass over its characters.
+
+With --check, the patterns are read from scpi-def.c as the compiler sees
+it (preprocessed, e.g. ``cc -E``) and compared with the command count and
+pattern hash of a generated table. A mismatch fails, so a table that
+scpi_dispatch_init would reject at runtime breaks the build instead.
+
+Usage: scpi_dispatch_gen.py <scpi-def.c> <output header>
+       scpi_dispatch_gen.py --check <preprocessed scpi-def.c> <table header> <stamp>
+"""
+
+import glob
+import os
+import re
+import sys
+
+
+NO_COMMAND = 0xFFFF
+
+COMMENT_RE = re.compile(r'/\*.*?\*/|//[^\n]*', re.DOTALL)
+PATTERN_RE = re.compile(r'\.pattern\s*=\s*"([^"]*)"')
+DEFINE_RE = re.compile(r'#define\s+(INSTRUMENT_\w+_COMMANDS)\b((?:[^\n]*\\\n)*[^\n]*)')
+ENTRY_RE = re.compile(r'\.pattern\s*=\s*"([^"]*)"|\b(INSTRUMENT_\w+_COMMANDS)\b')
+EXPANDED_RE = re.compile(r'\.pattern\s*=\s*"([^"]*)"')
+POSITIONAL_RE = re.compile(r'\s*"([^"]*)"')
+DEFINE_VALUE_RE = re.compile(r'#define\s+(SCPI_DISPATCH_COMMANDS|SCPI_DISPATCH_PATTERNS_HASH)\s+(\w+)')
+
+
+def _strip_comments(text: str) -> str:
+    return COMMENT_RE.sub('', text)
+
+
+def _read_macros(source_dir: str) -> dict:
+    macros = {}
+
+    for path in sorted(glob.glob(os.path.join(source_dir, '*.h'))):
+        with open(path) as f:
+            text = _strip_comments(f.read())
+
+        for name, body in DEFINE_RE.findall(text):
+            macros[name] = PATTERN_RE.findall(body)
+
+    return macros
+
+
+def read_patterns(scpi_def_path: str) -> list:
+    """Return the command patterns in the order of scpi_commands[]."""
+    with open(scpi_def_path) as f:
+        text = _strip_comments(f.read())
+
+    start = text.index('scpi_commands[]')
+    end = text.index('SCPI_CMD_LIST_END', start)
+
+    macros = _read_macros(os.path.dirname(scpi_def_path))
+    patterns = []
+
+    for pattern, macro in ENTRY_RE.findall(text[start:end]):
+        if macro:
+            if macro not in macros:
+                raise ValueError(f'Command macro {macro} is not defined')
+            patterns.extend(macros[macro])
+        else:
+            patterns.append(pattern)
+
+    return patterns
+
+
+def _initializer_entries(text: str) -> list:
+    """Return the text of every brace enclosed entry of the first array
+    initializer in text."""
+    entries = []
+    depth = 0
+    string = False
+    start = 0
+
+    for i, c in enumerate(text[text.index('{'):], text.index('{')):
+        if string:
+            string = (c != '"') or (text[i - 1] == '\\')
+        elif c == '"':
+            string = True
+        elif c == '{':
+            depth += 1
+            if depth == 2:
+                start = i + 1
+        elif c == '}':
+            if depth == 2:
+                entries.append(text[start:i])
+            depth -= 1
+            if depth == 0:
+                break
+
+    return entries
+
+
+def read_expanded_patterns(preprocessed_path: str) -> list:
+    """Return the patterns of scpi_commands[] in preprocessed source, up to
+    the SCPI_CMD_LIST_END entry (the first one without a pattern string)."""
+    with open(preprocessed_path) as f:
+        text = f.read()
+
+    patterns = []
+
+    for entry in _initializer_entries(text[text.index('scpi_commands[]'):]):
+        match = EXPANDED_RE.search(entry) or POSITIONAL_RE.match(entry)
+
+        if not match:
+            return patterns
+
+        patterns.append(match.group(1))
+
+    raise ValueError('scpi_commands[] has no end entry')
+
+
+def _expand_optional(pattern: str) -> list:
+    start = pattern.find('[')
+
+    if start < 0:
+        return [pattern]
+
+    end = pattern.index(']', start)
+    head, body, tail = pattern[:start], pattern[start + 1:end], pattern[end + 1:]
+
+    return _expand_optional(head + body + tail) + _expand_optional(head + tail)
+
+
+def _short_form(mnemonic: str) -> str:
+    # Same rule as scpi-parser: the short form ends at the first lower case letter
+    for i, c in enumerate(mnemonic):
+        if c.islower():
+            return mnemonic[:i]
+    return mnemonic
+
+
+def expand_keys(pattern: str) -> set:
+    """Return every header spelling of a pattern, upper case and without digits."""
+    keys = set()
+
+    for variant in _expand_optional(pattern):
+        query = variant.endswith('?')
+        variant = variant.rstrip('?').lstrip(':')
+
+        spellings = ['']
+
+        for mnemonic in variant.split(':'):
+            mnemonic = mnemonic.rstrip('#')
+
+            if any(c.isdigit() for c in mnemonic):
+                raise ValueError(f'Pattern {pattern} has digits in a mnemonic')
+
+            forms = {_short_form(mnemonic).upper(), mnemonic.upper()}
+            spellings = [s + (':' if s else '') + form for s in spellings for form in forms]
+
+        keys.update(s + ('?' if query else '') for s in spellings)
+
+    return keys
+
+
+def build_states(patterns: list) -> list:
+    """Build the minimal state machine, state 0 is the start state.
+
+    Every state is a tuple (command, ((symbol, next state), ...)).
+    """
+    trie = [[NO_COMMAND, {}]]
+
+    for index, pattern in enumerate(patterns):
+        for key in expand_keys(pattern):
+            node = 0
+
+            for c in key:
+                edges = trie[node][1]
+                if c not in edges:
+                    edges[c] = len(trie)
+                    trie.append([NO_COMMAND, {}])
+                node = edges[c]
+
+            # scpi-parser takes the first matching command of the list
+            if trie[node][0] == NO_COMMAND:
+                trie[node][0] = index
+
+    # Merge equivalent suffixes, children are always created after their parent
+    states = []
+    state_ids = {}
+    trie_to_state = [0] * len(trie)
+
+    for node in reversed(range(len(trie))):
+        command, edges = trie[node]
+        signature = (command, tuple(sorted((c, trie_to_state[n]) for c, n in edges.items())))
+
+        if signature not in state_ids:
+            state_ids[signature] = len(states)
+            states.append(signature)
+
+        trie_to_state[node] = state_ids[signature]
+
+    # Renumber so the start state comes first
+    order = list(reversed(range(len(states))))
+    renumber = {old: new for new, old in enumerate(order)}
+
+    return [(states[old][0], tuple((c, renumber[n]) for c, n in states[old][1])) for old in order]
+
+
+def _fnv1a(patterns: list) -> int:
+    h = 0x811C9DC5
+
+    for pattern in patterns:
+        for b in pattern.encode() + b'\n':
+            h = ((h ^ b) * 0x01000193) & 0xFFFFFFFF
+
+    return h
+
+
+def render(patterns: list, states: list, source: str) -> str:
+    edge_count = sum(len(edges) for _, edges in states)
+
+    if len(states) > NO_COMMAND or edge_count > NO_COMMAND or len(patterns) >= NO_COMMAND:
+        raise ValueError('SCPI dispatch table does not fit 16 bit indices')
+
+    lines = [
+        '// Generated by tools/scpi_dispatch_gen.py from ' + source + ', do not edit',
+        '#pragma once',
+        '',
+        f'#define SCPI_DISPATCH_COMMANDS {len(patterns)}',
+        f'#define SCPI_DISPATCH_PATTERNS_HASH 0x{_fnv1a(patterns):08X}u',
+        f'#define SCPI_DISPATCH_STATES {len(states)}',
+        f'#define SCPI_DISPATCH_EDGES {edge_count}',
+        '',
+        '// first edge, edge count, command',
+        'static const struct scpi_dispatch_state scpi_dispatch_states[SCPI_DISPATCH_STATES] = {',
+    ]
+
+    first = 0
+    for command, edges in states:
+        command_text = 'SCPI_DISPATCH_NO_COMMAND' if command == NO_COMMAND else str(command)
+        lines.append(f'    {{{first}, {len(edges)}, {command_text}}},')
+        first += len(edges)
+
+    lines += [
+        '};',
+        '',
+        '// symbol, next state',
+        'static const struct scpi_dispatch_edge scpi_dispatch_edges[SCPI_DISPATCH_EDGES] = {',
+    ]
+
+    for _, edges in states:
+        for c, n in edges:
+            lines.append(f"    {{'{c}', {n}}},")
+
+    lines += [
+        '};',
+        '',
+        '#ifdef SCPI_DISPATCH_WITH_PATTERNS',
+        'static const char* const scpi_dispatch_patterns[SCPI_DISPATCH_COMMANDS] = {',
+    ]
+
+    lines += [f'    "{pattern}",' for pattern in patterns]
+
+    lines += [
+        '};',
+        '#endif',
+        '',
+    ]
+
+    return '\n'.join(lines)
+
+
+def check(preprocessed_path: str, table_path: str, stamp_path: str) -> int:
+    patterns = read_expanded_patterns(preprocessed_path)
+
+    with open(table_path) as f:
+        values = dict(DEFINE_VALUE_RE.findall(f.read()))
+
+    count = int(values['SCPI_DISPATCH_COMMANDS'])
+    table_hash = int(values['SCPI_DISPATCH_PATTERNS_HASH'].rstrip('u'), 16)
+
+    if (count, table_hash) != (len(patterns), _fnv1a(patterns)):
+        print(f'{table_path}: SCPI dispatch table does not match scpi_commands[] '
+              f'({count} commands, hash 0x{table_hash:08X}, expected {len(patterns)} commands, '
+              f'hash 0x{_fnv1a(patterns):08X}). The command list has entries '
+              f'scpi_dispatch_gen.py does not read, fix its patterns or the list.',
+              file=sys.stderr)
+        return 1
+
+    with open(stamp_path, 'w') as f:
+        f.write(f'{count} 0x{table_hash:08X}\n')
+
+    return 0
+
+
+def main(argv: list) -> int:
+    if (len(argv) == 5) and (argv[1] == '--check'):
+        return check(argv[2], argv[3], argv[4])
+
+    if len(argv) != 3:
+        print('\n'.join(__doc__.strip().splitlines()[-2:]), file=sys.stderr)
+        return 1
+
+    scpi_def_path, output_path = argv[1], argv[2]
+
+    patterns = read_patterns(scpi_def_path)
+    states = build_states(patterns)
+    text = render(patterns, states, os.path.basename(scpi_def_path))
+
+    # Only touch the output when it changes to avoid needless rebuilds
+    if os.path.exists(output_path):
+        with open(output_path) as f:
+            if f.read() == text:
+                return 0
+
+    with open(output_path, 'w') as f:
+        f.write(text)
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
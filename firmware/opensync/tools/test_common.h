@@ -0,0 +1,44 @@
+#pragma once
+
+// Checks of the host unit tests. A failed check prints its location and the
+// test carries on, main returns test_result() for ctest.
+#include <stdint.h>
+#include <stdio.h>
+
+
+static uint32_t test_failures = 0;
+
+#define TEST_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while (0)
+
+#define TEST_CHECK_EQUAL(actual, expected) \
+    do \
+    { \
+        const unsigned long long test_actual = (unsigned long long) (actual); \
+        const unsigned long long test_expected = (unsigned long long) (expected); \
+        if (test_actual != test_expected) \
+        { \
+            printf("%s:%d: %s is %llu, expected %llu\n", __FILE__, __LINE__, #actual, test_actual, test_expected); \
+            test_failures++; \
+        } \
+    } while (0)
+
+
+static inline int test_result()
+{
+    if (test_failures != 0)
+    {
+        printf("%u checks failed\n", (unsigned) test_failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,206 @@
+// Host tests of the configuration snapshot: the CRC-32, the per config
+// hashes and the checks of a snapshot before it is loaded.
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+#include "sequencer/sequencer_common.h"
+#include "system/config_snapshot.h"
+#include "test_common.h"
+#include "test_stubs.h"
+
+
+static struct config_snapshot test_snapshot;
+
+
+// Staged configs that pass the snapshot limits
+static void test_configs_default()
+{
+    memset(test_clock_configs, 0, sizeof(test_clock_configs));
+    memset(test_pulse_configs, 0, sizeof(test_pulse_configs));
+
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        struct clock_config* config = &test_clock_configs[i];
+
+        config -> clock_pin = INTERNAL_CLOCK_PINS[i];
+        config -> trigger_pin = EXTERNAL_TRIGGER_PINS[0];
+        config -> trigger_pin_aux = EXTERNAL_TRIGGER_PINS[1];
+        config -> trigger_inputs = 1;
+        config -> trigger_mask_words = 1;
+        config -> trigger_mask_bits = 1;
+        config -> clock_divider = 1;
+        config -> unit_offset = 1;
+        config -> unit_offset_trigger = 1000;
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        struct pulse_config* config = &test_pulse_configs[i];
+
+        config -> clock_pin = INTERNAL_CLOCK_PINS[i];
+        config -> input_source = PULSE_INPUT_CLOCK;
+        config -> clock_divider = 1;
+        config -> unit_offset = 1000;
+        config -> instruction_format = PULSE_FORMAT_STANDARD;
+        config -> instruction_words = PULSE_INSTRUCTIONS_MAX;
+        config -> sequence_step_count = 1;
+        config -> scan_triggers = 1;
+    }
+}
+
+
+// Seal a snapshot changed by a test, so only the record checks can reject it
+static void test_snapshot_seal()
+{
+    test_snapshot.header.crc = config_snapshot_crc32(
+        (const uint8_t*) &test_snapshot + sizeof(test_snapshot.header),
+        test_snapshot.header.length,
+        0
+    );
+}
+
+
+static void test_crc32()
+{
+    const uint8_t* check = (const uint8_t*) "123456789";
+
+    // Check value of CRC-32 (IEEE 802.3)
+    TEST_CHECK_EQUAL(config_snapshot_crc32(check, 9, 0), 0xCBF43926u);
+    TEST_CHECK_EQUAL(config_snapshot_crc32(check, 0, 0), 0);
+
+    // A CRC can be continued over several blocks
+    TEST_CHECK_EQUAL(
+        config_snapshot_crc32(check + 4, 5, config_snapshot_crc32(check, 4, 0)),
+        0xCBF43926u
+    );
+}
+
+
+static void test_verify()
+{
+    test_configs_default();
+    config_snapshot_save(&test_snapshot);
+
+    TEST_CHECK_EQUAL(test_snapshot.header.magic, CONFIG_SNAPSHOT_MAGIC);
+    TEST_CHECK_EQUAL(test_snapshot.header.version, CONFIG_SNAPSHOT_VERSION);
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_OK);
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE - 1), CONFIG_SNAPSHOT_LENGTH_MISMATCH);
+
+    test_snapshot.header.version++;
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_HEADER_MISMATCH);
+    test_snapshot.header.version--;
+
+    // Every byte after the header is covered
+    ((uint8_t*) &test_snapshot)[CONFIG_SNAPSHOT_SIZE - 1] ^= 1;
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_CRC_MISMATCH);
+    ((uint8_t*) &test_snapshot)[CONFIG_SNAPSHOT_SIZE - 1] ^= 1;
+
+    test_snapshot.clocks[0].clock_divider_frac ^= 1;
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_CRC_MISMATCH);
+    test_snapshot.clocks[0].clock_divider_frac ^= 1;
+
+    TEST_CHECK_EQUAL(config_snapshot_verify(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_OK);
+}
+
+
+static void test_hashes()
+{
+    uint32_t hashes[CLOCKS_MAX + PULSES_MAX];
+    uint32_t hashes_changed[CLOCKS_MAX + PULSES_MAX];
+
+    test_configs_default();
+    config_snapshot_save(&test_snapshot);
+    config_snapshot_hash_get(hashes);
+
+    // A host gets the same hashes from the records of its snapshot
+    for (uint32_t i = 0; i < CLOCKS_MAX; i++)
+    {
+        TEST_CHECK_EQUAL(hashes[i], config_snapshot_crc32(
+            (const uint8_t*) &test_snapshot.clocks[i],
+            sizeof(test_snapshot.clocks[i]),
+            0
+        ));
+    }
+
+    for (uint32_t i = 0; i < PULSES_MAX; i++)
+    {
+        TEST_CHECK_EQUAL(hashes[CLOCKS_MAX + i], config_snapshot_crc32(
+            (const uint8_t*) &test_snapshot.pulses[i],
+            sizeof(test_snapshot.pulses[i]),
+            0
+        ));
+    }
+
+    // Only the hash of the changed config moves
+    test_pulse_configs[1].instructions[3] = 42;
+    config_snapshot_hash_get(hashes_changed);
+
+    for (uint32_t i = 0; i < CLOCKS_MAX + PULSES_MAX; i++)
+    {
+        if (i == CLOCKS_MAX + 1)
+        {
+            TEST_CHECK(hashes_changed[i] != hashes[i]);
+        }
+        else
+        {
+            TEST_CHECK_EQUAL(hashes_changed[i], hashes[i]);
+        }
+    }
+
+    // The hardware fields of a config are not part of it
+    test_pulse_configs[1].instructions[3] = 0;
+    test_clock_configs[2].sm = 3;
+    test_clock_configs[2].dma_chan = 7;
+    config_snapshot_hash_get(hashes_changed);
+
+    TEST_CHECK_EQUAL(hashes_changed[2], hashes[2]);
+}
+
+
+static void test_load()
+{
+    test_configs_default();
+    test_clock_configs[1].clock_divider = 25;
+    test_pulse_configs[2].instructions[0] = 0xFF;
+    config_snapshot_save(&test_snapshot);
+
+    // Load puts back the saved configs, restore the ones before the load
+    test_configs_default();
+
+    TEST_CHECK_EQUAL(config_snapshot_load(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_OK);
+    TEST_CHECK_EQUAL(test_clock_configs[1].clock_divider, 25);
+    TEST_CHECK_EQUAL(test_pulse_configs[2].instructions[0], 0xFF);
+
+    config_snapshot_restore();
+    TEST_CHECK_EQUAL(test_clock_configs[1].clock_divider, 1);
+    TEST_CHECK_EQUAL(test_pulse_configs[2].instructions[0], 0);
+
+    // Nothing is written unless the whole snapshot passes
+    test_snapshot.pulses[2].unit_offset = 0;
+    TEST_CHECK_EQUAL(config_snapshot_load(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_CRC_MISMATCH);
+
+    test_snapshot_seal();
+    TEST_CHECK_EQUAL(config_snapshot_load(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_OUT_OF_RANGE);
+    TEST_CHECK_EQUAL(test_clock_configs[1].clock_divider, 1);
+    TEST_CHECK_EQUAL(test_pulse_configs[2].unit_offset, 1000);
+
+    test_snapshot.pulses[2].unit_offset = 1000;
+    test_snapshot.clocks[0].clock_divider_frac = 1u << CLOCK_DIVIDER_FRAC_BITS;
+    test_snapshot_seal();
+    TEST_CHECK_EQUAL(config_snapshot_load(&test_snapshot, CONFIG_SNAPSHOT_SIZE), CONFIG_SNAPSHOT_OUT_OF_RANGE);
+    TEST_CHECK_EQUAL(test_clock_configs[1].clock_divider, 1);
+}
+
+
+int main()
+{
+    test_crc32();
+    test_verify();
+    test_hashes();
+    test_load();
+
+    return test_result();
+}
@@ -0,0 +1,315 @@
+// Host tests of trailing channel list parameters, e.g. "TEST:VAL 5,(@0:2)",
+// run through scpi-parser against a small command table.
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "scpi/scpi.h"
+
+#include "serial/scpi_common.h"
+#include "serial/scpi_channel_list.h"
+#include "test_common.h"
+#include "test_stubs.h"
+
+
+#define TEST_CHANNELS 3
+#define TEST_VALUE_MAX 100
+#define TEST_INPUT_BUFFER_LENGTH 256
+#define TEST_OUTPUT_LENGTH 256
+#define TEST_ERROR_QUEUE_SIZE 17
+
+static uint32_t test_values[TEST_CHANNELS];
+static uint32_t test_runs = 0;
+
+static char test_input_buffer[TEST_INPUT_BUFFER_LENGTH];
+static char test_output[TEST_OUTPUT_LENGTH];
+static size_t test_output_length = 0;
+static scpi_error_t test_error_queue_data[TEST_ERROR_QUEUE_SIZE];
+static int_fast16_t test_error_last = 0;
+static scpi_t test_context;
+
+
+static bool test_channel_validate(
+    uint32_t channel_id
+) {
+    return channel_id < TEST_CHANNELS;
+}
+
+
+// Channel from the list, the header suffix or 0
+static uint32_t test_channel_get(
+    scpi_t* context
+) {
+    int32_t numbers[1] = {STATEFUL};
+    uint32_t channel_id = 0;
+
+    SCPI_CommandNumbers(
+        context,
+        numbers,
+        1,
+        STATEFUL
+    );
+
+    if (numbers[0] != STATEFUL)
+    {
+        channel_id = (uint32_t) numbers[0];
+    }
+
+    channel_list_id_get(&channel_id);
+
+    return channel_id;
+}
+
+
+static scpi_result_t TEST_Value(
+    scpi_t* context
+) {
+    const uint32_t channel_id = test_channel_get(context);
+    uint32_t value = 0;
+
+    test_runs++;
+
+    if (!SCPI_ParamUInt32(context, &value, TRUE))
+    {
+        return SCPI_RES_ERR;
+    }
+
+    if ((channel_id >= TEST_CHANNELS) || (value > TEST_VALUE_MAX))
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    test_values[channel_id] = value;
+
+    return SCPI_RES_OK;
+}
+
+
+static scpi_result_t TEST_ValueQ(
+    scpi_t* context
+) {
+    const uint32_t channel_id = test_channel_get(context);
+
+    test_runs++;
+
+    if (channel_id >= TEST_CHANNELS)
+    {
+        SCPI_ErrorPush(
+            context,
+            SCPI_ERROR_DATA_OUT_OF_RANGE
+        );
+
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultUInt32(context, test_values[channel_id]);
+
+    return SCPI_RES_OK;
+}
+
+
+SCPI_CHANNEL_LIST_DEFINE(TEST_Value, test_channel_validate)
+SCPI_CHANNEL_LIST_DEFINE(TEST_ValueQ, test_channel_validate)
+
+static const scpi_command_t test_commands[] = {
+    {.pattern = "TEST:VALue#", .callback = TEST_ValueChannels,},
+    {.pattern = "TEST:VALue#?", .callback = TEST_ValueQChannels,},
+    SCPI_CMD_LIST_END
+};
+
+
+static size_t test_write(
+    scpi_t* context,
+    const char* data,
+    size_t len
+) {
+    (void) context;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if ((data[i] != '\r') && (data[i] != '\n') && (test_output_length + 1 < TEST_OUTPUT_LENGTH))
+        {
+            test_output[test_output_length++] = data[i];
+        }
+    }
+
+    test_output[test_output_length] = '\0';
+
+    return len;
+}
+
+
+static int test_error(
+    scpi_t* context,
+    int_fast16_t err
+) {
+    (void) context;
+
+    test_error_last = err;
+    return 0;
+}
+
+
+static scpi_interface_t test_interface = {
+    .write = test_write,
+    .error = test_error,
+    .reset = NULL,
+    .control = NULL,
+    .flush = NULL,
+};
+
+
+// Run a message, returns the error it raised or 0
+static int_fast16_t test_input(
+    const char* message
+) {
+    test_output_length = 0;
+    test_output[0] = '\0';
+    test_error_last = 0;
+    test_runs = 0;
+
+    SCPI_Input(&test_context, message, strlen(message));
+
+    return test_error_last;
+}
+
+
+static void test_values_set(
+    uint32_t value
+) {
+    for (uint32_t i = 0; i < TEST_CHANNELS; i++)
+    {
+        test_values[i] = value;
+    }
+}
+
+
+static void test_lists()
+{
+    test_values_set(0);
+
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 5,(@0:2)\n"), 0);
+    TEST_CHECK_EQUAL(test_runs, 3);
+    TEST_CHECK_EQUAL(test_values[0], 5);
+    TEST_CHECK_EQUAL(test_values[1], 5);
+    TEST_CHECK_EQUAL(test_values[2], 5);
+
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 7,(@2,0)\n"), 0);
+    TEST_CHECK_EQUAL(test_values[0], 7);
+    TEST_CHECK_EQUAL(test_values[1], 5);
+    TEST_CHECK_EQUAL(test_values[2], 7);
+
+    // Ranges may count down
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 4,(@2:1)\n"), 0);
+    TEST_CHECK_EQUAL(test_values[1], 4);
+    TEST_CHECK_EQUAL(test_values[2], 4);
+
+    // Query results of all channels in a single response
+    TEST_CHECK_EQUAL(test_input("TEST:VAL? (@0:2)\n"), 0);
+    TEST_CHECK(strcmp(test_output, "7,4,4") == 0);
+
+    TEST_CHECK_EQUAL(test_input("TEST:VAL? (@2:0)\n"), 0);
+    TEST_CHECK(strcmp(test_output, "4,4,7") == 0);
+}
+
+
+static void test_without_list()
+{
+    const uint32_t checkpoints = test_config_checkpoints;
+
+    test_values_set(0);
+
+    // Without a list the handler runs once as usual
+    TEST_CHECK_EQUAL(test_input("TEST:VAL1 9\n"), 0);
+    TEST_CHECK_EQUAL(test_runs, 1);
+    TEST_CHECK_EQUAL(test_values[1], 9);
+
+    TEST_CHECK_EQUAL(test_input("TEST:VAL1?\n"), 0);
+    TEST_CHECK(strcmp(test_output, "9") == 0);
+
+    TEST_CHECK_EQUAL(test_config_checkpoints, checkpoints);
+
+    // Outside of a run there is no list channel
+    uint32_t channel_id = 42;
+
+    TEST_CHECK(!channel_list_id_get(&channel_id));
+    TEST_CHECK_EQUAL(channel_id, 42);
+}
+
+
+static void test_invalid()
+{
+    char message[TEST_INPUT_BUFFER_LENGTH];
+
+    test_values_set(1);
+
+    // The whole list is validated before the first run
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 2,(@0:3)\n"), SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+    TEST_CHECK_EQUAL(test_runs, 0);
+    TEST_CHECK_EQUAL(test_values[0], 1);
+
+    // A header suffix and a channel list do not mix
+    TEST_CHECK_EQUAL(test_input("TEST:VAL1 2,(@0)\n"), SCPI_ERROR_INVALID_SUFFIX);
+    TEST_CHECK_EQUAL(test_runs, 0);
+
+    // At most CHANNEL_LIST_MAX channels
+    strcpy(message, "TEST:VAL 2,(@0");
+
+    for (uint32_t i = 0; i < CHANNEL_LIST_MAX; i++)
+    {
+        strcat(message, ",0");
+    }
+
+    strcat(message, ")\n");
+
+    TEST_CHECK_EQUAL(test_input(message), SCPI_ERROR_TOO_MUCH_DATA);
+    TEST_CHECK_EQUAL(test_runs, 0);
+    TEST_CHECK_EQUAL(test_values[0], 1);
+}
+
+
+static void test_rollback()
+{
+    const uint32_t checkpoints = test_config_checkpoints;
+    const uint32_t rollbacks = test_config_rollbacks;
+
+    // The first failing run stops the list and drops the staged changes
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 200,(@0:2)\n"), SCPI_ERROR_DATA_OUT_OF_RANGE);
+    TEST_CHECK_EQUAL(test_runs, 1);
+    TEST_CHECK_EQUAL(test_config_checkpoints, checkpoints + 1);
+    TEST_CHECK_EQUAL(test_config_rollbacks, rollbacks + 1);
+
+    // A good list after it runs again
+    TEST_CHECK_EQUAL(test_input("TEST:VAL 3,(@0:2)\n"), 0);
+    TEST_CHECK_EQUAL(test_runs, 3);
+    TEST_CHECK_EQUAL(test_config_rollbacks, rollbacks + 1);
+
+    uint32_t channel_id = 42;
+
+    TEST_CHECK(!channel_list_id_get(&channel_id));
+}
+
+
+int main()
+{
+    SCPI_Init(
+        &test_context,
+        test_commands,
+        &test_interface,
+        scpi_units_def,
+        "OpenPIV", "OpenSync", "test", "0",
+        test_input_buffer, TEST_INPUT_BUFFER_LENGTH,
+        test_error_queue_data, TEST_ERROR_QUEUE_SIZE
+    );
+
+    test_lists();
+    test_without_list();
+    test_invalid();
+    test_rollback();
+
+    return test_result();
+}
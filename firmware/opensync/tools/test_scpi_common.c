@@ -0,0 +1,184 @@
+// Host tests of the conversions between picoseconds and state machine cycles
+// at 16.8 fixed point clock dividers, for every clock profile.
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "overclock/overclock.h"
+#include "sequencer/sequencer_common.h"
+#include "serial/scpi_common.h"
+#include "test_common.h"
+#include "test_stubs.h"
+
+
+static const struct overclock_profile TEST_PROFILES[] = {
+    {200, 0, 5, 1},
+    {250, 0, 4, 1},
+    {300, 0, 10, 3},
+};
+
+static const uint32_t TEST_DIVIDERS[][2] = {
+    {1, 0},
+    {1, 128},
+    {3, 85},
+    {250, 0},
+    {4096, 1},
+    {65535, 255},
+};
+
+static const uint64_t TEST_PICOS[] = {
+    0,
+    1,
+    1666,
+    1667,
+    3333,
+    10000,
+    999999999999ull,
+    123456789012345ull,
+    1ull << 50,
+    (1ull << 62) - 1,
+    1ull << 62,
+};
+
+
+// Nearest cycles with a 128 bit product, halves round up
+static uint64_t test_cycles_reference(
+    uint64_t picoseconds,
+    uint64_t cycle_nanos_fixed
+) {
+    const unsigned __int128 cycle_picos = (unsigned __int128) cycle_nanos_fixed * PICOS_PER_NANOSECOND;
+    const unsigned __int128 scaled = (unsigned __int128) picoseconds * clock_cycle_fixed_scale_get();
+
+    return (uint64_t) ((scaled + cycle_picos / 2) / cycle_picos);
+}
+
+
+// Nearest picoseconds with a 128 bit product, halves round up
+static uint64_t test_picos_reference(
+    uint64_t cycles,
+    uint64_t cycle_nanos_fixed
+) {
+    const unsigned __int128 scale = clock_cycle_fixed_scale_get();
+    const unsigned __int128 scaled = (unsigned __int128) cycles * cycle_nanos_fixed * PICOS_PER_NANOSECOND;
+
+    return (uint64_t) ((scaled + scale / 2) / scale);
+}
+
+
+static void test_profile_set(
+    uint32_t mhz
+) {
+    for (uint32_t i = 0; i < sizeof(TEST_PROFILES) / sizeof(TEST_PROFILES[0]); i++)
+    {
+        if (TEST_PROFILES[i].mhz == mhz)
+        {
+            test_overclock_profile = TEST_PROFILES[i];
+        }
+    }
+}
+
+
+static void test_fixed_point()
+{
+    test_profile_set(250);
+
+    TEST_CHECK_EQUAL(CLOCK_DIVIDER_FRAC_BITS, 8);
+    TEST_CHECK_EQUAL(clock_cycle_fixed_scale_get(), 256);
+    TEST_CHECK_EQUAL(clock_cycle_nanos_fixed_get(1, 0), 1024);
+    TEST_CHECK_EQUAL(clock_cycle_nanos_fixed_get(1, 128), 1536);
+
+    test_profile_set(300);
+
+    TEST_CHECK_EQUAL(clock_cycle_fixed_scale_get(), 768);
+    TEST_CHECK_EQUAL(clock_cycle_nanos_fixed_get(1, 0), 2560);
+}
+
+
+static void test_rounding()
+{
+    test_profile_set(250);
+
+    // 4 ns cycles, halves round up
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(4000, clock_cycle_nanos_fixed_get(1, 0)), 1);
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(5999, clock_cycle_nanos_fixed_get(1, 0)), 1);
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(6000, clock_cycle_nanos_fixed_get(1, 0)), 2);
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(1999, clock_cycle_nanos_fixed_get(1, 0)), 0);
+
+    // 6 ns cycles at a divider of 1.5
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(12000, clock_cycle_nanos_fixed_get(1, 128)), 2);
+    TEST_CHECK_EQUAL(clock_cycles_picos_get(2, clock_cycle_nanos_fixed_get(1, 128)), 12000);
+
+    test_profile_set(300);
+
+    // 10/3 ns cycles
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(10000, clock_cycle_nanos_fixed_get(1, 0)), 3);
+    TEST_CHECK_EQUAL(clock_cycles_nearest_get(1000000000000ull, clock_cycle_nanos_fixed_get(1, 0)), 300000000);
+    TEST_CHECK_EQUAL(clock_cycles_picos_get(3, clock_cycle_nanos_fixed_get(1, 0)), 10000);
+    TEST_CHECK_EQUAL(clock_cycles_picos_get(1, clock_cycle_nanos_fixed_get(1, 0)), 3333);
+    TEST_CHECK_EQUAL(clock_cycles_picos_get(2, clock_cycle_nanos_fixed_get(1, 0)), 6667);
+
+    TEST_CHECK_EQUAL(clock_cycles_error_picos_get(3334, 1, clock_cycle_nanos_fixed_get(1, 0)), 1);
+    TEST_CHECK_EQUAL(clock_cycles_error_picos_get(3332, 1, clock_cycle_nanos_fixed_get(1, 0)), -1);
+}
+
+
+// The split division has to match the exact result over the whole range
+static void test_range()
+{
+    for (uint32_t p = 0; p < sizeof(TEST_PROFILES) / sizeof(TEST_PROFILES[0]); p++)
+    {
+        test_overclock_profile = TEST_PROFILES[p];
+
+        for (uint32_t d = 0; d < sizeof(TEST_DIVIDERS) / sizeof(TEST_DIVIDERS[0]); d++)
+        {
+            const uint64_t cycle_nanos_fixed = clock_cycle_nanos_fixed_get(
+                TEST_DIVIDERS[d][0],
+                TEST_DIVIDERS[d][1]
+            );
+
+            for (uint32_t i = 0; i < sizeof(TEST_PICOS) / sizeof(TEST_PICOS[0]); i++)
+            {
+                const uint64_t cycles = clock_cycles_nearest_get(TEST_PICOS[i], cycle_nanos_fixed);
+
+                TEST_CHECK_EQUAL(cycles, test_cycles_reference(TEST_PICOS[i], cycle_nanos_fixed));
+                TEST_CHECK_EQUAL(
+                    clock_cycles_picos_get(cycles, cycle_nanos_fixed),
+                    test_picos_reference(cycles, cycle_nanos_fixed)
+                );
+            }
+        }
+    }
+}
+
+
+static void test_limits()
+{
+    uint32_t cycles = 0;
+    uint64_t cycles_extended = 0;
+
+    test_profile_set(250);
+
+    TEST_CHECK(!convert_picos_to_cycles(4000, 0, 0, &cycles));
+    TEST_CHECK(!convert_picos_to_cycles_extended(4000, 0, 0, &cycles_extended));
+
+    TEST_CHECK(convert_picos_to_cycles(CLOCK_CYCLES_MAX * 4000, 1, 0, &cycles));
+    TEST_CHECK_EQUAL(cycles, CLOCK_CYCLES_MAX);
+    TEST_CHECK(!convert_picos_to_cycles((CLOCK_CYCLES_MAX + 1) * 4000, 1, 0, &cycles));
+
+    TEST_CHECK(convert_picos_to_cycles_extended((CLOCK_CYCLES_MAX + 1) * 4000, 1, 0, &cycles_extended));
+    TEST_CHECK_EQUAL(cycles_extended, CLOCK_CYCLES_MAX + 1);
+
+    // Every delay up to PICOS_MAX is within the extended limit
+    TEST_CHECK(convert_picos_to_cycles_extended(PICOS_MAX, 1, 0, &cycles_extended));
+    TEST_CHECK_EQUAL(cycles_extended, (PICOS_MAX + 2000) / 4000);
+}
+
+
+int main()
+{
+    test_fixed_point();
+    test_rounding();
+    test_range();
+    test_limits();
+
+    return test_result();
+}
@@ -0,0 +1,297 @@
+// Host tests of the numeric program data parser: mantissa and exponent,
+// unit suffixes and the integer conversions to picoseconds, cycles and
+// fixed point values.
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "serial/scpi_common.h"
+#include "serial/scpi_numeric.h"
+#include "test_common.h"
+
+
+static struct numeric_value test_parse(
+    const char* text
+) {
+    struct numeric_value value;
+
+    TEST_CHECK(numeric_value_parse(text, strlen(text), &value));
+
+    return value;
+}
+
+
+static bool test_picos_get(
+    const char* text,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+) {
+    struct numeric_value value;
+
+    return numeric_value_parse(text, strlen(text), &value) &&
+        numeric_value_picos_get(&value, unit_offset, picoseconds);
+}
+
+
+static bool test_period_get(
+    const char* text,
+    uint64_t unit_offset,
+    uint64_t* picoseconds
+) {
+    struct numeric_value value;
+
+    return numeric_value_parse(text, strlen(text), &value) &&
+        numeric_value_period_picos_get(&value, unit_offset, picoseconds);
+}
+
+
+static bool test_cycles_get(
+    const char* text,
+    uint64_t max,
+    uint64_t* cycles
+) {
+    struct numeric_value value;
+
+    return numeric_value_parse(text, strlen(text), &value) &&
+        numeric_value_cycles_get(&value, max, cycles);
+}
+
+
+static bool test_fixed_get(
+    const char* text,
+    uint64_t max,
+    uint64_t* fixed
+) {
+    struct numeric_value value;
+
+    return numeric_value_parse(text, strlen(text), &value) &&
+        numeric_value_fixed_get(&value, 8, max, fixed);
+}
+
+
+static void test_mantissa()
+{
+    struct numeric_value value;
+
+    value = test_parse("250");
+    TEST_CHECK_EQUAL(value.mantissa, 250);
+    TEST_CHECK_EQUAL(value.exponent, 0);
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_NONE);
+
+    value = test_parse(" +0.0125 ");
+    TEST_CHECK_EQUAL(value.mantissa, 125);
+    TEST_CHECK_EQUAL(value.exponent, -4);
+
+    value = test_parse("1.2e3");
+    TEST_CHECK_EQUAL(value.mantissa, 12);
+    TEST_CHECK_EQUAL(value.exponent, 2);
+
+    value = test_parse("5E-2");
+    TEST_CHECK_EQUAL(value.mantissa, 5);
+    TEST_CHECK_EQUAL(value.exponent, -2);
+
+    value = test_parse("0.000");
+    TEST_CHECK_EQUAL(value.mantissa, 0);
+
+    // Digits past the precision limit only move the exponent
+    value = test_parse("12345678901234567890");
+    TEST_CHECK_EQUAL(value.mantissa, 123456789012345678ull);
+    TEST_CHECK_EQUAL(value.exponent, 2);
+
+    TEST_CHECK(!numeric_value_parse("", 0, &value));
+    TEST_CHECK(!numeric_value_parse(".", 1, &value));
+    TEST_CHECK(!numeric_value_parse("-5", 2, &value));
+    TEST_CHECK(!numeric_value_parse("1 2", 3, &value));
+    TEST_CHECK(!numeric_value_parse("1.2.3", 5, &value));
+}
+
+
+static void test_suffixes()
+{
+    struct numeric_value value;
+
+    value = test_parse("12.5us");
+    TEST_CHECK_EQUAL(value.mantissa, 125);
+    TEST_CHECK_EQUAL(value.exponent, -1);
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_TIME);
+    TEST_CHECK_EQUAL(value.suffix_exponent, 6);
+
+    value = test_parse("1.2e3 kHz");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_FREQUENCY);
+    TEST_CHECK_EQUAL(value.suffix_exponent, 3);
+
+    value = test_parse("2MIN");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_TIME);
+    TEST_CHECK_EQUAL(value.suffix_exponent, 13);
+    TEST_CHECK_EQUAL(value.suffix_multiplier, 6);
+
+    value = test_parse("1hr");
+    TEST_CHECK_EQUAL(value.suffix_exponent, 14);
+    TEST_CHECK_EQUAL(value.suffix_multiplier, 36);
+
+    value = test_parse("7cyc");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_CYCLES);
+
+    // MHZ is megahertz in any case, only the spelling mHz is millihertz
+    value = test_parse("5MHZ");
+    TEST_CHECK_EQUAL(value.suffix_exponent, 6);
+
+    value = test_parse("5mhz");
+    TEST_CHECK_EQUAL(value.suffix_exponent, 6);
+
+    value = test_parse("5mHz");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_FREQUENCY);
+    TEST_CHECK_EQUAL(value.suffix_exponent, -3);
+
+    // An e without digits is a suffix, not an exponent
+    value = test_parse("1e");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_UNKNOWN);
+
+    value = test_parse("3 furlongs");
+    TEST_CHECK_EQUAL(value.suffix, NUMERIC_SUFFIX_UNKNOWN);
+}
+
+
+static void test_picos()
+{
+    uint64_t picoseconds = 0;
+
+    TEST_CHECK(test_picos_get("10ns", OFFSET_MICROSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 10000);
+
+    // Values without a suffix are in units of the channel
+    TEST_CHECK(test_picos_get("1.5", OFFSET_MICROSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 1500000);
+
+    TEST_CHECK(test_picos_get("2", OFFSET_MINUTE, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 120000000000000ull);
+
+    TEST_CHECK(test_picos_get("1h", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 3600000000000000ull);
+
+    TEST_CHECK(test_picos_get("0.5min", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 30000000000000ull);
+
+    // Rounded to the nearest picosecond, halves up
+    TEST_CHECK(test_picos_get("0.0004ns", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 0);
+
+    TEST_CHECK(test_picos_get("0.0005ns", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 1);
+
+    TEST_CHECK(test_picos_get("3.3333333333333333333ns", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 3333);
+
+    TEST_CHECK(test_picos_get("1e-30s", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 0);
+
+    TEST_CHECK(test_picos_get("0e300s", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 0);
+
+    // Up to PICOS_MAX, about 4.61e18 ps
+    TEST_CHECK(test_picos_get("4.6e6s", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 4600000000000000000ull);
+
+    TEST_CHECK(!test_picos_get("4.7e6s", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK(!test_picos_get("1e30s", OFFSET_NANOSECOND, &picoseconds));
+
+    // Only times convert
+    TEST_CHECK(!test_picos_get("1kHz", OFFSET_NANOSECOND, &picoseconds));
+    TEST_CHECK(!test_picos_get("1cyc", OFFSET_NANOSECOND, &picoseconds));
+}
+
+
+static void test_periods()
+{
+    uint64_t picoseconds = 0;
+
+    TEST_CHECK(test_period_get("1MHz", 1, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 1000000);
+
+    TEST_CHECK(test_period_get("3Hz", 1, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 333333333333ull);
+
+    TEST_CHECK(test_period_get("1.5mHz", 1, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 666666666666667ull);
+
+    // Values without a suffix are in units of the channel
+    TEST_CHECK(test_period_get("2", 1000, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 500000000);
+
+    // A time is taken as the period itself
+    TEST_CHECK(test_period_get("4ns", 1, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 4000);
+
+    TEST_CHECK(test_period_get("0", 1, &picoseconds));
+    TEST_CHECK_EQUAL(picoseconds, 0);
+
+    // A period below half a picosecond is out of range
+    TEST_CHECK(!test_period_get("3e12Hz", 1, &picoseconds));
+    TEST_CHECK(!test_period_get("1e13", 1, &picoseconds));
+    TEST_CHECK(!test_period_get("1cyc", 1, &picoseconds));
+}
+
+
+static void test_cycles()
+{
+    uint64_t cycles = 0;
+
+    TEST_CHECK(test_cycles_get("12cyc", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK_EQUAL(cycles, 12);
+
+    TEST_CHECK(test_cycles_get("12.000CYC", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK_EQUAL(cycles, 12);
+
+    TEST_CHECK(test_cycles_get("1.2e1cyc", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK_EQUAL(cycles, 12);
+
+    TEST_CHECK(test_cycles_get("0cyc", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK_EQUAL(cycles, 0);
+
+    TEST_CHECK(test_cycles_get("100cyc", 100, &cycles));
+    TEST_CHECK_EQUAL(cycles, 100);
+
+    TEST_CHECK(!test_cycles_get("101cyc", 100, &cycles));
+    TEST_CHECK(!test_cycles_get("12.5cyc", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK(!test_cycles_get("12", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+    TEST_CHECK(!test_cycles_get("12ns", CLOCK_CYCLES_EXTENDED_MAX, &cycles));
+}
+
+
+static void test_fixed()
+{
+    const uint64_t max = (1ull << 24) - 1;
+    uint64_t fixed = 0;
+
+    TEST_CHECK(test_fixed_get("1.5", max, &fixed));
+    TEST_CHECK_EQUAL(fixed, 384);
+
+    TEST_CHECK(test_fixed_get("1.1", max, &fixed));
+    TEST_CHECK_EQUAL(fixed, 282); // 281.6
+
+    // Half a step rounds up
+    TEST_CHECK(test_fixed_get("0.001953125", max, &fixed));
+    TEST_CHECK_EQUAL(fixed, 1);
+
+    TEST_CHECK(test_fixed_get("0.0019", max, &fixed));
+    TEST_CHECK_EQUAL(fixed, 0);
+
+    TEST_CHECK(test_fixed_get("65535.99609375", max, &fixed));
+    TEST_CHECK_EQUAL(fixed, max);
+
+    TEST_CHECK(!test_fixed_get("65536", max, &fixed));
+    TEST_CHECK(!test_fixed_get("1us", max, &fixed));
+}
+
+
+int main()
+{
+    test_mantissa();
+    test_suffixes();
+    test_picos();
+    test_periods();
+    test_cycles();
+    test_fixed();
+
+    return test_result();
+}
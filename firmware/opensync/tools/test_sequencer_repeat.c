@@ -0,0 +1,182 @@
+// Host tests of the repeat block detection of pulse sequences and the word
+// count of the repeat layout.
+#include <stdint.h>
+
+#include "structs/pulse_config.h"
+#include "sequencer/sequencer_repeat.h"
+#include "test_common.h"
+
+
+static uint32_t test_outputs[PULSE_PACKED_STATES_MAX];
+static uint64_t test_cycles[PULSE_PACKED_STATES_MAX];
+
+
+static void test_sequence_set(
+    const uint32_t* outputs,
+    const uint64_t* cycles,
+    uint32_t states
+) {
+    for (uint32_t i = 0; i < states; i++)
+    {
+        test_outputs[i] = outputs[i];
+        test_cycles[i] = cycles[i];
+    }
+}
+
+
+static void test_words()
+{
+    // Linear segment of prefix and terminator, rounded up to a power of two
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(0, 0, 1), 2);
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(5, 0, 1), 8);
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(7, 0, 1), 8);
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(8, 0, 1), 16);
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(1, 2, 2), 8);
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_words_get(3, 4, 2), 16);
+}
+
+
+static void test_alternating()
+{
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        test_outputs[i] = i % 2;
+        test_cycles[i] = 10;
+    }
+
+    // The linear segment keeps one block, the other seven repeat
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        16,
+        1,
+        pulse_sequence_repeat_words_get(16, 0, 1),
+        &repeat_states,
+        &repeat_count
+    ), 6);
+
+    TEST_CHECK_EQUAL(repeat_states, 2);
+    TEST_CHECK_EQUAL(repeat_count, 7);
+}
+
+
+static void test_prefix()
+{
+    const uint32_t outputs[] = {5, 6, 7, 1, 2, 1, 2, 1, 2};
+    const uint64_t cycles[] = {10, 20, 30, 10, 10, 10, 10, 10, 10};
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+
+    test_sequence_set(outputs, cycles, 9);
+
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        9,
+        1,
+        pulse_sequence_repeat_words_get(9, 0, 1),
+        &repeat_states,
+        &repeat_count
+    ), 6);
+
+    TEST_CHECK_EQUAL(repeat_states, 2);
+    TEST_CHECK_EQUAL(repeat_count, 3);
+}
+
+
+static void test_no_repeat()
+{
+    const uint32_t outputs[] = {1, 1, 1, 1};
+    const uint64_t cycles[] = {10, 10, 10, 20};
+    const uint64_t cycles_equal[] = {10, 10, 10, 10};
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+
+    // Same outputs, but the last delay differs
+    test_sequence_set(outputs, cycles, 4);
+
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        4,
+        2,
+        PULSE_INSTRUCTIONS_MAX,
+        &repeat_states,
+        &repeat_count
+    ), 0);
+
+    TEST_CHECK_EQUAL(repeat_states, 0);
+    TEST_CHECK_EQUAL(repeat_count, 0);
+
+    // A repeat block has to save words over the plain layout
+    test_sequence_set(outputs, cycles_equal, 4);
+
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        4,
+        2,
+        PULSE_INSTRUCTIONS_MAX,
+        &repeat_states,
+        &repeat_count
+    ), 6);
+
+    TEST_CHECK_EQUAL(repeat_states, 1);
+    TEST_CHECK_EQUAL(repeat_count, 3);
+
+    repeat_states = 0;
+    repeat_count = 0;
+
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        4,
+        2,
+        6,
+        &repeat_states,
+        &repeat_count
+    ), 0);
+
+    TEST_CHECK_EQUAL(repeat_states, 0);
+}
+
+
+static void test_too_large()
+{
+    uint32_t repeat_states = 0;
+    uint32_t repeat_count = 0;
+
+    // 20 distinct states in front of the repeat need a 64 word linear segment
+    for (uint32_t i = 0; i < 24; i++)
+    {
+        test_outputs[i] = (i < 20) ? 10 + i : 1;
+        test_cycles[i] = 10;
+    }
+
+    TEST_CHECK_EQUAL(pulse_sequence_repeat_detect(
+        test_outputs,
+        test_cycles,
+        24,
+        2,
+        PULSE_INSTRUCTIONS_MAX + 1,
+        &repeat_states,
+        &repeat_count
+    ), 0);
+
+    TEST_CHECK_EQUAL(repeat_states, 0);
+}
+
+
+int main()
+{
+    test_words();
+    test_alternating();
+    test_prefix();
+    test_no_repeat();
+    test_too_large();
+
+    return test_result();
+}
@@ -0,0 +1,135 @@
+// Stand-ins for the firmware parts that need the Pico SDK, so the host unit
+// tests link the sources under test without the hardware side.
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "overclock/overclock.h"
+#include "status/sequencer_status.h"
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+#include "sequencer/sequencer_clock.h"
+#include "sequencer/sequencer_common.h"
+#include "system/core_1.h"
+#include "test_stubs.h"
+
+
+// 250 MHz unless a test picks another profile
+struct overclock_profile test_overclock_profile = {
+    .mhz = 250,
+    .vreg_voltage = 0,
+    .cycle_nanos_num = 4,
+    .cycle_nanos_den = 1,
+};
+
+// Calls of the staged config checkpoint and rollback
+uint32_t test_config_checkpoints = 0;
+uint32_t test_config_rollbacks = 0;
+
+// Staged configs, the host has no second core so they are published as well
+struct clock_config test_clock_configs[CLOCKS_MAX];
+struct pulse_config test_pulse_configs[PULSES_MAX];
+
+const uint32_t IDLE = 0;
+const uint32_t ABORTED = 5;
+
+
+const struct overclock_profile* overclock_profile_get()
+{
+    return &test_overclock_profile;
+}
+
+
+uint32_t sequencer_status_get(void)
+{
+    return IDLE;
+}
+
+
+void sequencer_config_checkpoint()
+{
+    test_config_checkpoints++;
+}
+
+
+void sequencer_config_rollback()
+{
+    test_config_rollbacks++;
+}
+
+
+struct clock_config* sequencer_clock_config_get()
+{
+    return test_clock_configs;
+}
+
+
+struct pulse_config* sequencer_pulse_config_get()
+{
+    return test_pulse_configs;
+}
+
+
+const struct clock_config* sequencer_clock_config_published_get()
+{
+    return test_clock_configs;
+}
+
+
+const struct pulse_config* sequencer_pulse_config_published_get()
+{
+    return test_pulse_configs;
+}
+
+
+// The setter limits are tested on the target, the host accepts every mode
+bool validate_clock_mode(
+    uint32_t clock_mode
+) {
+    return true;
+}
+
+
+bool validate_trigger_mode(
+    uint32_t trigger_mode
+) {
+    return true;
+}
+
+
+bool validate_trigger_edge(
+    uint32_t trigger_edge
+) {
+    return true;
+}
+
+
+bool validate_trigger_level(
+    uint32_t trigger_level
+) {
+    return true;
+}
+
+
+bool validate_trigger_logic(
+    uint32_t trigger_logic
+) {
+    return true;
+}
+
+
+bool clock_divider_fixed_validate(
+    uint32_t clock_divider_fixed
+) {
+    return clock_divider_fixed >= (1u << CLOCK_DIVIDER_FRAC_BITS);
+}
+
+
+// One mask word for up to 32 bits
+bool sequencer_clock_trigger_mask_words_get(
+    uint32_t length,
+    uint32_t* words
+) {
+    *words = 1;
+
+    return length <= 32;
+}
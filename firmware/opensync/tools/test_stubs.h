@@ -0,0 +1,15 @@
+#pragma once
+
+// Hardware side of the firmware for the host unit tests, see test_stubs.c
+#include <stdint.h>
+
+#include "overclock/overclock.h"
+#include "structs/clock_config.h"
+#include "structs/pulse_config.h"
+
+
+extern struct overclock_profile test_overclock_profile;
+extern uint32_t test_config_checkpoints;
+extern uint32_t test_config_rollbacks;
+extern struct clock_config test_clock_configs[CLOCKS_MAX];
+extern struct pulse_config test_pulse_configs[PULSES_MAX];